@@ -0,0 +1,242 @@
+/*
+ * Audioreactive FFT pipeline benchmark for the host-native build (pio run -e native_audio && .pio/build/native_audio/program)
+ *
+ * Feeds test signals from SignalGeneratorSource (or .wav files through WavFileSource) batch by batch into the
+ * FFT pipeline of the audioreactive usermod (audio_fft.h) and reports the time per batch and per second of audio. The GEQ bands of
+ * every batch can be recorded as golden files and compared against them, so a change of the pipeline
+ * (filtering, FFT, channel mapping, post-processing) shows up as a changed GEQ output.
+ * Every signal is run twice, without and with the band-pass filter ("+bp"). Default settings of the usermod
+ * (square root scaling, limiter on, no AGC, gain 60) are used and the noise gate is held open.
+ * The onset detector / beat tracker runs on every batch as well: the number of onsets and the tempo found at the end
+ * are reported (the beats signal should give 2 onsets per beat - kick and hi-hat - and its BPM).
+ *
+ * Options:
+ *   -b <batches>  batches per signal (default 400, about 9 seconds of audio without overlap, 4.6 seconds with overlap)
+ *   -F <backend>  FFT backend: float (default), fixed, arduino (only if built with -D UM_AUDIOREACTIVE_USE_ARDUINOFFT)
+ *   -O            no overlap: 512 new samples per batch instead of 256
+ *   -n <bands>    number of GEQ bands (default 16 = hand-tuned layout, 24 or 32: log-spaced)
+ *   -t <bpm>      tempo of the beats signal (default 120)
+ *   -s <signal>   only run one signal: sine, sweep, pink, beats or the name of a .wav file (22050Hz) in $WLED_FS_ROOT
+ *   -r <dir>      record the GEQ output as golden files <dir>/<signal>.csv
+ *   -g <dir>      compare the GEQ output with the golden files in <dir>, exit with code 1 on differences
+ *   -e <diff>     allowed difference per GEQ channel when comparing (default 0)
+ *   -c            CSV output
+ */
+#include <chrono>
+#include <string>
+#include <unistd.h>
+#include "wled.h"
+
+#define DEBUGSR_PRINT(x)
+#define DEBUGSR_PRINTLN(x)
+#define DEBUGSR_PRINTF(x...)
+#include "audio_source.h"
+#include "audio_fft.h"
+
+constexpr SRate_t SAMPLE_RATE = 22050;       // same as the usermod
+constexpr int BLOCK_SIZE = 128;
+
+struct SignalDef {
+  const char *name;
+  SignalGeneratorSource::Signal signal;
+};
+
+static const SignalDef signals[] = {
+  { "sine",  SignalGeneratorSource::Sine },
+  { "sweep", SignalGeneratorSource::Sweep },
+  { "pink",  SignalGeneratorSource::PinkNoise },
+  { "beats", SignalGeneratorSource::Beats },
+};
+
+enum class Backend { Float, Fixed, Arduino };
+
+struct Result {
+  uint64_t totalNs = 0;
+  uint64_t worstNs = 0;
+  unsigned batches = 0;
+  unsigned samples = 0;       // new samples processed
+  unsigned mismatches = -1U;  // batches that differ from the golden file, -1: not compared
+  unsigned maxDiff = 0;
+  unsigned onsets = 0;
+  float bpm = 0.0f;           // tempo at the end of the signal
+};
+
+static float vReal[samplesFFT];
+static float vImag[samplesFFT];
+
+// runs one signal through the pipeline, optionally recording to / comparing with golden file
+// (wav: source if it is a file, to stop at the end of the file)
+template<class FFTBackend>
+static bool runSignalFFT(FFTBackend &FFT, bool overlap, uint8_t bands, AudioSource *source, WavFileSource *wav, const char *name, bool bandPass, unsigned batches, const char *recordDir, const char *goldenDir, unsigned tolerance, Result &res) {
+  FFTState state;
+  BeatState beat;
+  FFTSettings settings;
+  settings.sampleAvg = 128.0f;           // noise gate open
+  settings.bandPassFilter = bandPass;
+  settings.overlap = overlap;
+  settings.geqBands = bands;
+
+  std::string fileName = std::string(name) + (bandPass ? "+bp" : "") + ".csv";
+  FILE *rec = nullptr, *gold = nullptr;
+  if (recordDir) {
+    rec = fopen((std::string(recordDir) + "/" + fileName).c_str(), "w");
+    if (!rec) { fprintf(stderr, "cannot write %s/%s\n", recordDir, fileName.c_str()); return false; }
+  }
+  if (goldenDir) {
+    gold = fopen((std::string(goldenDir) + "/" + fileName).c_str(), "r");
+    if (!gold) { fprintf(stderr, "no golden file %s/%s\n", goldenDir, fileName.c_str()); return false; }
+    res.mismatches = 0;
+  }
+
+  source->initialize();
+  if (!source->isInitialized()) { fprintf(stderr, "cannot open %s\n", name); return false; }
+  for (unsigned b = 0; b < batches; b++) {
+    source->getSamples(fftNewSamples(state, settings), fftBatchSamples(settings));
+    if (wav && wav->endOfFile()) break;
+
+    FFTResults results;
+    BeatResults beats;
+    const auto t0 = std::chrono::steady_clock::now();
+    preProcessFFTSamples(state, settings, vReal);
+    processFFTBatch(FFT, vReal, state, settings, results);
+    detectBeats(beat, settings, vReal, results.haveFFT, beats);
+    const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    res.totalNs += ns;
+    if (ns > res.worstNs) res.worstNs = ns;
+    res.batches++;
+    res.samples += fftBatchSamples(settings);
+    if (beats.onset) res.onsets++;
+    res.bpm = beats.bpm;
+
+    if (rec) {
+      fprintf(rec, "%u", b);
+      for (int i = 0; i < results.numBands; i++) fprintf(rec, ",%u", results.geqResult[i]);
+      fprintf(rec, "\n");
+    }
+    if (gold) {
+      unsigned batch, golden[MAX_GEQ_BANDS];
+      bool ok = fscanf(gold, "%u", &batch) == 1 && batch == b;
+      for (int i = 0; ok && i < results.numBands; i++) ok = fscanf(gold, ",%u", &golden[i]) == 1;
+      if (!ok) { res.mismatches += res.batches - b; break; } // golden file too short
+      bool same = true;
+      for (int i = 0; i < results.numBands; i++) {
+        unsigned diff = abs(int(golden[i]) - int(results.geqResult[i]));
+        if (diff > res.maxDiff) res.maxDiff = diff;
+        if (diff > tolerance) same = false;
+      }
+      if (!same) res.mismatches++;
+    }
+  }
+  source->deinitialize();
+  if (rec) fclose(rec);
+  if (gold) fclose(gold);
+  return true;
+}
+
+static bool runSignal(Backend backend, bool overlap, uint8_t bands, AudioSource *source, WavFileSource *wav, const char *name, bool bandPass, unsigned batches, const char *recordDir, const char *goldenDir, unsigned tolerance, Result &res) {
+  switch (backend) {
+#ifdef UM_AUDIOREACTIVE_USE_ARDUINOFFT
+    case Backend::Arduino: {
+      ArduinoFFTBackend FFT(vReal, vImag, SAMPLE_RATE);
+      return runSignalFFT(FFT, overlap, bands, source, wav, name, bandPass, batches, recordDir, goldenDir, tolerance, res);
+    }
+#endif
+    case Backend::Fixed: {
+      Radix4FFTBackend<int32_t> FFT(vReal, vImag, SAMPLE_RATE);
+      return runSignalFFT(FFT, overlap, bands, source, wav, name, bandPass, batches, recordDir, goldenDir, tolerance, res);
+    }
+    default: {
+      Radix4FFTBackend<float> FFT(vReal, vImag, SAMPLE_RATE);
+      return runSignalFFT(FFT, overlap, bands, source, wav, name, bandPass, batches, recordDir, goldenDir, tolerance, res);
+    }
+  }
+}
+
+static void printResult(const char *name, bool bandPass, const Result &res, bool csv) {
+  char fullName[64];
+  snprintf(fullName, sizeof(fullName), "%s%s", name, bandPass ? "+bp" : "");
+  const double avg = res.batches ? res.totalNs / 1000.0 / res.batches : 0.0;
+  const double perSecond = res.samples ? res.totalNs / 1000.0 * SAMPLE_RATE / res.samples : 0.0; // CPU time per second of audio
+  if (csv) {
+    printf("%s,%u,%.2f,%.2f,%.0f,%u,%.1f", fullName, res.batches, avg, res.worstNs / 1000.0, perSecond, res.onsets, res.bpm);
+    if (res.mismatches != -1U) printf(",%u,%u", res.mismatches, res.maxDiff);
+    printf("\n");
+  } else {
+    printf("%-24s %7u %9.2f %9.2f %9.0f %7u %6.1f", fullName, res.batches, avg, res.worstNs / 1000.0, perSecond, res.onsets, res.bpm);
+    if (res.mismatches != -1U) printf("  %s (%u batches differ, max diff %u)", res.mismatches ? "FAIL" : "ok", res.mismatches, res.maxDiff);
+    printf("\n");
+  }
+}
+
+int main(int argc, char **argv) {
+  unsigned batches = 400;
+  const char *signalFilter = nullptr;
+  const char *recordDir = nullptr;
+  const char *goldenDir = nullptr;
+  unsigned tolerance = 0;
+  bool csv = false;
+  Backend backend = Backend::Float;
+  bool overlap = true;
+  uint8_t bands = NUM_GEQ_CHANNELS;
+  float bpm = 120.0f;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "b:s:r:g:e:cF:On:t:")) != -1) {
+    switch (opt) {
+      case 'b': batches = max(1, atoi(optarg)); break;
+      case 's': signalFilter = optarg; break;
+      case 'r': recordDir = optarg; break;
+      case 'g': goldenDir = optarg; break;
+      case 'e': tolerance = max(0, atoi(optarg)); break;
+      case 'c': csv = true; break;
+      case 'O': overlap = false; break;
+      case 'n': bands = constrain(atoi(optarg), 8, MAX_GEQ_BANDS); break;
+      case 't': bpm = constrain(atof(optarg), 20.0, 400.0); break;
+      case 'F':
+        if (!strcmp(optarg, "float")) backend = Backend::Float;
+        else if (!strcmp(optarg, "fixed")) backend = Backend::Fixed;
+#ifdef UM_AUDIOREACTIVE_USE_ARDUINOFFT
+        else if (!strcmp(optarg, "arduino")) backend = Backend::Arduino;
+#endif
+        else { fprintf(stderr, "unknown FFT backend %s\n", optarg); return 2; }
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-b batches] [-s signal|file.wav] [-F float|fixed|arduino] [-O] [-n bands] [-t bpm] [-r dir] [-g dir] [-e diff] [-c]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  if (csv) printf("signal,batches,us_avg,us_max,us_per_s,onsets,bpm%s\n", goldenDir ? ",mismatches,max_diff" : "");
+  else     printf("%-24s %7s %9s %9s %9s %7s %6s\n", "signal", "batches", "us/batch", "us max", "us/s", "onsets", "bpm");
+
+  bool failed = false;
+  if (signalFilter && strstr(signalFilter, ".wav")) {
+    std::string name(signalFilter);
+    name = name.substr(name.find_last_of('/') + 1);
+    name = name.substr(0, name.size() - 4);
+    WavFileSource wav(SAMPLE_RATE, BLOCK_SIZE, signalFilter);
+    for (bool bandPass : {false, true}) {
+      Result res;
+      if (!runSignal(backend, overlap, bands, &wav, &wav, name.c_str(), bandPass, batches, recordDir, goldenDir, tolerance, res)) return 2;
+      printResult(name.c_str(), bandPass, res, csv);
+      if (res.mismatches && res.mismatches != -1U) failed = true;
+    }
+    return failed ? 1 : 0;
+  }
+
+  bool found = false;
+  for (const SignalDef &s : signals) {
+    if (signalFilter && strcmp(signalFilter, s.name)) continue;
+    found = true;
+    SignalGeneratorSource generator(SAMPLE_RATE, BLOCK_SIZE, s.signal);
+    generator.setBPM(bpm);
+    for (bool bandPass : {false, true}) {
+      Result res;
+      if (!runSignal(backend, overlap, bands, &generator, nullptr, s.name, bandPass, batches, recordDir, goldenDir, tolerance, res)) return 2;
+      printResult(s.name, bandPass, res, csv);
+      if (res.mismatches && res.mismatches != -1U) failed = true;
+    }
+  }
+  if (!found) { fprintf(stderr, "unknown signal %s\n", signalFilter); return 2; }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,269 @@
+/*
+ * FX frame-time benchmark for the host-native build (pio run -e native && .pio/build/native/program)
+ *
+ * Runs every registered effect through WS2812FX::service() on a set of standard 1D strip lengths
+ * and 2D matrix sizes and reports the average/worst time per frame and the heap the effect needs.
+ * Times are host times: use them to compare effects (or two revisions of one effect), not as
+ * absolute ESP32 numbers.
+ *
+ * Options:
+ *   -f <frames>   frames per effect and layout (default 200)
+ *   -m <name>     only run effects whose name contains <name>
+ *   -l <layout>   only run one layout, e.g. 300 or 32x32
+ *   -c            CSV output
+ *   -x <us>       exit with code 1 if any effect exceeds <us> per frame on average
+ *   -t <changes>  instead of the effects: change the effect of 16 segments <changes> times with a transition
+ *                 (like a playlist) and report the heap allocations this causes
+ *   -M <m12>      run the 1D effects on the matrices using 1D to 2D mapping <m12> (1 bar, 2 arc, 3 corner, 4 pinwheel)
+ *   -p            instead of the effects: frame time of "PS Box" (particles piling up under gravity, collisions
+ *                 enabled) for increasing particle counts
+ *   -n            instead of the effects: check that the old effect of a transition sees the segment name (like
+ *                 Scrolling Text does), exit with code 1 if not
+ */
+#include <chrono>
+#include <unistd.h>
+#include "wled.h"
+#include "FXparticleSystem.h"
+
+struct Layout {
+  unsigned width;
+  unsigned height; // 1 = 1D strip
+};
+
+static const Layout layouts[] = {
+  {  30,  1 }, { 300,  1 }, { 1000, 1 },
+  {  16, 16 }, {  32, 32 }, {   64, 64 },
+};
+
+static void setupStrip(const Layout &l) {
+  uint8_t pins[OUTPUT_MAX_PINS] = {2, 255, 255, 255, 255};
+  strip.isMatrix = l.height > 1;
+  #ifndef WLED_DISABLE_2D
+  strip.panel.clear();
+  if (strip.isMatrix) {
+    WS2812FX::Panel p;
+    p.width  = l.width;
+    p.height = l.height;
+    strip.panel.push_back(p);
+  }
+  #endif
+  busConfigs.emplace_back(TYPE_WS2812_RGB, pins, 0, l.width * l.height, COL_ORDER_GRB);
+  strip.setTransition(0);
+  strip.finalizeInit();
+  strip.makeAutoSegments(true);
+  strip.setBrightness(255, true);
+}
+
+// effect metadata 4th field: '0' = single pixel, '1' = 1D, '2' = 2D (1D if absent)
+static bool supportsLayout(const char *data, const Layout &l, bool mapped) {
+  const char *flags = data;
+  for (int i = 0; i < 3 && flags; i++) { flags = strchr(flags, ';'); if (flags) flags++; }
+  if (!flags || *flags == ';' || *flags == '\0') return l.height == 1 || mapped;
+  const char *end = strchr(flags, ';');
+  size_t len = end ? size_t(end - flags) : strlen(flags);
+  const bool is2D = memchr(flags, '2', len);
+  const bool is1D = memchr(flags, '1', len) || memchr(flags, '0', len);
+  return (l.height > 1 && !mapped) ? is2D : is1D;
+}
+
+// playlist-like transition churn on a 288 LED strip split into 16 segments
+static void transitionBench(unsigned changes, bool csv) {
+  const unsigned segs = 16, segLen = 18;
+  setupStrip({segs * segLen, 1});
+  strip.resetSegments();
+  strip.getSegment(0).setGeometry(0, segLen);
+  for (unsigned s = 1; s < segs; s++) strip.appendSegment(s * segLen, (s+1) * segLen);
+  strip.setTransition(500);
+  static const uint8_t fx[] = { FX_MODE_RAINBOW_CYCLE, FX_MODE_FIRE_FLICKER, FX_MODE_TWINKLEFOX, FX_MODE_METEOR };
+  for (unsigned s = 0; s < segs; s++) strip.getSegment(s).setMode(fx[0], true);
+  nativeAdvanceMillis(strip.getFrameTime()); strip.trigger(); strip.service();
+
+  const size_t allocsBase = nativeHeapAllocs(), trBase = Segment::getTransitionAllocations(), heapBase = nativeHeapUsed();
+  nativeHeapResetPeak();
+  for (unsigned c = 1; c <= changes; c++) {
+    for (unsigned s = 0; s < segs; s++) strip.getSegment(s).setMode(fx[(c + s) % sizeof(fx)], true);
+    for (unsigned f = 0; f * strip.getFrameTime() < 600; f++) { // let the transition finish
+      nativeAdvanceMillis(strip.getFrameTime());
+      strip.trigger();
+      strip.service();
+    }
+  }
+  const unsigned allocs = nativeHeapAllocs() - allocsBase, trAllocs = Segment::getTransitionAllocations() - trBase;
+  const unsigned peak = nativeHeapPeak() - heapBase;
+  if (csv) printf("changes,segments,allocs,transition_allocs,heap\n%u,%u,%u,%u,%u\n", changes, segs, allocs, trAllocs, peak);
+  else     printf("%u changes x %u segments: %u heap allocations (%u for transitions), peak heap +%u\n", changes, segs, allocs, trAllocs, peak);
+}
+
+// the old effect of a transition is rendered from a snapshot of the segment, it has to see the segment's name
+static const char probeName[] = "Probe text";
+static unsigned probeNamed, probeUnnamed;
+
+static uint16_t mode_name_probe(void) {
+  if (SEGMENT.name && strcmp(SEGMENT.name, probeName) == 0) probeNamed++;
+  else probeUnnamed++;
+  SEGMENT.fill(SEGCOLOR(0));
+  return FRAMETIME;
+}
+
+static bool namedTransitionCheck() {
+  setupStrip({32, 8});
+  const uint8_t probe = strip.addEffect(255, &mode_name_probe, "Name probe@;;!;2");
+  Segment &seg = strip.getSegment(0);
+  seg.setName(probeName);
+  seg.setMode(probe, true);
+  nativeAdvanceMillis(strip.getFrameTime()); strip.trigger(); strip.service();
+
+  strip.setTransition(1000);
+  seg.setMode(FX_MODE_RAINBOW, true); // probe only runs as the old effect of the transition from now on
+  probeNamed = probeUnnamed = 0;
+  for (unsigned f = 0; f * strip.getFrameTime() < 1100; f++) {
+    nativeAdvanceMillis(strip.getFrameTime());
+    strip.trigger();
+    strip.service();
+  }
+  const bool ok = probeNamed > 0 && probeUnnamed == 0;
+  printf("named transition: old effect saw the name in %u of %u frames: %s\n", probeNamed, probeNamed + probeUnnamed, ok ? "ok" : "FAIL");
+  return ok;
+}
+
+#ifndef WLED_DISABLE_PARTICLESYSTEM2D
+// particle count vs. frame time of a collision heavy particle effect
+static void collisionBench(unsigned frames, bool csv) {
+  static const Layout sizes[] = { { 32, 32 }, { 64, 64 } };
+  static const uint8_t amounts[] = { 16, 64, 128, 192, 255 }; // "Particles" slider
+  if (csv) printf("layout,particles,us_avg,us_max\n");
+  else     printf("%-7s %9s %9s %9s\n", "layout", "particles", "us/frame", "us max");
+  for (const Layout &l : sizes) {
+    char layoutName[16];
+    snprintf(layoutName, sizeof(layoutName), "%ux%u", l.width, l.height);
+    setupStrip(l);
+    for (uint8_t amount : amounts) {
+      Segment &seg = strip.getMainSegment();
+      seg.setMode(FX_MODE_STATIC);
+      nativeAdvanceMillis(strip.getFrameTime()); strip.trigger(); strip.service();
+      randomSeed(1);
+      random16_set_seed(1337);
+      seg.setMode(FX_MODE_PARTICLEBOX, true);
+      seg.intensity = amount;
+      unsigned particles = 0;
+      for (unsigned f = 0; f < 100 || f < particles + 200; f++) { // PS Box adds one particle per frame, let them settle
+        nativeAdvanceMillis(strip.getFrameTime());
+        strip.trigger();
+        strip.service();
+        if (seg.data) particles = reinterpret_cast<ParticleSystem2D *>(seg.data)->usedParticles;
+      }
+      uint64_t total = 0, worst = 0; // ns
+      for (unsigned f = 0; f < frames; f++) {
+        nativeAdvanceMillis(strip.getFrameTime());
+        strip.trigger();
+        const auto t0 = std::chrono::steady_clock::now();
+        strip.service();
+        const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+        total += ns;
+        if (ns > worst) worst = ns;
+      }
+      const double avg = double(total) / frames / 1000.0;
+      if (csv) printf("%s,%u,%.1f,%u\n", layoutName, particles, avg, unsigned(worst / 1000));
+      else     printf("%-7s %9u %9.1f %9u\n", layoutName, particles, avg, unsigned(worst / 1000));
+    }
+  }
+}
+#endif
+
+int main(int argc, char **argv) {
+  unsigned frames = 200;
+  const char *modeFilter = nullptr;
+  const char *layoutFilter = nullptr;
+  bool csv = false;
+  unsigned maxUs = 0;
+  unsigned changes = 0;
+  int mapping = -1;
+  bool particles = false;
+  bool named = false;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "f:m:l:cx:t:M:pn")) != -1) {
+    switch (opt) {
+      case 'f': frames = max(1, atoi(optarg)); break;
+      case 'm': modeFilter = optarg; break;
+      case 'l': layoutFilter = optarg; break;
+      case 'c': csv = true; break;
+      case 'x': maxUs = atoi(optarg); break;
+      case 't': changes = max(1, atoi(optarg)); break;
+      case 'M': mapping = constrain(atoi(optarg), 0, 7); break;
+      case 'p': particles = true; break;
+      case 'n': named = true; break;
+      default:
+        fprintf(stderr, "usage: %s [-f frames] [-m effect] [-l layout] [-c] [-x max_us] [-t changes] [-M m12] [-p] [-n]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  NeoGammaWLEDMethod::calcGammaTable(gammaCorrectVal); // done by deserializeConfig() on the device, effects using gamma8() render black without it
+
+  if (changes) {
+    transitionBench(changes, csv);
+    return 0;
+  }
+  if (named) return namedTransitionCheck() ? 0 : 1;
+  #ifndef WLED_DISABLE_PARTICLESYSTEM2D
+  if (particles) {
+    collisionBench(frames, csv);
+    return 0;
+  }
+  #endif
+
+  if (csv) printf("layout,id,effect,us_avg,us_max,heap\n");
+  else     printf("%-7s %3s  %-24s %9s %9s %8s\n", "layout", "id", "effect", "us/frame", "us max", "heap");
+
+  unsigned slow = 0;
+  for (const Layout &l : layouts) {
+    char layoutName[16];
+    if (l.height > 1) snprintf(layoutName, sizeof(layoutName), "%ux%u", l.width, l.height);
+    else              snprintf(layoutName, sizeof(layoutName), "%u", l.width);
+    if (layoutFilter && strcmp(layoutFilter, layoutName)) continue;
+    if (mapping >= 0 && l.height == 1) continue;
+
+    setupStrip(l);
+
+    for (unsigned id = 0; id < strip.getModeCount(); id++) {
+      const char *data = strip.getModeData(id);
+      if (data == nullptr || strncmp_P(data, PSTR("RSVD"), 4) == 0 || !supportsLayout(data, l, mapping >= 0)) continue;
+      char name[32];
+      extractModeName(id, nullptr, name, sizeof(name)-1);
+      if (modeFilter && !strstr(name, modeFilter)) continue;
+
+      // release whatever the previous effect allocated so heap is measured from a clean baseline
+      Segment &seg = strip.getMainSegment();
+      seg.setMode(FX_MODE_STATIC);
+      nativeAdvanceMillis(strip.getFrameTime()); strip.trigger(); strip.service();
+      const size_t heapBase = nativeHeapUsed();
+      nativeHeapResetPeak();
+      randomSeed(1);
+      random16_set_seed(1337);
+
+      seg.setMode(id, true);
+      if (mapping >= 0) seg.setGeometry(seg.start, seg.stop, seg.grouping, seg.spacing, seg.offset, seg.startY, seg.stopY, mapping);
+      uint64_t total = 0, worst = 0; // ns
+      for (unsigned f = 0; f < frames; f++) {
+        nativeAdvanceMillis(strip.getFrameTime());
+        strip.trigger(); // render all segments regardless of the effect's own frame delay
+        const auto t0 = std::chrono::steady_clock::now();
+        strip.service();
+        const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+        total += ns;
+        if (ns > worst) worst = ns;
+      }
+      const double avg = double(total) / frames / 1000.0;
+      const size_t heap = nativeHeapPeak() - heapBase;
+      if (maxUs && avg > maxUs) slow++;
+
+      if (csv) printf("%s,%u,\"%s\",%.1f,%u,%u\n", layoutName, id, name, avg, unsigned(worst / 1000), (unsigned)heap);
+      else     printf("%-7s %3u  %-24s %9.1f %9u %8u%s\n", layoutName, id, name, avg, unsigned(worst / 1000), (unsigned)heap,
+                      (maxUs && avg > maxUs) ? "  SLOW" : "");
+    }
+  }
+
+  if (slow) fprintf(stderr, "%u effect(s) exceeded %u us/frame\n", slow, maxUs);
+  return slow ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+#pragma once
+/*
+ * Minimal Arduino core replacement for the host-native (PC) build of the FX engine.
+ * Only what FX.cpp, FX_fcn.cpp, FX_2Dfcn.cpp, FXparticleSystem.cpp, colors.cpp and friends
+ * need is provided. Timing follows the host clock (see native_hw.cpp), hardware access is a no-op.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+
+#ifndef WLED_NATIVE
+  #define WLED_NATIVE
+#endif
+
+#undef unix
+#undef linux
+
+typedef uint8_t  byte;
+typedef bool     boolean;
+typedef unsigned int word;
+inline uint16_t makeWord(uint16_t w) { return w; }
+inline uint16_t makeWord(uint8_t h, uint8_t l) { return (h << 8) | l; }
+#define word(...) makeWord(__VA_ARGS__)
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define DRAM_ATTR
+#define EXT_RAM_ATTR
+#define RTC_NOINIT_ATTR
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define F(s) (s)
+#define FPSTR(p) ((const char *)(p))
+class __FlashStringHelper;
+
+#define pgm_read_byte(addr)  (*(const uint8_t  *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_float(addr) (*(const float    *)(addr))
+#define pgm_read_ptr(addr)   (*(void * const *)(addr))
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+
+#define memcpy_P   memcpy
+#define memcmp_P   memcmp
+#define strcpy_P   strcpy
+#define strncpy_P  strncpy
+#define strcat_P   strcat
+#define strncat_P  strncat
+#define strcmp_P   strcmp
+#define strncmp_P  strncmp
+#define strcasecmp_P strcasecmp
+#define strlen_P   strlen
+#define strstr_P   strstr
+#define strchr_P   strchr
+#define sprintf_P  sprintf
+#define snprintf_P snprintf
+#define vsnprintf_P vsnprintf
+#define sscanf_P   sscanf
+#define printf_P   printf
+
+#ifndef PI
+#define PI          3.1415926535897932384626433832795
+#endif
+#ifndef M_TWOPI
+#define M_TWOPI     6.283185307179586476925286766559
+#endif
+#define HALF_PI     1.5707963267948966192313216916398
+#define TWO_PI      6.283185307179586476925286766559
+#define DEG_TO_RAD  0.017453292519943295769236907684886
+#define RAD_TO_DEG  57.295779513082320876798154814105
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT         0x01
+#define OUTPUT        0x03
+#define INPUT_PULLUP  0x05
+#define INPUT_PULLDOWN 0x09
+#define OUTPUT_OPEN_DRAIN 0x13
+
+using std::min;
+using std::max;
+using std::abs;
+using std::isnan;
+using std::isinf;
+
+#define _min(a,b) ((a)<(b)?(a):(b))
+#define _max(a,b) ((a)>(b)?(a):(b))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define radians(deg) ((deg)*DEG_TO_RAD)
+#define degrees(rad) ((rad)*RAD_TO_DEG)
+#define sq(x) ((x)*(x))
+#define lowByte(w)  ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+#define bitRead(value, bit)  (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit)   ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define bit(b) (1UL << (b))
+
+#if !defined(__GLIBC__) || __GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size) { size_t n = len < size - 1 ? len : size - 1; memcpy(dst, src, n); dst[n] = 0; }
+  return len;
+}
+inline size_t strlcat(char *dst, const char *src, size_t size) {
+  size_t dlen = strnlen(dst, size);
+  return dlen == size ? size + strlen(src) : dlen + strlcpy(dst + dlen, src, size - dlen);
+}
+#endif
+inline char *itoa(int value, char *str, int base)            { if (base == 10) sprintf(str, "%d", value); else if (base == 16) sprintf(str, "%x", value); else sprintf(str, "%o", value); return str; }
+inline char *ltoa(long value, char *str, int base)           { if (base == 10) sprintf(str, "%ld", value); else if (base == 16) sprintf(str, "%lx", value); else sprintf(str, "%lo", value); return str; }
+inline char *utoa(unsigned value, char *str, int base)       { if (base == 10) sprintf(str, "%u", value); else if (base == 16) sprintf(str, "%x", value); else sprintf(str, "%o", value); return str; }
+inline char *ultoa(unsigned long value, char *str, int base) { if (base == 10) sprintf(str, "%lu", value); else if (base == 16) sprintf(str, "%lx", value); else sprintf(str, "%lo", value); return str; }
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  const long run = in_max - in_min;
+  if (run == 0) return out_min;
+  return (x - in_min) * (out_max - out_min) / run + out_min;
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void nativeAdvanceMillis(unsigned long ms); // moves millis()/micros() forward without sleeping
+inline void yield() {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int  digitalRead(uint8_t) { return LOW; }
+inline int  analogRead(uint8_t) { return 0; }
+inline void analogWrite(uint8_t, int) {}
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+#include "HardwareSerial.h"
+#include "Esp.h"
+#include "esp_system.h"
+#include "freertos_stub.h"
@@ -0,0 +1,23 @@
+#pragma once
+// AsyncUDP replacement for the host-native build: type declarations only
+#include <Arduino.h>
+#include <functional>
+
+class AsyncUDPPacket {
+  public:
+    uint8_t *data() { return nullptr; }
+    size_t length() { return 0; }
+    IPAddress remoteIP() { return IPAddress(); }
+    uint16_t remotePort() { return 0; }
+    bool isBroadcast() { return false; }
+    bool isMulticast() { return false; }
+};
+typedef std::function<void(AsyncUDPPacket &packet)> AuPacketHandlerFunction;
+
+class AsyncUDP {
+  public:
+    void onPacket(AuPacketHandlerFunction) {}
+    bool listen(uint16_t) { return false; }
+    bool listenMulticast(const IPAddress &, uint16_t, uint8_t = 1) { return false; }
+    void close() {}
+};
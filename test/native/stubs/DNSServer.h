@@ -0,0 +1,10 @@
+#pragma once
+// host-native build: captive portal DNS is not used by the FX engine
+#include <Arduino.h>
+
+class DNSServer {
+  public:
+    bool start(uint16_t, const char *, const IPAddress &) { return true; }
+    void processNextRequest() {}
+    void stop() {}
+};
@@ -0,0 +1,70 @@
+#pragma once
+// ESPAsyncWebServer replacement for the host-native build: type declarations only, no networking
+#include <Arduino.h>
+#include <functional>
+#include <FS.h>
+
+#define SPIFFS_EDITOR_AIRCOOOKIE
+
+static const char CONTENT_TYPE_JSON[] = "application/json";
+
+typedef enum {
+  HTTP_GET = 0b00000001, HTTP_POST = 0b00000010, HTTP_DELETE = 0b00000100, HTTP_PUT = 0b00001000,
+  HTTP_PATCH = 0b00010000, HTTP_HEAD = 0b00100000, HTTP_OPTIONS = 0b01000000, HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerResponse;
+class AsyncWebServerRequest {
+  public:
+    void *_tempObject = nullptr;
+    WebRequestMethodComposite method() const { return HTTP_GET; }
+    const String &url() const { return _url; }
+    void addInterestingHeader(const String &) {}
+    void send(int, const String & = String(), const String & = String()) {}
+    void send(AsyncWebServerResponse *) {}
+    bool hasArg(const char *) const { return false; }
+    AsyncWebServerResponse *beginResponse(FS &, const String &, const String & = String(), bool = false, std::function<String(const String&)> = nullptr) { return nullptr; }
+    AsyncWebServerResponse *beginResponse_P(int, const String &, const uint8_t *, size_t) { return nullptr; }
+  private:
+    String _url;
+};
+
+class AsyncWebServerResponse {
+  protected:
+    int _code = 0;
+    String _contentType;
+    size_t _contentLength = 0;
+    size_t _sentLength = 0;
+  public:
+    virtual ~AsyncWebServerResponse() {}
+};
+
+class AsyncAbstractResponse : public AsyncWebServerResponse {
+  public:
+    virtual bool _sourceValid() const { return false; }
+    virtual size_t _fillBuffer(uint8_t *, size_t) { return 0; }
+};
+
+class AsyncWebHandler {
+  public:
+    virtual ~AsyncWebHandler() {}
+    virtual bool canHandle(AsyncWebServerRequest *) { return false; }
+    virtual void handleRequest(AsyncWebServerRequest *) {}
+    virtual void handleUpload(AsyncWebServerRequest *, const String &, size_t, uint8_t *, size_t, bool) {}
+    virtual void handleBody(AsyncWebServerRequest *, uint8_t *, size_t, size_t, size_t) {}
+    virtual bool isRequestHandlerTrivial() { return true; }
+};
+
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+class AsyncWebSocket;
+class AsyncWebSocketClient;
+class AsyncClient;
+
+class AsyncWebServer {
+  public:
+    struct queueConfig { size_t a, b, c, d; };
+    AsyncWebServer(uint16_t, queueConfig = {}) {}
+    void begin() {}
+    void end() {}
+};
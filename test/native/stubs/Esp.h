@@ -0,0 +1,44 @@
+#pragma once
+// ESP system API replacement for the host-native build
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_EXEC       (1<<0)
+#define MALLOC_CAP_32BIT      (1<<1)
+#define MALLOC_CAP_8BIT       (1<<2)
+#define MALLOC_CAP_DMA        (1<<3)
+#define MALLOC_CAP_SPIRAM     (1<<10)
+#define MALLOC_CAP_INTERNAL   (1<<11)
+#define MALLOC_CAP_DEFAULT    (1<<12)
+#define MALLOC_CAP_RTCRAM     (1<<15)
+
+// heap accounting used by the benchmark runner (see native_heap.cpp)
+void  *heap_caps_malloc(size_t size, uint32_t caps);
+void  *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void  *heap_caps_realloc(void *ptr, size_t size, uint32_t caps);
+void  *heap_caps_malloc_prefer(size_t size, size_t num, ...);
+void  *heap_caps_calloc_prefer(size_t n, size_t size, size_t num, ...);
+void  *heap_caps_realloc_prefer(void *ptr, size_t size, size_t num, ...);
+void   heap_caps_free(void *ptr);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+size_t nativeHeapUsed();      // bytes currently allocated via heap_caps_*
+size_t nativeHeapPeak();      // high-water mark since last nativeHeapResetPeak()
+void   nativeHeapResetPeak();
+size_t nativeHeapAllocs();    // number of allocations (malloc/calloc/realloc) so far
+inline bool psramFound() { return false; }
+
+class EspClass {
+  public:
+    uint32_t getFreeHeap() { return heap_caps_get_free_size(MALLOC_CAP_8BIT); }
+    uint32_t getMaxAllocHeap() { return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT); }
+    uint32_t getHeapSize() { return 320*1024; }
+    uint32_t getPsramSize() { return 0; }
+    uint32_t getFreePsram() { return 0; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint8_t  getChipRevision() { return 3; }
+    uint32_t getFlashChipSize() { return 4*1024*1024; }
+    uint32_t getCycleCount();
+    void restart() { exit(0); }
+};
+extern EspClass ESP;
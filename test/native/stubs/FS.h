@@ -0,0 +1,68 @@
+#pragma once
+// Arduino FS replacement for the host-native build: files live in a host directory
+// (current directory by default, override with the WLED_FS_ROOT environment variable)
+#include <stdio.h>
+#include <string>
+#include <memory>
+#include "Stream.h"
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File : public Stream {
+  std::shared_ptr<FILE> _f;
+  std::string _name;
+  public:
+    File() = default;
+    File(FILE *f, const char *name) : _f(f, [](FILE *p){ if (p) fclose(p); }), _name(name) {}
+    size_t write(uint8_t c) override { return _f ? fwrite(&c, 1, 1, _f.get()) : 0; }
+    size_t write(const uint8_t *buf, size_t size) override { return _f ? fwrite(buf, 1, size, _f.get()) : 0; }
+    using Print::write;
+    int available() override { if (!_f) return 0; long p = ftell(_f.get()); return (int)(size() - p); }
+    int read() override { return _f ? fgetc(_f.get()) : -1; }
+    size_t read(uint8_t *buf, size_t size) { return _f ? fread(buf, 1, size, _f.get()) : 0; }
+    size_t readBytes(char *buf, size_t length) override { return read((uint8_t *)buf, length); }
+    int peek() override { if (!_f) return -1; int c = fgetc(_f.get()); if (c != EOF) ungetc(c, _f.get()); return c; }
+    void flush() override { if (_f) fflush(_f.get()); }
+    bool seek(uint32_t pos, SeekMode mode = SeekSet) { return _f && fseek(_f.get(), pos, mode) == 0; }
+    size_t position() const { return _f ? ftell(_f.get()) : 0; }
+    size_t size() const { if (!_f) return 0; long p = ftell(_f.get()); fseek(_f.get(), 0, SEEK_END); long s = ftell(_f.get()); fseek(_f.get(), p, SEEK_SET); return s; }
+    void close() { _f.reset(); }
+    const char *name() const { return _name.c_str(); }
+    bool isDirectory() const { return false; }
+    File openNextFile() { return File(); }
+    operator bool() const { return (bool)_f; }
+};
+
+struct FSInfo { size_t totalBytes; size_t usedBytes; size_t blockSize; size_t pageSize; size_t maxOpenFiles; size_t maxPathLength; };
+
+class FS {
+  public:
+    bool begin(bool = false) { return true; }
+    void end() {}
+    File open(const char *path, const char *mode = FILE_READ);
+    File open(const String &path, const char *mode = FILE_READ) { return open(path.c_str(), mode); }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *from, const char *to);
+    bool info(FSInfo &info) { info = FSInfo{1024*1024, 0, 4096, 256, 5, 32}; return true; }
+    size_t totalBytes() { return 1024*1024; }
+    size_t usedBytes() { return 0; }
+};
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
+using fs::FSInfo;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
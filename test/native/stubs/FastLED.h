@@ -0,0 +1,366 @@
+#pragma once
+/*
+ * FastLED subset for the host-native build of the FX engine.
+ * Provides the color types, palettes and 8/16 bit math helpers that WLED effects use.
+ * Math follows the FastLED reference (C) implementations closely enough for profiling;
+ * it is not meant to be bit-exact on every edge case.
+ */
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <Arduino.h>
+
+#define FASTLED_VERSION 3006000
+#define FASTLED_SCALE8_FIXED 1
+#define FL_PROGMEM PROGMEM
+
+typedef uint8_t  fract8;
+typedef uint16_t fract16;
+typedef int8_t   sfract7;
+typedef int16_t  sfract15;
+typedef uint16_t accum88;
+typedef int16_t  saccum78;
+typedef uint32_t accum1616;
+typedef int32_t  saccum1516;
+typedef uint16_t accum124;
+typedef int32_t  saccum114;
+
+#ifndef GET_MILLIS
+  #define GET_MILLIS millis
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// 8/16 bit math
+
+inline uint8_t  scale8(uint8_t i, fract8 scale)        { return (((uint16_t)i) * (1 + (uint16_t)scale)) >> 8; }
+inline uint8_t  scale8_video(uint8_t i, fract8 scale)  { return (((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0); }
+inline uint16_t scale16(uint16_t i, fract16 scale)     { return ((uint32_t)i * (1 + (uint32_t)scale)) >> 16; }
+inline uint16_t scale16by8(uint16_t i, fract8 scale)   { return (i * (1 + ((uint16_t)scale))) >> 8; }
+inline uint8_t  qadd8(uint8_t i, uint8_t j)            { unsigned t = i + j; return t > 255 ? 255 : t; }
+inline int8_t   qadd7(int8_t i, int8_t j)              { int t = i + j; return t > 127 ? 127 : (t < -128 ? -128 : t); }
+inline uint8_t  qsub8(uint8_t i, uint8_t j)            { int t = i - j; return t < 0 ? 0 : t; }
+inline uint8_t  qmul8(uint8_t i, uint8_t j)            { unsigned p = (unsigned)i * j; return p > 255 ? 255 : p; }
+inline uint8_t  add8(uint8_t i, uint8_t j)             { return i + j; }
+inline uint8_t  sub8(uint8_t i, uint8_t j)             { return i - j; }
+inline uint8_t  mul8(uint8_t i, uint8_t j)             { return ((unsigned)i * j) & 0xFF; }
+inline uint8_t  avg8(uint8_t i, uint8_t j)             { return (i + j) >> 1; }
+inline uint16_t avg16(uint16_t i, uint16_t j)          { return ((uint32_t)i + j) >> 1; }
+inline int8_t   abs8(int8_t i)                         { return i < 0 ? -i : i; }
+inline uint8_t  addmod8(uint8_t a, uint8_t b, uint8_t m) { a += b; while (a >= m) a -= m; return a; }
+inline uint8_t  submod8(uint8_t a, uint8_t b, uint8_t m) { a -= b; while (a >= m) a -= m; return a; }
+inline uint8_t  map8(uint8_t in, uint8_t rangeStart, uint8_t rangeEnd) { return rangeStart + scale8(in, rangeEnd - rangeStart); }
+inline uint8_t  dim8_raw(uint8_t x)                    { return scale8(x, x); }
+inline uint8_t  dim8_video(uint8_t x)                  { return scale8_video(x, x); }
+inline uint8_t  brighten8_raw(uint8_t x)               { uint8_t ix = 255 - x; return 255 - scale8(ix, ix); }
+inline uint8_t  brighten8_video(uint8_t x)             { uint8_t ix = 255 - x; return 255 - scale8_video(ix, ix); }
+inline void     nscale8x3(uint8_t &r, uint8_t &g, uint8_t &b, fract8 scale) { r = scale8(r, scale); g = scale8(g, scale); b = scale8(b, scale); }
+inline void     nscale8x3_video(uint8_t &r, uint8_t &g, uint8_t &b, fract8 scale) { r = scale8_video(r, scale); g = scale8_video(g, scale); b = scale8_video(b, scale); }
+
+inline uint8_t lerp8by8(uint8_t a, uint8_t b, fract8 frac) {
+  return b > a ? a + scale8(b - a, frac) : a - scale8(a - b, frac);
+}
+inline uint16_t lerp16by16(uint16_t a, uint16_t b, fract16 frac) {
+  return b > a ? a + scale16(b - a, frac) : a - scale16(a - b, frac);
+}
+inline uint16_t lerp16by8(uint16_t a, uint16_t b, fract8 frac) {
+  return b > a ? a + scale16by8(b - a, frac) : a - scale16by8(a - b, frac);
+}
+
+inline uint8_t ease8InOutQuad(uint8_t i) {
+  uint8_t j = (i & 0x80) ? 255 - i : i;
+  uint8_t jj = scale8(j, j);
+  uint8_t jj2 = jj << 1;
+  return (i & 0x80) ? 255 - jj2 : jj2;
+}
+inline uint8_t ease8InOutCubic(fract8 i) {
+  uint8_t ii = scale8(i, i);
+  uint8_t iii = scale8(ii, i);
+  uint16_t r1 = (3 * (uint16_t)ii) - (2 * (uint16_t)iii);
+  return (r1 & 0x100) ? 255 : r1;
+}
+inline uint8_t ease8InOutApprox(fract8 i) {
+  if (i < 64) return i / 2;
+  if (i > 191) return 255 - ((255 - i) / 2);
+  return 32 + (((i - 64) * 3) >> 1) - ((i - 64) >> 3);
+}
+inline uint8_t triwave8(uint8_t in) {
+  if (in & 0x80) in = 255 - in;
+  return in << 1;
+}
+inline uint8_t quadwave8(uint8_t in)  { return ease8InOutQuad(triwave8(in)); }
+inline uint8_t cubicwave8(uint8_t in) { return ease8InOutCubic(triwave8(in)); }
+
+inline int16_t sin16(uint16_t theta) { return (int16_t)lrintf(32767.0f * sinf(theta * (float)(2.0 * M_PI / 65536.0))); }
+inline int16_t cos16(uint16_t theta) { return sin16(theta + 16384); }
+inline uint8_t sin8(uint8_t theta)   { return (uint8_t)(128 + (sin16((uint16_t)theta << 8) >> 8)); }
+inline uint8_t cos8(uint8_t theta)   { return sin8(theta + 64); }
+
+inline uint16_t sqrt16(uint16_t x) { return (uint16_t)sqrtf((float)x); }
+
+///////////////////////////////////////////////////////////////////////////////
+// PRNG (same LCG as FastLED so effects that reseed behave identically)
+
+extern uint16_t rand16seed;
+#define FASTLED_RAND16_2053  ((uint16_t)(2053))
+#define FASTLED_RAND16_13849 ((uint16_t)(13849))
+inline uint8_t  random8()  { rand16seed = (rand16seed * FASTLED_RAND16_2053) + FASTLED_RAND16_13849; return (uint8_t)(((uint8_t)(rand16seed & 0xFF)) + ((uint8_t)(rand16seed >> 8))); }
+inline uint8_t  random8(uint8_t lim) { uint8_t r = random8(); r = (r * lim) >> 8; return r; }
+inline uint8_t  random8(uint8_t min, uint8_t lim) { return random8(lim - min) + min; }
+inline uint16_t random16() { rand16seed = (rand16seed * FASTLED_RAND16_2053) + FASTLED_RAND16_13849; return rand16seed; }
+inline uint16_t random16(uint16_t lim) { uint32_t p = (uint32_t)lim * random16(); return p >> 16; }
+inline uint16_t random16(uint16_t min, uint16_t lim) { return random16(lim - min) + min; }
+inline void     random16_set_seed(uint16_t seed) { rand16seed = seed; }
+inline uint16_t random16_get_seed() { return rand16seed; }
+inline void     random16_add_entropy(uint16_t entropy) { rand16seed += entropy; }
+
+///////////////////////////////////////////////////////////////////////////////
+// beat generators
+
+inline uint16_t beat88(accum88 beats_per_minute_88, uint32_t timebase = 0) { return (((GET_MILLIS()) - timebase) * beats_per_minute_88 * 280) >> 16; }
+inline uint16_t beat16(accum88 beats_per_minute, uint32_t timebase = 0) { if (beats_per_minute < 256) beats_per_minute <<= 8; return beat88(beats_per_minute, timebase); }
+inline uint8_t  beat8(accum88 beats_per_minute, uint32_t timebase = 0) { return beat16(beats_per_minute, timebase) >> 8; }
+inline uint8_t  beatsin8(accum88 beats_per_minute, uint8_t lowest = 0, uint8_t highest = 255, uint32_t timebase = 0, uint8_t phase_offset = 0) {
+  uint8_t beat = beat8(beats_per_minute, timebase);
+  uint8_t beatsin = sin8(beat + phase_offset);
+  return lowest + scale8(beatsin, highest - lowest);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// colors
+
+struct CRGB;
+struct CHSV {
+  union {
+    struct { union { uint8_t hue; uint8_t h; }; union { uint8_t saturation; uint8_t sat; uint8_t s; }; union { uint8_t value; uint8_t val; uint8_t v; }; };
+    uint8_t raw[3];
+  };
+  inline CHSV() __attribute__((always_inline)) = default;
+  constexpr CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+  inline uint8_t &operator[](uint8_t x) { return raw[x]; }
+  inline const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+};
+
+typedef enum { HUE_RED = 0, HUE_ORANGE = 32, HUE_YELLOW = 64, HUE_GREEN = 96, HUE_AQUA = 128, HUE_BLUE = 160, HUE_PURPLE = 192, HUE_PINK = 224 } HSVHue;
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+void hsv2rgb_spectrum(const CHSV &hsv, CRGB &rgb);
+CHSV rgb2hsv_approximate(const CRGB &rgb);
+
+struct CRGB {
+  union {
+    struct {
+      union { uint8_t r; uint8_t red; };
+      union { uint8_t g; uint8_t green; };
+      union { uint8_t b; uint8_t blue; };
+    };
+    uint8_t raw[3];
+  };
+
+  inline CRGB() __attribute__((always_inline)) = default;
+  constexpr CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  constexpr CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b((colorcode >> 0) & 0xFF) {}
+  inline CRGB(const CHSV &rhs) { hsv2rgb_rainbow(rhs, *this); }
+
+  inline uint8_t &operator[](uint8_t x) { return raw[x]; }
+  inline const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+
+  inline CRGB &operator=(uint32_t colorcode) { r = (colorcode >> 16) & 0xFF; g = (colorcode >> 8) & 0xFF; b = colorcode & 0xFF; return *this; }
+  inline CRGB &operator=(const CHSV &rhs) { hsv2rgb_rainbow(rhs, *this); return *this; }
+  inline CRGB &setRGB(uint8_t nr, uint8_t ng, uint8_t nb) { r = nr; g = ng; b = nb; return *this; }
+  inline CRGB &setHSV(uint8_t hue, uint8_t sat, uint8_t val) { hsv2rgb_rainbow(CHSV(hue, sat, val), *this); return *this; }
+  inline CRGB &setHue(uint8_t hue) { hsv2rgb_rainbow(CHSV(hue, 255, 255), *this); return *this; }
+  inline CRGB &setColorCode(uint32_t colorcode) { return operator=(colorcode); }
+
+  inline CRGB &operator+=(const CRGB &rhs) { r = qadd8(r, rhs.r); g = qadd8(g, rhs.g); b = qadd8(b, rhs.b); return *this; }
+  inline CRGB &addToRGB(uint8_t d) { r = qadd8(r, d); g = qadd8(g, d); b = qadd8(b, d); return *this; }
+  inline CRGB &operator-=(const CRGB &rhs) { r = qsub8(r, rhs.r); g = qsub8(g, rhs.g); b = qsub8(b, rhs.b); return *this; }
+  inline CRGB &subtractFromRGB(uint8_t d) { r = qsub8(r, d); g = qsub8(g, d); b = qsub8(b, d); return *this; }
+  inline CRGB &operator*=(uint8_t d) { r = qmul8(r, d); g = qmul8(g, d); b = qmul8(b, d); return *this; }
+  inline CRGB &operator/=(uint8_t d) { r /= d; g /= d; b /= d; return *this; }
+  inline CRGB &operator>>=(uint8_t d) { r >>= d; g >>= d; b >>= d; return *this; }
+  inline CRGB &operator|=(const CRGB &rhs) { if (rhs.r > r) r = rhs.r; if (rhs.g > g) g = rhs.g; if (rhs.b > b) b = rhs.b; return *this; }
+  inline CRGB &operator|=(uint8_t d) { if (d > r) r = d; if (d > g) g = d; if (d > b) b = d; return *this; }
+  inline CRGB &operator&=(const CRGB &rhs) { if (rhs.r < r) r = rhs.r; if (rhs.g < g) g = rhs.g; if (rhs.b < b) b = rhs.b; return *this; }
+  inline CRGB &operator%=(uint8_t scaledown) { return nscale8_video(scaledown); }
+  inline CRGB &nscale8_video(uint8_t scaledown) { nscale8x3_video(r, g, b, scaledown); return *this; }
+  inline CRGB &nscale8(uint8_t scaledown) { nscale8x3(r, g, b, scaledown); return *this; }
+  inline CRGB &nscale8(const CRGB &s) { r = ::scale8(r, s.r); g = ::scale8(g, s.g); b = ::scale8(b, s.b); return *this; }
+  inline CRGB scale8(uint8_t scaledown) const { CRGB out = *this; nscale8x3(out.r, out.g, out.b, scaledown); return out; }
+  inline CRGB &fadeLightBy(uint8_t fadefactor) { nscale8x3_video(r, g, b, 255 - fadefactor); return *this; }
+  inline CRGB &fadeToBlackBy(uint8_t fadefactor) { nscale8x3(r, g, b, 255 - fadefactor); return *this; }
+  inline CRGB operator-() const { return CRGB(255 - r, 255 - g, 255 - b); }
+  inline explicit operator bool() const { return r || g || b; }
+  inline operator uint32_t() const { return ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b; }
+  inline uint8_t getLuma() const { return ::scale8(r, 54) + ::scale8(g, 183) + ::scale8(b, 18); }
+  inline uint8_t getAverageLight() const { return ::scale8(r, 85) + ::scale8(g, 85) + ::scale8(b, 85); }
+  inline void maximizeBrightness(uint8_t limit = 255) { uint8_t max = r; if (g > max) max = g; if (b > max) max = b; if (max == 0) return; uint16_t factor = ((uint16_t)(limit) * 256) / max; r = (r * factor) / 256; g = (g * factor) / 256; b = (b * factor) / 256; }
+
+  typedef enum {
+    AliceBlue=0xF0F8FF, Amethyst=0x9966CC, AntiqueWhite=0xFAEBD7, Aqua=0x00FFFF, Aquamarine=0x7FFFD4, Azure=0xF0FFFF,
+    Beige=0xF5F5DC, Bisque=0xFFE4C4, Black=0x000000, BlanchedAlmond=0xFFEBCD, Blue=0x0000FF, BlueViolet=0x8A2BE2,
+    Brown=0xA52A2A, BurlyWood=0xDEB887, CadetBlue=0x5F9EA0, Chartreuse=0x7FFF00, Chocolate=0xD2691E, Coral=0xFF7F50,
+    CornflowerBlue=0x6495ED, Cornsilk=0xFFF8DC, Crimson=0xDC143C, Cyan=0x00FFFF, DarkBlue=0x00008B, DarkCyan=0x008B8B,
+    DarkGoldenrod=0xB8860B, DarkGray=0xA9A9A9, DarkGreen=0x006400, DarkKhaki=0xBDB76B, DarkMagenta=0x8B008B,
+    DarkOliveGreen=0x556B2F, DarkOrange=0xFF8C00, DarkOrchid=0x9932CC, DarkRed=0x8B0000, DarkSalmon=0xE9967A,
+    DarkSeaGreen=0x8FBC8F, DarkSlateBlue=0x483D8B, DarkSlateGray=0x2F4F4F, DarkTurquoise=0x00CED1, DarkViolet=0x9400D3,
+    DeepPink=0xFF1493, DeepSkyBlue=0x00BFFF, DimGray=0x696969, DodgerBlue=0x1E90FF, FireBrick=0xB22222,
+    FloralWhite=0xFFFAF0, ForestGreen=0x228B22, Fuchsia=0xFF00FF, Gainsboro=0xDCDCDC, GhostWhite=0xF8F8FF, Gold=0xFFD700,
+    Goldenrod=0xDAA520, Gray=0x808080, Green=0x008000, GreenYellow=0xADFF2F, Honeydew=0xF0FFF0, HotPink=0xFF69B4,
+    IndianRed=0xCD5C5C, Indigo=0x4B0082, Ivory=0xFFFFF0, Khaki=0xF0E68C, Lavender=0xE6E6FA, LavenderBlush=0xFFF0F5,
+    LawnGreen=0x7CFC00, LemonChiffon=0xFFFACD, LightBlue=0xADD8E6, LightCoral=0xF08080, LightCyan=0xE0FFFF,
+    LightGoldenrodYellow=0xFAFAD2, LightGreen=0x90EE90, LightGrey=0xD3D3D3, LightPink=0xFFB6C1, LightSalmon=0xFFA07A,
+    LightSeaGreen=0x20B2AA, LightSkyBlue=0x87CEFA, LightSlateGray=0x778899, LightSteelBlue=0xB0C4DE,
+    LightYellow=0xFFFFE0, Lime=0x00FF00, LimeGreen=0x32CD32, Linen=0xFAF0E6, Magenta=0xFF00FF, Maroon=0x800000,
+    MediumAquamarine=0x66CDAA, MediumBlue=0x0000CD, MediumOrchid=0xBA55D3, MediumPurple=0x9370DB,
+    MediumSeaGreen=0x3CB371, MediumSlateBlue=0x7B68EE, MediumSpringGreen=0x00FA9A, MediumTurquoise=0x48D1CC,
+    MediumVioletRed=0xC71585, MidnightBlue=0x191970, MintCream=0xF5FFFA, MistyRose=0xFFE4E1, Moccasin=0xFFE4B5,
+    NavajoWhite=0xFFDEAD, Navy=0x000080, OldLace=0xFDF5E6, Olive=0x808000, OliveDrab=0x6B8E23, Orange=0xFFA500,
+    OrangeRed=0xFF4500, Orchid=0xDA70D6, PaleGoldenrod=0xEEE8AA, PaleGreen=0x98FB98, PaleTurquoise=0xAFEEEE,
+    PaleVioletRed=0xDB7093, PapayaWhip=0xFFEFD5, PeachPuff=0xFFDAB9, Peru=0xCD853F, Pink=0xFFC0CB, Plaid=0xCC5533,
+    Plum=0xDDA0DD, PowderBlue=0xB0E0E6, Purple=0x800080, Red=0xFF0000, RosyBrown=0xBC8F8F, RoyalBlue=0x4169E1,
+    SaddleBrown=0x8B4513, Salmon=0xFA8072, SandyBrown=0xF4A460, SeaGreen=0x2E8B57, Seashell=0xFFF5EE, Sienna=0xA0522D,
+    Silver=0xC0C0C0, SkyBlue=0x87CEEB, SlateBlue=0x6A5ACD, SlateGray=0x708090, Snow=0xFFFAFA, SpringGreen=0x00FF7F,
+    SteelBlue=0x4682B4, Tan=0xD2B48C, Teal=0x008080, Thistle=0xD8BFD8, Tomato=0xFF6347, Turquoise=0x40E0D0,
+    Violet=0xEE82EE, Wheat=0xF5DEB3, White=0xFFFFFF, WhiteSmoke=0xF5F5F5, Yellow=0xFFFF00, YellowGreen=0x9ACD32,
+    FairyLight=0xFFE42D, FairyLightNCC=0xFF9D2A
+  } HTMLColorCode;
+};
+
+inline bool operator==(const CRGB &a, const CRGB &b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+inline bool operator!=(const CRGB &a, const CRGB &b) { return !(a == b); }
+inline CRGB operator+(const CRGB &a, const CRGB &b) { return CRGB(qadd8(a.r, b.r), qadd8(a.g, b.g), qadd8(a.b, b.b)); }
+inline CRGB operator-(const CRGB &a, const CRGB &b) { return CRGB(qsub8(a.r, b.r), qsub8(a.g, b.g), qsub8(a.b, b.b)); }
+inline CRGB operator*(const CRGB &a, uint8_t d) { return CRGB(qmul8(a.r, d), qmul8(a.g, d), qmul8(a.b, d)); }
+inline CRGB operator/(const CRGB &a, uint8_t d) { return CRGB(a.r / d, a.g / d, a.b / d); }
+inline CRGB operator&(const CRGB &a, const CRGB &b) { return CRGB(a.r < b.r ? a.r : b.r, a.g < b.g ? a.g : b.g, a.b < b.b ? a.b : b.b); }
+inline CRGB operator|(const CRGB &a, const CRGB &b) { return CRGB(a.r > b.r ? a.r : b.r, a.g > b.g ? a.g : b.g, a.b > b.b ? a.b : b.b); }
+inline CRGB operator%(const CRGB &p1, uint8_t d) { CRGB r(p1); r.nscale8_video(d); return r; }
+
+inline CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2) {
+  return CRGB(lerp8by8(p1.r, p2.r, amountOfP2), lerp8by8(p1.g, p2.g, amountOfP2), lerp8by8(p1.b, p2.b, amountOfP2));
+}
+inline CRGB &nblend(CRGB &existing, const CRGB &overlay, fract8 amountOfOverlay) { existing = blend(existing, overlay, amountOfOverlay); return existing; }
+inline void fill_solid(CRGB *leds, int numToFill, const CRGB &color) { for (int i = 0; i < numToFill; i++) leds[i] = color; }
+inline void nscale8(CRGB *leds, uint16_t num_leds, uint8_t scale) { for (uint16_t i = 0; i < num_leds; i++) leds[i].nscale8(scale); }
+inline void fadeToBlackBy(CRGB *leds, uint16_t num_leds, uint8_t fadeBy) { nscale8(leds, num_leds, 255 - fadeBy); }
+
+CRGB HeatColor(uint8_t temperature);
+
+///////////////////////////////////////////////////////////////////////////////
+// palettes
+
+typedef enum { NOBLEND = 0, LINEARBLEND = 1, LINEARBLEND_NOWRAP = 2 } TBlendType;
+typedef uint32_t TProgmemRGBPalette16[16];
+typedef uint32_t TProgmemRGBPalette32[32];
+typedef const uint8_t TProgmemRGBGradientPalette_byte;
+typedef const TProgmemRGBGradientPalette_byte *TProgmemRGBGradientPalette_bytes;
+typedef TProgmemRGBGradientPalette_bytes TProgmemRGBGradientPaletteRef;
+typedef const uint8_t *TDynamicRGBGradientPalette_bytes;
+
+typedef union {
+  struct { uint8_t index; uint8_t r; uint8_t g; uint8_t b; };
+  uint32_t dword;
+  uint8_t bytes[4];
+} TRGBGradientPaletteEntryUnion;
+
+class CRGBPalette16 {
+  public:
+    CRGB entries[16];
+    CRGBPalette16() { memset(entries, 0, sizeof(entries)); }
+    CRGBPalette16(const CRGBPalette16 &rhs) = default;
+    CRGBPalette16 &operator=(const CRGBPalette16 &rhs) = default;
+    CRGBPalette16(const CRGB &c1) { fill_solid(entries, 16, c1); }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2) { fill_gradient_RGB(c1, c2); }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2, const CRGB &c3) { fill_gradient_RGB(c1, c2, c3); }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2, const CRGB &c3, const CRGB &c4) { fill_gradient_RGB(c1, c2, c3, c4); }
+    CRGBPalette16(const CHSV &c1) : CRGBPalette16(CRGB(c1)) {}
+    CRGBPalette16(const CHSV &c1, const CHSV &c2) : CRGBPalette16(CRGB(c1), CRGB(c2)) {}
+    CRGBPalette16(const CHSV &c1, const CHSV &c2, const CHSV &c3) : CRGBPalette16(CRGB(c1), CRGB(c2), CRGB(c3)) {}
+    CRGBPalette16(const CHSV &c1, const CHSV &c2, const CHSV &c3, const CHSV &c4) : CRGBPalette16(CRGB(c1), CRGB(c2), CRGB(c3), CRGB(c4)) {}
+    CRGBPalette16(const CRGB &c00, const CRGB &c01, const CRGB &c02, const CRGB &c03,
+                  const CRGB &c04, const CRGB &c05, const CRGB &c06, const CRGB &c07,
+                  const CRGB &c08, const CRGB &c09, const CRGB &c10, const CRGB &c11,
+                  const CRGB &c12, const CRGB &c13, const CRGB &c14, const CRGB &c15)
+      : entries{c00, c01, c02, c03, c04, c05, c06, c07, c08, c09, c10, c11, c12, c13, c14, c15} {}
+    CRGBPalette16(const CHSV &c00, const CHSV &c01, const CHSV &c02, const CHSV &c03,
+                  const CHSV &c04, const CHSV &c05, const CHSV &c06, const CHSV &c07,
+                  const CHSV &c08, const CHSV &c09, const CHSV &c10, const CHSV &c11,
+                  const CHSV &c12, const CHSV &c13, const CHSV &c14, const CHSV &c15)
+      : entries{c00, c01, c02, c03, c04, c05, c06, c07, c08, c09, c10, c11, c12, c13, c14, c15} {}
+    CRGBPalette16(const TProgmemRGBPalette16 &rhs) { for (int i = 0; i < 16; i++) entries[i] = rhs[i]; }
+    CRGBPalette16 &operator=(const TProgmemRGBPalette16 &rhs) { for (int i = 0; i < 16; i++) entries[i] = rhs[i]; return *this; }
+    CRGBPalette16(TProgmemRGBGradientPalette_bytes progpal) { loadDynamicGradientPalette(progpal); }
+
+    bool operator==(const CRGBPalette16 &rhs) const { return memcmp(entries, rhs.entries, sizeof(entries)) == 0; }
+    bool operator!=(const CRGBPalette16 &rhs) const { return !(*this == rhs); }
+    CRGB &operator[](uint8_t x) { return entries[x]; }
+    const CRGB &operator[](uint8_t x) const { return entries[x]; }
+    operator CRGB *() { return entries; }
+    operator const CRGB *() const { return entries; }
+
+    // gradient palette format: (index, r, g, b) tuples, last index is 255
+    CRGBPalette16 &loadDynamicGradientPalette(TDynamicRGBGradientPalette_bytes gpal) {
+      const TRGBGradientPaletteEntryUnion *progent = (const TRGBGradientPaletteEntryUnion *)gpal;
+      TRGBGradientPaletteEntryUnion u = *progent;
+      CRGB rgbstart(u.r, u.g, u.b);
+      int indexstart = 0;
+      uint8_t istart8 = 0, iend8 = 0;
+      while (indexstart < 255) {
+        progent++;
+        u = *progent;
+        int indexend = u.index;
+        CRGB rgbend(u.r, u.g, u.b);
+        istart8 = indexstart / 16;
+        iend8   = indexend   / 16;
+        if ((istart8 <= iend8) && (indexstart > 0) && (istart8 < 15)) { istart8++; if (iend8 < istart8) iend8 = istart8; }
+        fill_gradient_RGB(istart8, rgbstart, iend8, rgbend);
+        indexstart = indexend;
+        rgbstart = rgbend;
+      }
+      return *this;
+    }
+
+  private:
+    void fill_gradient_RGB(uint16_t startpos, CRGB startcolor, uint16_t endpos, CRGB endcolor) {
+      if (endpos < startpos) { uint16_t t = endpos; endpos = startpos; startpos = t; CRGB tc = endcolor; endcolor = startcolor; startcolor = tc; }
+      if (endpos > 15) endpos = 15;
+      int32_t rdistance87 = (endcolor.r - startcolor.r) << 7;
+      int32_t gdistance87 = (endcolor.g - startcolor.g) << 7;
+      int32_t bdistance87 = (endcolor.b - startcolor.b) << 7;
+      uint16_t pixeldistance = endpos - startpos;
+      int16_t divisor = pixeldistance ? pixeldistance : 1;
+      int32_t rdelta87 = rdistance87 / divisor, gdelta87 = gdistance87 / divisor, bdelta87 = bdistance87 / divisor;
+      rdelta87 *= 2; gdelta87 *= 2; bdelta87 *= 2;
+      int32_t r88 = startcolor.r << 8, g88 = startcolor.g << 8, b88 = startcolor.b << 8;
+      for (uint16_t i = startpos; i <= endpos; ++i) {
+        entries[i] = CRGB(r88 >> 8, g88 >> 8, b88 >> 8);
+        r88 += rdelta87; g88 += gdelta87; b88 += bdelta87;
+      }
+    }
+    void fill_gradient_RGB(const CRGB &c1, const CRGB &c2) { fill_gradient_RGB(0, c1, 15, c2); }
+    void fill_gradient_RGB(const CRGB &c1, const CRGB &c2, const CRGB &c3) { fill_gradient_RGB(0, c1, 7, c2); fill_gradient_RGB(7, c2, 15, c3); }
+    void fill_gradient_RGB(const CRGB &c1, const CRGB &c2, const CRGB &c3, const CRGB &c4) { fill_gradient_RGB(0, c1, 5, c2); fill_gradient_RGB(5, c2, 10, c3); fill_gradient_RGB(10, c3, 15, c4); }
+};
+
+CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness = 255, TBlendType blendType = LINEARBLEND);
+void nblendPaletteTowardPalette(CRGBPalette16 &current, CRGBPalette16 &target, uint8_t maxChanges = 24);
+
+extern const TProgmemRGBPalette16 CloudColors_p;
+extern const TProgmemRGBPalette16 LavaColors_p;
+extern const TProgmemRGBPalette16 OceanColors_p;
+extern const TProgmemRGBPalette16 ForestColors_p;
+extern const TProgmemRGBPalette16 RainbowColors_p;
+extern const TProgmemRGBPalette16 RainbowStripeColors_p;
+extern const TProgmemRGBPalette16 PartyColors_p;
+extern const TProgmemRGBPalette16 HeatColors_p;
+
+///////////////////////////////////////////////////////////////////////////////
+// controller object (WLED only uses it for global random seeding / millis)
+
+class CFastLED {
+  public:
+    void setBrightness(uint8_t) {}
+    void show() {}
+    void clear(bool = false) {}
+};
+extern CFastLED FastLED;
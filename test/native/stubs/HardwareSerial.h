@@ -0,0 +1,16 @@
+#pragma once
+// Arduino HardwareSerial replacement for the host-native build (output goes to stdout)
+#include <stdio.h>
+#include "Stream.h"
+
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long, ...) {}
+    void end() {}
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    size_t write(const uint8_t *buffer, size_t size) override { return fwrite(buffer, 1, size, stdout); }
+    using Print::write;
+    void flush() override { fflush(stdout); }
+    operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
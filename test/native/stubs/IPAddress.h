@@ -0,0 +1,20 @@
+#pragma once
+// Arduino IPAddress replacement for the host-native build
+#include <stdint.h>
+#include "WString.h"
+
+class IPAddress {
+  union { uint8_t bytes[4]; uint32_t dword; } _address;
+  public:
+    IPAddress() { _address.dword = 0; }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { _address.bytes[0] = a; _address.bytes[1] = b; _address.bytes[2] = c; _address.bytes[3] = d; }
+    IPAddress(uint32_t address) { _address.dword = address; }
+    operator uint32_t() const { return _address.dword; }
+    bool operator==(const IPAddress &a) const { return _address.dword == a._address.dword; }
+    bool operator!=(const IPAddress &a) const { return _address.dword != a._address.dword; }
+    uint8_t operator[](int index) const { return _address.bytes[index]; }
+    uint8_t &operator[](int index) { return _address.bytes[index]; }
+    bool fromString(const char *s) { unsigned a, b, c, d; if (sscanf(s, "%u.%u.%u.%u", &a, &b, &c, &d) != 4) return false; *this = IPAddress(a, b, c, d); return true; }
+    bool fromString(const String &s) { return fromString(s.c_str()); }
+    String toString() const { char buf[16]; snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _address.bytes[0], _address.bytes[1], _address.bytes[2], _address.bytes[3]); return String(buf); }
+};
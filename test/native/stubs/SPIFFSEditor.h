@@ -0,0 +1,3 @@
+#pragma once
+// host-native build: not used by the FX engine
+#include <Arduino.h>
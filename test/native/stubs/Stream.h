@@ -0,0 +1,16 @@
+#pragma once
+// Arduino Stream replacement for the host-native build
+#include "Print.h"
+
+class Stream : public Print {
+  public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    virtual size_t readBytes(char *buffer, size_t length) { size_t n = 0; int c; while (n < length && (c = read()) >= 0) buffer[n++] = (char)c; return n; }
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+    size_t readBytesUntil(char terminator, char *buffer, size_t length) { size_t n = 0; int c; while (n < length && (c = read()) >= 0 && c != terminator) buffer[n++] = (char)c; return n; }
+    String readStringUntil(char terminator) { String s; int c; while ((c = read()) >= 0 && c != terminator) s += (char)c; return s; }
+    void setTimeout(unsigned long) {}
+    bool find(const char *target) { size_t i = 0, len = strlen(target); int c; while ((c = read()) >= 0) { i = (c == target[i]) ? i + 1 : (c == target[0]); if (i == len) return true; } return false; }
+};
@@ -0,0 +1,8 @@
+#pragma once
+// host-native build: no OTA partitions
+class UpdateClass {
+  public:
+    bool canRollBack() { return false; }
+    bool rollBack() { return false; }
+};
+extern UpdateClass Update;
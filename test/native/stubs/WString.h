@@ -0,0 +1,99 @@
+#pragma once
+// Arduino String replacement for the host-native build (thin wrapper around std::string)
+#include <string>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+class String {
+  std::string s;
+  public:
+    String() = default;
+    String(const char *c) : s(c ? c : "") {}
+    String(const std::string &str) : s(str) {}
+    String(const String &) = default;
+    String(String &&) = default;
+    explicit String(char c) : s(1, c) {}
+    explicit String(unsigned char v, unsigned char base = 10) { fromULong(v, base); }
+    explicit String(int v, unsigned char base = 10) { if (base == 10) s = std::to_string(v); else fromULong((unsigned)v, base); }
+    explicit String(unsigned v, unsigned char base = 10) { fromULong(v, base); }
+    explicit String(long v, unsigned char base = 10) { if (base == 10) s = std::to_string(v); else fromULong((unsigned long)v, base); }
+    explicit String(unsigned long v, unsigned char base = 10) { fromULong(v, base); }
+    explicit String(float v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+    explicit String(double v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+    String &operator=(const String &) = default;
+    String &operator=(String &&) = default;
+    String &operator=(const char *c) { s = c ? c : ""; return *this; }
+
+    const char *c_str() const { return s.c_str(); }
+    unsigned length() const { return s.length(); }
+    bool isEmpty() const { return s.empty(); }
+    bool reserve(unsigned n) { s.reserve(n); return true; }
+    char charAt(unsigned i) const { return i < s.length() ? s[i] : 0; }
+    char operator[](unsigned i) const { return charAt(i); }
+    char &operator[](unsigned i) { return s[i]; }
+    void setCharAt(unsigned i, char c) { if (i < s.length()) s[i] = c; }
+
+    bool concat(const String &o) { s += o.s; return true; }
+    bool concat(const char *c) { if (c) s += c; return true; }
+    bool concat(char c) { s += c; return true; }
+    template<typename T> bool concat(T v) { s += String(v).s; return true; }
+    String &operator+=(const String &o) { concat(o); return *this; }
+    String &operator+=(const char *c) { concat(c); return *this; }
+    String &operator+=(char c) { concat(c); return *this; }
+    template<typename T> String &operator+=(T v) { concat(v); return *this; }
+
+    bool equals(const String &o) const { return s == o.s; }
+    bool equals(const char *c) const { return s == (c ? c : ""); }
+    bool equalsIgnoreCase(const String &o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+    bool operator==(const String &o) const { return s == o.s; }
+    bool operator==(const char *c) const { return equals(c); }
+    bool operator!=(const String &o) const { return s != o.s; }
+    bool operator!=(const char *c) const { return !equals(c); }
+    bool operator<(const String &o) const { return s < o.s; }
+    int compareTo(const String &o) const { return s.compare(o.s); }
+    bool startsWith(const String &p) const { return s.compare(0, p.s.length(), p.s) == 0; }
+    bool endsWith(const String &p) const { return s.length() >= p.s.length() && s.compare(s.length() - p.s.length(), p.s.length(), p.s) == 0; }
+
+    int indexOf(char c, unsigned from = 0) const { auto p = s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+    int indexOf(const String &str, unsigned from = 0) const { auto p = s.find(str.s, from); return p == std::string::npos ? -1 : (int)p; }
+    int lastIndexOf(char c) const { auto p = s.rfind(c); return p == std::string::npos ? -1 : (int)p; }
+    int lastIndexOf(const String &str) const { auto p = s.rfind(str.s); return p == std::string::npos ? -1 : (int)p; }
+    String substring(unsigned from) const { return from < s.length() ? String(s.substr(from)) : String(); }
+    String substring(unsigned from, unsigned to) const { if (to < from) std::swap(from, to); return from < s.length() ? String(s.substr(from, to - from)) : String(); }
+    void replace(const String &f, const String &r) { if (f.s.empty()) return; size_t p = 0; while ((p = s.find(f.s, p)) != std::string::npos) { s.replace(p, f.s.length(), r.s); p += r.s.length(); } }
+    void replace(char f, char r) { for (auto &c : s) if (c == f) c = r; }
+    void remove(unsigned idx) { if (idx < s.length()) s.erase(idx); }
+    void remove(unsigned idx, unsigned cnt) { if (idx < s.length()) s.erase(idx, cnt); }
+    void toLowerCase() { for (auto &c : s) c = tolower(c); }
+    void toUpperCase() { for (auto &c : s) c = toupper(c); }
+    void trim() { size_t b = s.find_first_not_of(" \t\r\n"); size_t e = s.find_last_not_of(" \t\r\n"); s = (b == std::string::npos) ? std::string() : s.substr(b, e - b + 1); }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return atof(s.c_str()); }
+    double toDouble() const { return atof(s.c_str()); }
+    void getBytes(unsigned char *buf, unsigned len, unsigned idx = 0) const { if (!len) return; unsigned n = 0; for (; n + 1 < len && idx + n < s.length(); n++) buf[n] = s[idx + n]; buf[n] = 0; }
+    void toCharArray(char *buf, unsigned len, unsigned idx = 0) const { getBytes((unsigned char *)buf, len, idx); }
+
+    friend String operator+(const String &a, const String &b) { String r(a); r += b; return r; }
+    friend String operator+(const String &a, const char *b) { String r(a); r += b; return r; }
+    friend String operator+(const char *a, const String &b) { String r(a); r += b; return r; }
+    template<typename T> friend String operator+(const String &a, T b) { String r(a); r += b; return r; }
+
+  private:
+    void fromULong(unsigned long v, unsigned base) {
+      char buf[72]; char *p = buf + sizeof(buf) - 1; *p = 0;
+      if (base < 2) base = 10;
+      do { unsigned d = v % base; *--p = d < 10 ? '0' + d : 'a' + d - 10; v /= base; } while (v);
+      s = p;
+    }
+    void fromDouble(double v, unsigned char decimals) { char buf[64]; snprintf(buf, sizeof(buf), "%.*f", decimals, v); s = buf; }
+};
+
+class StringSumHelper : public String {
+  public:
+    StringSumHelper(const String &s) : String(s) {}
+    StringSumHelper(const char *p) : String(p) {}
+};
+
@@ -0,0 +1,28 @@
+#pragma once
+// WiFi replacement for the host-native build: always disconnected
+#include <Arduino.h>
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } WiFiMode_t;
+#define WIFI_MODE_NULL WIFI_OFF
+#define WIFI_MODE_STA  WIFI_STA
+#define WIFI_MODE_AP   WIFI_AP
+#define WIFI_POWER_19_5dBm 78
+#define WIFI_POWER_8_5dBm  34
+typedef enum { WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL, WL_SCAN_COMPLETED, WL_CONNECTED, WL_CONNECT_FAILED, WL_CONNECTION_LOST, WL_DISCONNECTED } wl_status_t;
+
+typedef int WiFiEvent_t;
+
+class WiFiClass {
+  public:
+    wl_status_t status() { return WL_DISCONNECTED; }
+    bool isConnected() { return false; }
+    IPAddress localIP() { return IPAddress(); }
+    IPAddress softAPIP() { return IPAddress(); }
+    IPAddress subnetMask() { return IPAddress(); }
+    IPAddress gatewayIP() { return IPAddress(); }
+    String macAddress() { return String("00:00:00:00:00:00"); }
+    uint8_t *macAddress(uint8_t *mac) { for (int i = 0; i < 6; i++) mac[i] = 0; return mac; }
+    int32_t RSSI() { return 0; }
+    WiFiMode_t getMode() { return WIFI_OFF; }
+};
+extern WiFiClass WiFi;
@@ -0,0 +1,23 @@
+#pragma once
+// WiFiUDP replacement for the host-native build: packets are discarded
+#include <Arduino.h>
+
+class WiFiUDP : public Stream {
+  public:
+    uint8_t begin(uint16_t) { return 0; }
+    uint8_t beginMulticast(IPAddress, uint16_t) { return 0; }
+    void stop() {}
+    int beginPacket(IPAddress, uint16_t) { return 1; }
+    int beginPacket(const char *, uint16_t) { return 1; }
+    int beginMulticastPacket() { return 1; }
+    int endPacket() { return 1; }
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t *, size_t size) override { return size; }
+    using Print::write;
+    int parsePacket() { return 0; }
+    int read(unsigned char *, size_t) { return 0; }
+    int read(char *, size_t) { return 0; }
+    using Stream::read;
+    IPAddress remoteIP() { return IPAddress(); }
+    uint16_t remotePort() { return 0; }
+};
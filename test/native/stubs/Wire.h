@@ -0,0 +1,12 @@
+#pragma once
+// host-native build: I2C API used by the audioreactive ES7243/ES8388 codec setup (no devices, transmissions fail)
+#include <Arduino.h>
+
+class TwoWire {
+  public:
+    bool begin(int = -1, int = -1, uint32_t = 0) { return true; }
+    void beginTransmission(uint8_t) {}
+    size_t write(uint8_t) { return 1; }
+    uint8_t endTransmission(bool = true) { return 2; } // NACK on address
+};
+extern TwoWire Wire;
@@ -0,0 +1,14 @@
+#pragma once
+// host-native build: ADC driver API used by the audioreactive analog microphone (no ADC on the host)
+#include <stdint.h>
+
+typedef enum { ADC_UNIT_1 = 1, ADC_UNIT_2 = 2 } adc_unit_t;
+typedef enum { ADC_CHANNEL_0 = 0, ADC_CHANNEL_MAX = 10 } adc_channel_t;
+typedef enum { ADC1_CHANNEL_0 = 0, ADC1_CHANNEL_MAX = 8 } adc1_channel_t;
+typedef enum { ADC_ATTEN_DB_0 = 0, ADC_ATTEN_DB_2_5, ADC_ATTEN_DB_6, ADC_ATTEN_DB_11 } adc_atten_t;
+typedef enum { ADC_WIDTH_BIT_9 = 0, ADC_WIDTH_BIT_10, ADC_WIDTH_BIT_11, ADC_WIDTH_BIT_12 } adc_bits_width_t;
+
+inline int  adc_gpio_init(adc_unit_t, adc_channel_t) { return 0; }
+inline int  adc1_config_width(adc_bits_width_t) { return 0; }
+inline int  adc1_config_channel_atten(adc1_channel_t, adc_atten_t) { return 0; }
+inline int8_t digitalPinToAnalogChannel(uint8_t) { return -1; }
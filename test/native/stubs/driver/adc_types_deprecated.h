@@ -0,0 +1,3 @@
+#pragma once
+// host-native build: see driver/adc.h
+#include "adc.h"
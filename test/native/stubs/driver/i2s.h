@@ -0,0 +1,66 @@
+#pragma once
+// host-native build: legacy I2S driver API (IDF 4.4) used by the audioreactive audio sources.
+// There is no I2S hardware: driver calls fail, so I2S microphones never initialize on the host.
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_system.h"
+
+typedef int esp_err_t;
+#ifndef ESP_OK
+#define ESP_OK   0
+#define ESP_FAIL -1
+#endif
+#define ESP_INTR_FLAG_LEVEL1 (1<<1)
+#define ESP_INTR_FLAG_LEVEL2 (1<<2)
+
+#define SOC_I2S_NUM 2
+#define SOC_I2S_SUPPORTS_PDM_RX 1
+#define SOC_I2S_SUPPORTS_APLL 1
+#define SOC_I2S_SUPPORTS_ADC 1
+
+#define I2S_PIN_NO_CHANGE (-1)
+
+typedef enum { I2S_NUM_0 = 0, I2S_NUM_1 = 1, I2S_NUM_MAX } i2s_port_t;
+typedef enum { I2S_MODE_MASTER = 1, I2S_MODE_SLAVE = 2, I2S_MODE_TX = 4, I2S_MODE_RX = 8, I2S_MODE_DAC_BUILT_IN = 16, I2S_MODE_ADC_BUILT_IN = 32, I2S_MODE_PDM = 64 } i2s_mode_t;
+typedef enum { I2S_BITS_PER_SAMPLE_8BIT = 8, I2S_BITS_PER_SAMPLE_16BIT = 16, I2S_BITS_PER_SAMPLE_24BIT = 24, I2S_BITS_PER_SAMPLE_32BIT = 32 } i2s_bits_per_sample_t;
+typedef enum { I2S_BITS_PER_CHAN_DEFAULT = 0, I2S_BITS_PER_CHAN_8BIT = 8, I2S_BITS_PER_CHAN_16BIT = 16, I2S_BITS_PER_CHAN_24BIT = 24, I2S_BITS_PER_CHAN_32BIT = 32 } i2s_bits_per_chan_t;
+typedef enum { I2S_CHANNEL_MONO = 1, I2S_CHANNEL_STEREO = 2 } i2s_channel_t;
+typedef enum { I2S_CHANNEL_FMT_RIGHT_LEFT, I2S_CHANNEL_FMT_ALL_RIGHT, I2S_CHANNEL_FMT_ALL_LEFT, I2S_CHANNEL_FMT_ONLY_RIGHT, I2S_CHANNEL_FMT_ONLY_LEFT, I2S_CHANNEL_FMT_MULTIPLE } i2s_channel_fmt_t;
+typedef enum { I2S_COMM_FORMAT_STAND_I2S = 1, I2S_COMM_FORMAT_STAND_MSB = 3, I2S_COMM_FORMAT_I2S = 1, I2S_COMM_FORMAT_I2S_MSB = 1 } i2s_comm_format_t;
+
+typedef struct {
+  i2s_mode_t mode;
+  uint32_t sample_rate;
+  i2s_bits_per_sample_t bits_per_sample;
+  i2s_channel_fmt_t channel_format;
+  i2s_comm_format_t communication_format;
+  int intr_alloc_flags;
+  int dma_buf_count;
+  int dma_buf_len;
+  bool use_apll;
+  bool tx_desc_auto_clear;
+  int fixed_mclk;
+  int mclk_multiple;
+  i2s_bits_per_chan_t bits_per_chan;
+} i2s_config_t;
+
+typedef struct {
+  int mck_io_num;
+  int bck_io_num;
+  int ws_io_num;
+  int data_out_num;
+  int data_in_num;
+} i2s_pin_config_t;
+
+#include "adc.h"
+
+inline esp_err_t i2s_driver_install(i2s_port_t, const i2s_config_t *, int, void *) { return ESP_FAIL; }
+inline esp_err_t i2s_driver_uninstall(i2s_port_t) { return ESP_OK; }
+inline esp_err_t i2s_set_pin(i2s_port_t, const i2s_pin_config_t *) { return ESP_FAIL; }
+inline esp_err_t i2s_set_clk(i2s_port_t, uint32_t, uint32_t, i2s_channel_t) { return ESP_FAIL; }
+inline esp_err_t i2s_read(i2s_port_t, void *, size_t, size_t *bytes_read, uint32_t) { *bytes_read = 0; return ESP_FAIL; }
+inline esp_err_t i2s_start(i2s_port_t) { return ESP_OK; }
+inline esp_err_t i2s_stop(i2s_port_t) { return ESP_OK; }
+inline esp_err_t i2s_set_adc_mode(adc_unit_t, adc1_channel_t) { return ESP_FAIL; }
+inline esp_err_t i2s_adc_enable(i2s_port_t) { return ESP_FAIL; }
+inline esp_err_t i2s_adc_disable(i2s_port_t) { return ESP_OK; }
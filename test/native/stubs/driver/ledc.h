@@ -0,0 +1,4 @@
+#pragma once
+// host-native build: LEDC channel counts of the classic ESP32
+#define LEDC_CHANNEL_MAX 8
+#define LEDC_SPEED_MODE_MAX 2
@@ -0,0 +1,4 @@
+#pragma once
+// host-native build
+#include <stdint.h>
+uint64_t esp_rtc_get_time_us();
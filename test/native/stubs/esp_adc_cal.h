@@ -0,0 +1,9 @@
+#pragma once
+// host-native build: no ADC calibration data
+#include <stdint.h>
+#include <string.h>
+typedef enum { ADC_UNIT_1 = 1 } adc_unit_t;
+typedef enum { ADC_ATTEN_DB_11 = 3 } adc_atten_t;
+typedef enum { ADC_WIDTH_BIT_12 = 3, ADC_WIDTH_BIT_13 = 4 } adc_bits_width_t;
+typedef struct { uint32_t coeff_a; uint32_t coeff_b; const uint32_t *low_curve; const uint32_t *high_curve; } esp_adc_cal_characteristics_t;
+inline int esp_adc_cal_characterize(adc_unit_t, adc_atten_t, adc_bits_width_t, uint32_t, esp_adc_cal_characteristics_t *c) { memset(c, 0, sizeof(*c)); return 0; }
@@ -0,0 +1,3 @@
+#pragma once
+// host-native build
+#include "esp_system.h"
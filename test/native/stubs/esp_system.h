@@ -0,0 +1,19 @@
+#pragma once
+// ESP-IDF system API subset for the host-native build
+#include <stdint.h>
+#include <string.h>
+
+#define ESP_IDF_VERSION_VAL(major, minor, patch) ((major << 16) | (minor << 8) | (patch))
+#define ESP_IDF_VERSION ESP_IDF_VERSION_VAL(4, 4, 4)
+
+// emulated address range for heap_caps_* allocations (every host allocation counts as DRAM)
+#define SOC_DRAM_LOW  ((uintptr_t)0)
+#define SOC_DRAM_HIGH UINTPTR_MAX
+
+typedef enum { ESP_RST_UNKNOWN, ESP_RST_POWERON, ESP_RST_EXT, ESP_RST_SW, ESP_RST_PANIC, ESP_RST_INT_WDT,
+               ESP_RST_TASK_WDT, ESP_RST_WDT, ESP_RST_DEEPSLEEP, ESP_RST_BROWNOUT, ESP_RST_SDIO } esp_reset_reason_t;
+inline esp_reset_reason_t esp_reset_reason() { return ESP_RST_POWERON; }
+
+typedef struct { int model; uint32_t features; uint16_t full_revision; uint8_t cores; uint8_t revision; } esp_chip_info_t;
+inline void esp_chip_info(esp_chip_info_t *info) { memset(info, 0, sizeof(*info)); info->cores = 2; }
+inline int esp_efuse_mac_get_default(uint8_t *mac) { memset(mac, 0, 6); return 0; }
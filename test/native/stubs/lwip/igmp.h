@@ -0,0 +1,3 @@
+#pragma once
+// host-native build
+#include "ip_addr.h"
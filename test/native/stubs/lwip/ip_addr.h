@@ -0,0 +1,6 @@
+#pragma once
+// host-native build
+#include <stdint.h>
+typedef struct { uint32_t addr; } ip4_addr_t;
+typedef ip4_addr_t ip_addr_t;
+#define LWIP_VERSION_MAJOR 2
@@ -0,0 +1,112 @@
+/*
+ * BusManager replacement for the host-native build.
+ *
+ * Every configured output becomes a BusNative that keeps its pixels in RAM, so
+ * WS2812FX::show() runs its full path (mapping, CCT, bus hand-off) without hardware.
+ */
+#include "wled.h"
+
+class BusNative : public Bus {
+  public:
+    BusNative(const BusConfig &bc)
+    : Bus(bc.type, bc.start, bc.autoWhite, bc.count, bc.reversed, bc.refreshReq)
+    , _data(bc.count, 0)
+    {
+      _hasRgb   = hasRGB(bc.type);
+      _hasWhite = hasWhite(bc.type);
+      _hasCCT   = hasCCT(bc.type);
+      _valid    = true;
+    }
+
+    void     show() override                                 { _frames++; }
+    void     setPixelColor(unsigned pix, uint32_t c) override { if (pix < _len) _data[_reversed ? _len - pix - 1 : pix] = c; }
+    void     setPixels(unsigned pix, unsigned count, const uint32_t *c) override {
+      if (_reversed) Bus::setPixels(pix, count, c);
+      else           std::copy(c, c + count, _data.begin() + pix);
+    }
+    uint32_t getPixelColor(unsigned pix) const override       { return pix < _len ? _data[_reversed ? _len - pix - 1 : pix] : 0; }
+    size_t   getBusSize() const override                      { return sizeof(BusNative) + _len * sizeof(uint32_t); }
+
+  private:
+    std::vector<uint32_t> _data;
+    unsigned _frames = 0;
+};
+
+int16_t Bus::_cct = -1;
+uint8_t Bus::_cctBlend = 0;
+uint8_t Bus::_gAWM = 255;
+
+void Bus::calculateCCT(uint32_t c, uint8_t &ww, uint8_t &cw) {
+  unsigned cct = 127; // neutral white when no CCT is set
+  if (_cct > -1) cct = _cct > 255 ? ((_cct - 1900) >> 5) : _cct;
+  cw = cct > 255 ? 255 : cct;
+  ww = 255 - cw;
+}
+
+uint32_t Bus::autoWhiteCalc(uint32_t c) const { return c; }
+
+size_t BusConfig::memUsage(unsigned nr) const { return sizeof(BusNative) + count * sizeof(uint32_t); }
+
+std::vector<std::unique_ptr<Bus>> BusManager::busses;
+uint16_t BusManager::_gMilliAmpsUsed = 0;
+uint16_t BusManager::_gMilliAmpsMax = ABL_MILLIAMPS_DEFAULT;
+bool     BusManager::_useABL = false;
+
+size_t BusManager::memUsage() {
+  size_t size = 0;
+  for (const auto &bus : busses) size += bus->getBusSize();
+  return size;
+}
+
+void BusManager::initializeABL() { _useABL = false; }
+void BusManager::applyABL()      {}
+void BusManager::useParallelOutput() {}
+bool BusManager::hasParallelOutput() { return false; }
+void BusManager::removeAll()     { busses.clear(); }
+void BusManager::on()            {}
+void BusManager::off()           {}
+
+int BusManager::add(const BusConfig &bc) {
+  busses.push_back(make_unique<BusNative>(bc));
+  return busses.size();
+}
+
+void BusManager::setPixelColor(unsigned pix, uint32_t c) {
+  for (auto &bus : busses) {
+    if (!bus->containsPixel(pix)) continue;
+    bus->setPixelColor(pix - bus->getStart(), c);
+  }
+}
+
+void BusManager::setPixels(unsigned pix, unsigned count, const uint32_t *c) {
+  const unsigned end = pix + count;
+  for (auto &bus : busses) {
+    const unsigned bStart = bus->getStart();
+    const unsigned from   = max(pix, bStart);
+    const unsigned to     = min(end, bStart + bus->getLength());
+    if (from < to) bus->setPixels(from - bStart, to - from, c + (from - pix));
+  }
+}
+
+uint32_t BusManager::getPixelColor(unsigned pix) {
+  for (auto &bus : busses) {
+    if (!bus->containsPixel(pix)) continue;
+    return bus->getPixelColor(pix - bus->getStart());
+  }
+  return 0;
+}
+
+void BusManager::show() {
+  _gMilliAmpsUsed = 0;
+  for (auto &bus : busses) bus->show();
+}
+
+bool BusManager::canAllShow() { return true; }
+
+void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
+  if (cct > 255) cct = 255;
+  if (cct >= 0) {
+    if (allowWBCorrection) cct = 1900 + (cct << 5);
+  } else cct = -1;
+  Bus::setCCT(cct);
+}
@@ -0,0 +1,256 @@
+/*
+ * Out-of-line parts of the FastLED subset used by the host-native build.
+ * Algorithms follow FastLED 3.x (hsv2rgb.cpp, colorutils.cpp, colorpalettes.cpp).
+ */
+#include "FastLED.h"
+
+uint16_t rand16seed = 1337;
+CFastLED FastLED;
+
+#define K255 255
+#define K171 171
+#define K170 170
+#define K85  85
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb) {
+  uint8_t hue = hsv.hue;
+  uint8_t sat = hsv.sat;
+  uint8_t val = hsv.val;
+
+  uint8_t offset  = hue & 0x1F; // 0..31
+  uint8_t offset8 = offset << 3;
+  uint8_t third   = scale8(offset8, (256 / 3)); // max = 85
+  uint8_t r, g, b;
+
+  if (!(hue & 0x80)) {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) { r = K255 - third; g = third; b = 0; }                         // R -> O
+      else               { r = K171; g = K85 + third; b = 0; }                           // O -> Y
+    } else {
+      if (!(hue & 0x20)) { uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); r = K171 - twothirds; g = K170 + third; b = 0; } // Y -> G
+      else               { r = 0; g = K255 - third; b = third; }                         // G -> A
+    }
+  } else {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) { r = 0; uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); g = K171 - twothirds; b = K85 + twothirds; } // A -> B
+      else               { r = third; g = 0; b = K255 - third; }                         // B -> P
+    } else {
+      if (!(hue & 0x20)) { r = K85 + third; g = 0; b = K171 - third; }                   // P -> K
+      else               { r = K170 + third; g = 0; b = K85 - third; }                   // K -> R
+    }
+  }
+
+  if (sat != 255) {
+    if (sat == 0) {
+      r = 255; b = 255; g = 255;
+    } else {
+      uint8_t desat = 255 - sat;
+      desat = scale8_video(desat, desat);
+      uint8_t satscale = 255 - desat;
+      if (r) r = scale8(r, satscale) + 1;
+      if (g) g = scale8(g, satscale) + 1;
+      if (b) b = scale8(b, satscale) + 1;
+      r += desat; g += desat; b += desat;
+    }
+  }
+
+  if (val != 255) {
+    val = scale8_video(val, val);
+    if (val == 0) {
+      r = 0; g = 0; b = 0;
+    } else {
+      if (r) r = scale8(r, val) + 1;
+      if (g) g = scale8(g, val) + 1;
+      if (b) b = scale8(b, val) + 1;
+    }
+  }
+
+  rgb.r = r; rgb.g = g; rgb.b = b;
+}
+
+void hsv2rgb_spectrum(const CHSV &hsv, CRGB &rgb) {
+  // "raw" spectrum: hue 0-191 mapped onto 3 equal sections
+  uint8_t hue = scale8(hsv.hue, 191);
+  uint8_t value = hsv.val;
+  uint8_t invsat = 255 - hsv.sat;
+  uint8_t brightness_floor = (value * invsat) / 256;
+  uint8_t color_amplitude = value - brightness_floor;
+  uint8_t section = hue / 0x40;
+  uint8_t offset = hue % 0x40;
+  uint8_t rampup = offset;
+  uint8_t rampdown = (0x40 - 1) - offset;
+  uint8_t rampup_amp_adj   = (rampup   * color_amplitude) / (256 / 4);
+  uint8_t rampdown_amp_adj = (rampdown * color_amplitude) / (256 / 4);
+  uint8_t rampup_adj_with_floor   = rampup_amp_adj   + brightness_floor;
+  uint8_t rampdown_adj_with_floor = rampdown_amp_adj + brightness_floor;
+
+  if (section) {
+    if (section == 1) { rgb.r = brightness_floor; rgb.g = rampdown_adj_with_floor; rgb.b = rampup_adj_with_floor; }
+    else              { rgb.r = rampup_adj_with_floor; rgb.g = brightness_floor; rgb.b = rampdown_adj_with_floor; }
+  } else {
+    rgb.r = rampdown_adj_with_floor; rgb.g = rampup_adj_with_floor; rgb.b = brightness_floor;
+  }
+}
+
+#define FIXFRAC8(N,D) (((N)*256)/(D))
+
+CHSV rgb2hsv_approximate(const CRGB &rgb) {
+  uint8_t r = rgb.r;
+  uint8_t g = rgb.g;
+  uint8_t b = rgb.b;
+  uint8_t h, s, v;
+
+  // find desaturation
+  uint8_t desat = 255;
+  if (r < desat) desat = r;
+  if (g < desat) desat = g;
+  if (b < desat) desat = b;
+
+  // remove saturation from all channels
+  r -= desat; g -= desat; b -= desat;
+
+  s = 255 - desat;
+  if (s != 255) s = 255 - sqrt16((255 - s) * 256);
+
+  if ((r + g + b) == 0) return CHSV(0, 0, 255 - s);
+
+  // scale all channels up to compensate for desaturation
+  if (s < 255) {
+    if (s == 0) s = 1;
+    uint32_t scaleup = 65535 / s;
+    r = ((uint32_t)r * scaleup) / 256;
+    g = ((uint32_t)g * scaleup) / 256;
+    b = ((uint32_t)b * scaleup) / 256;
+  }
+
+  uint16_t total = r + g + b;
+  if (total < 255) {
+    if (total == 0) total = 1;
+    uint32_t scaleup = 65535 / total;
+    r = ((uint32_t)r * scaleup) / 256;
+    g = ((uint32_t)g * scaleup) / 256;
+    b = ((uint32_t)b * scaleup) / 256;
+  }
+
+  if (total > 255) v = 255;
+  else {
+    v = qadd8(desat, total);
+    if (v != 255) v = sqrt16(v * 256);
+  }
+
+  uint8_t highest = r;
+  if (g > highest) highest = g;
+  if (b > highest) highest = b;
+
+  if (highest == r) {
+    if (g == 0)      { h = (HUE_PURPLE + HUE_PINK) / 2; h += scale8(qsub8(r, 128), FIXFRAC8(48,128)); }
+    else if ((r - g) > g) { h = HUE_RED; h += scale8(g, FIXFRAC8(32,85)); }
+    else             { h = HUE_ORANGE; h += scale8(qsub8((g - 85) + (171 - r), 4), FIXFRAC8(32,85)); }
+  } else if (highest == g) {
+    if (b == 0)      { h = HUE_YELLOW; uint8_t radj = scale8(qsub8(171, r), 47); uint8_t gadj = scale8(qsub8(g, 171), 96); uint8_t rgadj = radj + gadj; uint8_t hueadv = rgadj / 2; h += hueadv; }
+    else             { if ((g - b) > b) { h = HUE_GREEN; h += scale8(b, FIXFRAC8(32,85)); } else { h = HUE_AQUA; h += scale8(qsub8(b, 85), FIXFRAC8(8,42)); } }
+  } else {
+    if (r == 0)      { h = HUE_AQUA + ((HUE_BLUE - HUE_AQUA) / 4); h += scale8(qsub8(b, 128), FIXFRAC8(24,128)); }
+    else if ((b - r) > r) { h = HUE_BLUE; h += scale8(r, FIXFRAC8(32,85)); }
+    else             { h = HUE_PURPLE; h += scale8(qsub8(r, 85), FIXFRAC8(32,85)); }
+  }
+
+  h += 1;
+  return CHSV(h, s, v);
+}
+
+CRGB HeatColor(uint8_t temperature) {
+  CRGB heatcolor;
+  uint8_t t192 = scale8_video(temperature, 191);
+  uint8_t heatramp = t192 & 0x3F; // 0..63
+  heatramp <<= 2;                 // scale up to 0..252
+  if (t192 & 0x80)      { heatcolor.r = 255; heatcolor.g = 255; heatcolor.b = heatramp; } // hottest
+  else if (t192 & 0x40) { heatcolor.r = 255; heatcolor.g = heatramp; heatcolor.b = 0; }  // middle
+  else                  { heatcolor.r = heatramp; heatcolor.g = 0; heatcolor.b = 0; }    // coolest
+  return heatcolor;
+}
+
+CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness, TBlendType blendType) {
+  uint8_t hi4 = index >> 4;
+  uint8_t lo4 = index & 0x0F;
+  CRGB entry = pal.entries[hi4];
+  if (lo4 && blendType != NOBLEND) {
+    const CRGB &next = (hi4 == 15) ? pal.entries[0] : pal.entries[hi4 + 1];
+    uint8_t f2 = lo4 << 4;
+    uint8_t f1 = 255 - f2;
+    entry.r = scale8(entry.r, f1) + scale8(next.r, f2);
+    entry.g = scale8(entry.g, f1) + scale8(next.g, f2);
+    entry.b = scale8(entry.b, f1) + scale8(next.b, f2);
+  }
+  if (brightness != 255) entry.nscale8_video(brightness);
+  return entry;
+}
+
+void nblendPaletteTowardPalette(CRGBPalette16 &current, CRGBPalette16 &target, uint8_t maxChanges) {
+  uint8_t *p1 = (uint8_t *)current.entries;
+  uint8_t *p2 = (uint8_t *)target.entries;
+  const uint8_t totalChannels = sizeof(CRGBPalette16);
+  uint8_t changes = 0;
+  for (uint8_t i = 0; i < totalChannels; ++i) {
+    if (p1[i] == p2[i]) continue;
+    if (p1[i] < p2[i]) { ++p1[i]; ++changes; }
+    if (p1[i] > p2[i]) { --p1[i]; ++changes; if (p1[i] > p2[i]) --p1[i]; }
+    if (changes >= maxChanges) break;
+  }
+}
+
+extern const TProgmemRGBPalette16 CloudColors_p = {
+  CRGB::Blue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue,
+  CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue,
+  CRGB::Blue, CRGB::DarkBlue, CRGB::SkyBlue, CRGB::SkyBlue,
+  CRGB::LightBlue, CRGB::White, CRGB::LightBlue, CRGB::SkyBlue
+};
+
+extern const TProgmemRGBPalette16 LavaColors_p = {
+  CRGB::Black, CRGB::Maroon, CRGB::Black, CRGB::Maroon,
+  CRGB::DarkRed, CRGB::DarkRed, CRGB::Maroon, CRGB::DarkRed,
+  CRGB::DarkRed, CRGB::DarkRed, CRGB::Red, CRGB::Orange,
+  CRGB::White, CRGB::Orange, CRGB::Red, CRGB::DarkRed
+};
+
+extern const TProgmemRGBPalette16 OceanColors_p = {
+  CRGB::MidnightBlue, CRGB::DarkBlue, CRGB::MidnightBlue, CRGB::Navy,
+  CRGB::DarkBlue, CRGB::MediumBlue, CRGB::SeaGreen, CRGB::Teal,
+  CRGB::CadetBlue, CRGB::Blue, CRGB::DarkCyan, CRGB::CornflowerBlue,
+  CRGB::Aquamarine, CRGB::SeaGreen, CRGB::Aqua, CRGB::LightSkyBlue
+};
+
+extern const TProgmemRGBPalette16 ForestColors_p = {
+  CRGB::DarkGreen, CRGB::DarkGreen, CRGB::DarkOliveGreen, CRGB::DarkGreen,
+  CRGB::Green, CRGB::ForestGreen, CRGB::OliveDrab, CRGB::Green,
+  CRGB::SeaGreen, CRGB::MediumAquamarine, CRGB::LimeGreen, CRGB::YellowGreen,
+  CRGB::LightGreen, CRGB::LawnGreen, CRGB::MediumAquamarine, CRGB::ForestGreen
+};
+
+extern const TProgmemRGBPalette16 RainbowColors_p = {
+  0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00,
+  0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+  0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5,
+  0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B
+};
+
+extern const TProgmemRGBPalette16 RainbowStripeColors_p = {
+  0xFF0000, 0x000000, 0xAB5500, 0x000000,
+  0xABAB00, 0x000000, 0x00FF00, 0x000000,
+  0x00AB55, 0x000000, 0x0000FF, 0x000000,
+  0x5500AB, 0x000000, 0xAB0055, 0x000000
+};
+
+extern const TProgmemRGBPalette16 PartyColors_p = {
+  0x5500AB, 0x84007C, 0xB5004B, 0xE5001B,
+  0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+  0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E,
+  0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9
+};
+
+extern const TProgmemRGBPalette16 HeatColors_p = {
+  0x000000, 0x330000, 0x660000, 0x990000,
+  0xCC0000, 0xFF0000, 0xFF3300, 0xFF6600,
+  0xFF9900, 0xFFCC00, 0xFFFF00, 0xFFFF33,
+  0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF
+};
@@ -0,0 +1,40 @@
+/*
+ * LittleFS replacement for the host-native build. WLED paths ("/presets.json", "/ledmap1.json", ...)
+ * are resolved relative to $WLED_FS_ROOT (or the current directory if unset).
+ */
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "LittleFS.h"
+
+fs::FS LittleFS;
+
+static std::string hostPath(const char *path) {
+  const char *root = getenv("WLED_FS_ROOT");
+  std::string p = root ? root : ".";
+  if (path[0] != '/') p += '/';
+  return p + path;
+}
+
+namespace fs {
+
+File FS::open(const char *path, const char *mode) {
+  std::string p = hostPath(path);
+  // Arduino modes do not distinguish binary/text ("r+" is used by writeObjectToFile())
+  const bool update = mode[1] == '+';
+  const char *m = mode[0] == 'w' ? "w+b" : mode[0] == 'a' ? "a+b" : update ? "r+b" : "rb";
+  struct stat st;
+  if (mode[0] == 'r' && (stat(p.c_str(), &st) != 0 || S_ISDIR(st.st_mode))) return File();
+  FILE *f = fopen(p.c_str(), m);
+  return f ? File(f, path) : File();
+}
+
+bool FS::exists(const char *path) {
+  struct stat st;
+  return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path) { return ::remove(hostPath(path).c_str()) == 0; }
+
+bool FS::rename(const char *from, const char *to) { return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0; }
+
+} // namespace fs
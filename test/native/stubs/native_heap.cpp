@@ -0,0 +1,97 @@
+/*
+ * heap_caps_* replacement for the host-native build.
+ *
+ * Every block carries a small header with its size so the benchmark runner can report
+ * current and peak usage of the memory WLED allocates through d_malloc()/p_malloc()/allocate_buffer().
+ * The heap is modelled as a single pool of NATIVE_HEAP_SIZE bytes (ESP32 class DRAM by default)
+ * so that allocation limits in util.cpp behave like they do on the device.
+ */
+#include <stdarg.h>
+#include "Arduino.h"
+
+#ifndef NATIVE_HEAP_SIZE
+  #define NATIVE_HEAP_SIZE (320*1024)
+#endif
+
+static size_t heapUsed = 0;
+static size_t heapPeak = 0;
+static size_t heapAllocs = 0;
+
+struct alignas(16) BlockHeader { size_t size; };
+
+static void *track(BlockHeader *hdr, size_t size) {
+  if (!hdr) return nullptr;
+  hdr->size = size;
+  heapUsed += size;
+  heapAllocs++;
+  if (heapUsed > heapPeak) heapPeak = heapUsed;
+  return hdr + 1;
+}
+
+static BlockHeader *header(void *ptr) { return static_cast<BlockHeader*>(ptr) - 1; }
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+  if ((caps & MALLOC_CAP_SPIRAM) || heapUsed + size > NATIVE_HEAP_SIZE) return nullptr; // no PSRAM on host
+  return track(static_cast<BlockHeader*>(malloc(sizeof(BlockHeader) + size)), size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+  void *ptr = heap_caps_malloc(n * size, caps);
+  if (ptr) memset(ptr, 0, n * size);
+  return ptr;
+}
+
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps) {
+  if (!ptr) return heap_caps_malloc(size, caps);
+  if (!size) { heap_caps_free(ptr); return nullptr; }
+  BlockHeader *hdr = header(ptr);
+  size_t old = hdr->size;
+  if ((caps & MALLOC_CAP_SPIRAM) || heapUsed - old + size > NATIVE_HEAP_SIZE) return nullptr;
+  BlockHeader *n = static_cast<BlockHeader*>(realloc(hdr, sizeof(BlockHeader) + size));
+  if (!n) return nullptr;
+  heapUsed -= old;
+  return track(n, size);
+}
+
+void heap_caps_free(void *ptr) {
+  if (!ptr) return;
+  BlockHeader *hdr = header(ptr);
+  heapUsed -= hdr->size;
+  free(hdr);
+}
+
+// try each capability in turn, like ESP-IDF does
+void *heap_caps_malloc_prefer(size_t size, size_t num, ...) {
+  va_list args;
+  va_start(args, num);
+  void *ptr = nullptr;
+  while (num-- && !ptr) ptr = heap_caps_malloc(size, va_arg(args, uint32_t));
+  va_end(args);
+  return ptr;
+}
+
+void *heap_caps_calloc_prefer(size_t n, size_t size, size_t num, ...) {
+  va_list args;
+  va_start(args, num);
+  void *ptr = nullptr;
+  while (num-- && !ptr) ptr = heap_caps_calloc(n, size, va_arg(args, uint32_t));
+  va_end(args);
+  return ptr;
+}
+
+void *heap_caps_realloc_prefer(void *p, size_t size, size_t num, ...) {
+  va_list args;
+  va_start(args, num);
+  void *ptr = nullptr;
+  while (num-- && !ptr) ptr = heap_caps_realloc(p, size, va_arg(args, uint32_t));
+  va_end(args);
+  return ptr;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)          { return (caps & MALLOC_CAP_SPIRAM) ? 0 : NATIVE_HEAP_SIZE - heapUsed; }
+size_t heap_caps_get_largest_free_block(uint32_t caps) { return heap_caps_get_free_size(caps); }
+
+size_t nativeHeapUsed()     { return heapUsed; }
+size_t nativeHeapPeak()     { return heapPeak; }
+void   nativeHeapResetPeak() { heapPeak = heapUsed; }
+size_t nativeHeapAllocs()   { return heapAllocs; }
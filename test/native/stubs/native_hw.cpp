@@ -0,0 +1,50 @@
+/*
+ * Host-native replacements for the Arduino/ESP32 runtime: clock, RNG, Serial and friends.
+ *
+ * millis()/micros() follow the host's monotonic clock plus an offset that can be advanced
+ * with nativeAdvanceMillis(). The benchmark runner uses this to step WS2812FX::service()
+ * frame by frame without actually sleeping.
+ */
+#include <chrono>
+#include <thread>
+#include "Arduino.h"
+#include "WiFi.h"
+#include "Update.h"
+#include "Wire.h"
+#include "esp32/rtc.h"
+#include "soc/wdev_reg.h"
+
+HardwareSerial Serial;
+EspClass       ESP;
+WiFiClass      WiFi;
+UpdateClass    Update;
+TwoWire        Wire;
+
+static const auto     bootTime   = std::chrono::steady_clock::now();
+static uint64_t       usOffset   = 0;  // virtual time added by nativeAdvanceMillis()
+static uint32_t       rngState   = 0x2545F491;
+
+static uint64_t hostMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long millis() { return (unsigned long)(uint32_t)((hostMicros() + usOffset) / 1000ULL); }
+unsigned long micros() { return (unsigned long)(uint32_t)(hostMicros() + usOffset); }
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void delayMicroseconds(unsigned int us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+void nativeAdvanceMillis(unsigned long ms) { usOffset += 1000ULL * ms; }
+
+uint64_t esp_rtc_get_time_us() { return hostMicros() + usOffset; }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(hostMicros() * 240); }
+
+// xorshift32, deterministic so benchmark runs are reproducible
+uint32_t native_hw_rng() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+void randomSeed(unsigned long seed) { if (seed) rngState = seed; }
+long random(long howbig) { return howbig ? native_hw_rng() % howbig : 0; }
+long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
@@ -0,0 +1,20 @@
+/*
+ * WLED globals and the few functions from non-FX translation units that the FX engine calls.
+ * Only the effect engine is built for the host; networking, UI and LED drivers are left out.
+ */
+#define WLED_DEFINE_GLOBAL_VARS
+#include "wled.h"
+
+// led.cpp
+byte scaledBri(byte in) {
+  unsigned val = ((unsigned)in*briMultiplier)/100;
+  if (val > 255) val = 255;
+  return (byte)val;
+}
+
+// presets.cpp
+const char *getPresetsFileName(bool persistent) { return persistent ? "/presets.json" : "/tmp.json"; }
+
+// e131.cpp / ESPAsyncE131.cpp (no network on host)
+void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol) {}
+ESPAsyncE131::ESPAsyncE131(e131_packet_callback_function callback) { _callback = callback; }
@@ -0,0 +1,9 @@
+#pragma once
+// host-native build: I2S registers touched by the SPH0645 timing workaround (writes are ignored)
+#define I2S_TIMING_REG(i) (i)
+#define I2S_CONF_REG(i)   (i)
+#define I2S_RX_MSB_SHIFT  (1 << 17)
+#ifndef BIT
+#define BIT(n) (1UL << (n))
+#endif
+#define REG_SET_BIT(reg, bit) ((void)(reg), (void)(bit))
@@ -0,0 +1,6 @@
+#pragma once
+// host-native build: hardware RNG register is emulated by a deterministic PRNG (see native_hw.cpp)
+#include <stdint.h>
+uint32_t native_hw_rng();
+#define WDEV_RND_REG 0
+#define REG_READ(reg) native_hw_rng()
@@ -0,0 +1,802 @@
+#pragma once
+/*
+ * FFT processing of one batch of audio samples: band-pass filter, FFT, mapping of the FFT bins
+ * to the GEQ channels and post-processing of the channels (pink noise adjustment, gain, smoothing, scaling).
+ *
+ * FFT backends (compile time, FFTBackend):
+ *   Radix4FFTBackend<float>    default - real FFT via a 256 point complex radix-4 FFT with precomputed window and twiddle tables
+ *   Radix4FFTBackend<int32_t>  same in fixed point, default on MCUs without FPU (-S2, -C3)
+ *   ArduinoFFTBackend          kosme/arduinoFFT as before, -D UM_AUDIOREACTIVE_USE_ARDUINOFFT
+ * GEQ bands: the FFT result bins are mapped to 16 (default, hand-tuned layout), 24 or 32 bands through a table of bin ranges
+ * and weights that is built when the band settings change (log-spaced between min and max frequency for 24/32 bands).
+ * The classic 16 channel fftResult[] is always provided as well (downmixed from the bands), for effects and audio sync.
+ * detectBeats() finds onsets and the tempo / beat phase in the FFT result bins of each batch (samplePeak, BPM for effects).
+ *
+ * The FFT window slides by samplesFFT/2 samples per batch (50% overlap), halving the GEQ latency. The radix-4 backend
+ * needs less than half the time of ArduinoFFT, so the CPU load stays the same. -D UM_AUDIOREACTIVE_FFT_NO_OVERLAP
+ * goes back to one batch per 512 new samples. The usermod turns overlap off for the analog I2S ADC source, which does
+ * not sample between reads (unless I2S_GRAB_ADC1_COMPLETELY is set).
+ *
+ * The functions only work on the FFTState/FFTSettings/FFTResults passed to them (no usermod globals, no I2S),
+ * so the same code runs in the FFT task of the audioreactive usermod and in the host-native audio benchmark
+ * (test/native/audio_bench) which checks the GEQ output of a revision against golden files.
+ */
+
+#include <type_traits>
+#ifdef UM_AUDIOREACTIVE_USE_ARDUINOFFT
+#include <arduinoFFT.h>
+#endif
+
+#ifndef NUM_GEQ_CHANNELS
+#define NUM_GEQ_CHANNELS 16                                           // number of frequency channels. Don't change !!
+#endif
+#ifndef MAX_GEQ_BANDS
+#define MAX_GEQ_BANDS 32                                              // maximum number of bands of the configurable GEQ layout
+#endif
+
+// FFT Constants
+constexpr uint16_t samplesFFT = 512;            // Samples in an FFT batch - This value MUST ALWAYS be a power of 2
+constexpr uint16_t samplesFFT_2 = 256;          // meaningfull part of FFT results - only the "lower half" contains useful information.
+#ifndef UM_AUDIOREACTIVE_FFT_NO_OVERLAP
+#define FFT_OVERLAP true                        // FFT window moves by half its size per batch
+#else
+#define FFT_OVERLAP false
+#endif
+// the following are observed values, supported by a bit of "educated guessing"
+//#define FFT_DOWNSCALE 0.65f                             // 20kHz - downscaling factor for FFT results - "Flat-Top" window @20Khz, old freq channels
+#define FFT_DOWNSCALE 0.46f                             // downscaling factor for FFT results - for "Flat-Top" window @22Khz, new freq channels
+#define LOG_256  5.54517744f                            // log(256)
+
+// Table of multiplication factors so that we can even out the frequency response.
+static const float fftResultPink[NUM_GEQ_CHANNELS] = { 1.70f, 1.71f, 1.73f, 1.78f, 1.68f, 1.56f, 1.55f, 1.63f, 1.79f, 1.62f, 1.80f, 2.06f, 2.47f, 3.35f, 6.83f, 9.55f };
+
+// smoothing per batch {weight of new value, weight of old value} - tuned for one batch every 23ms (512 samples @ 22kHz),
+// the second set is the same filter for a batch every 11.6ms (overlap): new' = 1 - sqrt(1 - new)
+static const float fftSmoothRise[2][2] = { {0.75f, 0.25f}, {0.5f, 0.5f} };                 // rise fast
+static const float fftSmoothFall[2][4][2] = {                                            // fall slow, by limiter decay time
+  { {0.22f, 0.78f},       {0.17f, 0.83f},       {0.14f, 0.86f},       {0.1f, 0.9f} },
+  { {0.116844f, 0.883156f}, {0.088965f, 0.911035f}, {0.072632f, 0.927368f}, {0.051317f, 0.948683f} }
+};
+static const float fftGateDecay[2] = { 0.85f, 0.921954f };                                // decay of the channels while the noise gate is closed
+
+// hand-tuned 16 channel layout for 22050Hz by softhack007: FFT result bins [firstBin ... lastBin], damping
+typedef struct FFTBandDef {
+  uint8_t firstBin;
+  uint8_t lastBin;
+  float   damping;
+} FFTBandDef;
+static const FFTBandDef fftDefaultBands[2][NUM_GEQ_CHANNELS] = {
+  {                     // bins frequency  range
+    {  1,   2, 1.0f },  // 1    43 - 86   sub-bass
+    {  2,   3, 1.0f },  // 1    86 - 129  bass
+    {  3,   5, 1.0f },  // 2   129 - 216  bass
+    {  5,   7, 1.0f },  // 2   216 - 301  bass + midrange
+    {  7,  10, 1.0f },  // 3   301 - 430  midrange
+    { 10,  13, 1.0f },  // 3   430 - 560  midrange
+    { 13,  19, 1.0f },  // 5   560 - 818  midrange
+    { 19,  26, 1.0f },  // 7   818 - 1120 midrange -- 1Khz should always be the center !
+    { 26,  33, 1.0f },  // 7  1120 - 1421 midrange
+    { 33,  44, 1.0f },  // 9  1421 - 1895 midrange
+    { 44,  56, 1.0f },  // 12 1895 - 2412 midrange + high mid
+    { 56,  70, 1.0f },  // 14 2412 - 3015 high mid
+    { 70,  86, 1.0f },  // 16 3015 - 3704 high mid
+    { 86, 104, 1.0f },  // 18 3704 - 4479 high mid
+    {104, 165, 0.88f},  // 61 4479 - 7106 high mid + high  -- with slight damping
+    {165, 215, 0.70f}   // 50 7106 - 9259 high             -- with some damping. don't use the last bins from 216 to 255. They are usually contaminated by aliasing (aka noise)
+  }, {                  // band-pass filter: skip frequencies below 100hz
+    {  3,   4, 0.8f },
+    {  4,   5, 0.9f },
+    {  5,   6, 1.0f },
+    {  6,   7, 1.0f },
+    {  7,  10, 1.0f },
+    { 10,  13, 1.0f },
+    { 13,  19, 1.0f },
+    { 19,  26, 1.0f },
+    { 26,  33, 1.0f },
+    { 33,  44, 1.0f },
+    { 44,  56, 1.0f },
+    { 56,  70, 1.0f },
+    { 70,  86, 1.0f },
+    { 86, 104, 1.0f },
+    {104, 165, 0.88f},
+    {165, 205, 0.75f}   // don't use the last bins from 206 to 255.
+  }
+};
+#define FFT_LAST_GEQ_BIN 215                    // highest FFT result bin used by the GEQ (@22050Hz)
+#ifndef UM_AUDIOREACTIVE_GEQ_MIN_FREQ
+#define UM_AUDIOREACTIVE_GEQ_MIN_FREQ 43        // default frequency range of the log-spaced layouts (same as the 16 channel layout)
+#endif
+#ifndef UM_AUDIOREACTIVE_GEQ_MAX_FREQ
+#define UM_AUDIOREACTIVE_GEQ_MAX_FREQ 9260
+#endif
+
+// one GEQ band of the layout used by mapFFTChannels()/postProcessFFTResults()
+typedef struct FFTBand {
+  uint8_t firstBin;                   // FFT result bins [firstBin ... lastBin] are averaged
+  uint8_t lastBin;
+  float   weight;                     // damping / number of bins
+  float   pink;                       // pink noise adjustment
+  float   position;                   // position on the 16 channel scale (0...15) - for extra up-scaling of high frequencies
+} FFTBand;
+
+// user settings and volume filter values used when processing a batch (copied from the usermod before each batch)
+typedef struct FFTSettings {
+  float    sampleAvg = 0.0f;          // smoothed volume, the noise gate is open if above 0.25
+  float    multAgc = 1.0f;            // AGC multiplier, used instead of sampleGain/inputLevel if soundAgc > 0
+  uint8_t  soundAgc = 0;              // AGC mode (0 = off)
+  uint8_t  sampleGain = 60;           // manual gain
+  uint8_t  inputLevel = 128;          // UI "GEQ gain" slider
+  uint8_t  scalingMode = 3;           // 0 none; 1 optimized logarithmic; 2 optimized linear; 3 optimized square root
+  bool     bandPassFilter = false;    // band-pass filter 80Hz-16Khz before FFT
+  bool     limiterOn = true;          // use smoothed channel values
+  uint16_t decayTime = 1400;          // limiter decay time in ms
+  bool     forceFFT = false;          // run FFT even if the noise gate is closed (to measure FFT runtimes)
+  bool     overlap = FFT_OVERLAP;     // 50% window overlap: batches come twice as often, smoothing is adjusted to keep the same speed
+  uint8_t  geqBands = NUM_GEQ_CHANNELS;                   // number of GEQ bands (16 = hand-tuned default layout, up to MAX_GEQ_BANDS)
+  uint16_t geqMinFreq = UM_AUDIOREACTIVE_GEQ_MIN_FREQ;    // frequency range of the log-spaced layouts
+  uint16_t geqMaxFreq = UM_AUDIOREACTIVE_GEQ_MAX_FREQ;
+  uint32_t sampleRate = 22050;
+} FFTSettings;
+
+// filter and smoothing state carried from one batch to the next
+typedef struct FFTState {
+  float fftCalc[MAX_GEQ_BANDS] = {0.0f};      // Try and normalize fftBin values to a max of 4096, so that 4096/16 = 256.
+  float fftAvg[MAX_GEQ_BANDS] = {0.0f};       // Calculated frequency channel results, with smoothing (used if dynamics limiter is ON)
+  float filterLastVals[2] = {0.0f};           // band-pass: FIR high freq cutoff filter
+  float filterLowFilt = 0.0f;                 // band-pass: IIR low frequency cutoff filter
+  float window[samplesFFT] = {0.0f};          // the last samplesFFT (filtered) samples
+  // GEQ band layout, built by fftUpdateBands() from the settings below
+  FFTBand  bands[MAX_GEQ_BANDS];
+  uint8_t  channelBands[NUM_GEQ_CHANNELS][2]; // bands [first, last] downmixed into each of the 16 channels
+  uint8_t  numBands = 0;                      // 0: layout not built yet
+  bool     bandsBandPass = false;
+  uint16_t bandsMinFreq = 0;
+  uint16_t bandsMaxFreq = 0;
+  uint32_t bandsSampleRate = 0;
+} FFTState;
+
+// results of one batch
+typedef struct FFTResults {
+  float   maxSample = 0.0f;                   // highest sample of the batch (after band-pass filter)
+  float   majorPeak = 1.0f;                   // strongest (peak) frequency
+  float   magnitude = 0.0f;                   // volume (magnitude) of peak frequency
+  bool    haveFFT = false;                    // FFT was run (false: noise gate closed, bins are zero)
+  uint8_t fftResult[NUM_GEQ_CHANNELS] = {0};  // GEQ channels (16, downmixed if there are more bands)
+  uint8_t numBands = NUM_GEQ_CHANNELS;        // number of GEQ bands
+  uint8_t geqResult[MAX_GEQ_BANDS] = {0};     // GEQ bands
+} FFTResults;
+
+// pre-filtering of raw samples (band-pass)
+static void runMicFilter(FFTState &state, uint16_t numSamples, float *sampleBuffer)
+{
+  // low frequency cutoff parameter - see https://dsp.stackexchange.com/questions/40462/exponential-moving-average-cut-off-frequency
+  //constexpr float alpha = 0.04f;   // 150Hz
+  //constexpr float alpha = 0.03f;   // 110Hz
+  constexpr float alpha = 0.0225f; // 80hz
+  //constexpr float alpha = 0.01693f;// 60hz
+  // high frequency cutoff  parameter
+  //constexpr float beta1 = 0.75f;   // 11Khz
+  //constexpr float beta1 = 0.82f;   // 15Khz
+  //constexpr float beta1 = 0.8285f; // 18Khz
+  constexpr float beta1 = 0.85f;  // 20Khz
+
+  constexpr float beta2 = (1.0f - beta1) / 2.0f;
+  float *last_vals = state.filterLastVals; // FIR high freq cutoff filter
+  float &lowfilt = state.filterLowFilt;    // IIR low frequency cutoff filter
+
+  for (int i=0; i < numSamples; i++) {
+        // FIR lowpass, to remove high frequency noise
+        float highFilteredSample;
+        if (i < (numSamples-1)) highFilteredSample = beta1*sampleBuffer[i] + beta2*last_vals[0] + beta2*sampleBuffer[i+1];  // smooth out spikes
+        else highFilteredSample = beta1*sampleBuffer[i] + beta2*last_vals[0]  + beta2*last_vals[1];                  // special handling for last sample in array
+        last_vals[1] = last_vals[0];
+        last_vals[0] = sampleBuffer[i];
+        sampleBuffer[i] = highFilteredSample;
+        // IIR highpass, to remove low frequency noise
+        lowfilt += alpha * (sampleBuffer[i] - lowfilt);
+        sampleBuffer[i] = sampleBuffer[i] - lowfilt;
+  }
+}
+
+// number of new samples per batch
+static inline uint16_t fftBatchSamples(const FFTSettings &settings) { return settings.overlap ? samplesFFT / 2 : samplesFFT; }
+
+// moves the sample window by one batch, the new samples have to be stored at the returned address
+static float *fftNewSamples(FFTState &state, const FFTSettings &settings)
+{
+  const uint16_t batch = fftBatchSamples(settings);
+  if (batch < samplesFFT) memmove(state.window, state.window + batch, (samplesFFT - batch) * sizeof(float));
+  return state.window + samplesFFT - batch;
+}
+
+// band-pass filter (if enabled) of the new samples in the window and highest new sample, to be released to volume reactive effects
+// before the FFT is run. Copies the window into vReal[] for the FFT.
+static float preProcessFFTSamples(FFTState &state, const FFTSettings &settings, float *vReal)
+{
+  const uint16_t batch = fftBatchSamples(settings);
+  float *samples = state.window + samplesFFT - batch;
+
+  // band pass filter - can reduce noise floor by a factor of 50
+  // downside: frequencies below 100Hz will be ignored
+  if (settings.bandPassFilter) runMicFilter(state, batch, samples);
+
+  // find highest sample in the batch
+  float maxSample = 0.0f;                         // max sample from FFT batch
+  for (int i=0; i < batch; i++) {
+    // pick our  our current mic sample - we take the max value from all samples that go into FFT
+    if ((samples[i] <= (INT16_MAX - 1024)) && (samples[i] >= (INT16_MIN + 1024)))  //skip extreme values - normally these are artefacts
+      if (fabsf((float)samples[i]) > maxSample) maxSample = fabsf((float)samples[i]);
+  }
+  memcpy(vReal, state.window, samplesFFT * sizeof(float));
+  return maxSample;
+}
+
+// position of a frequency on the 16 channel scale of the default layout (0.0 ... 15.0, interpolated between channel centers in log scale)
+static float fftChannelPosition(float frequency)
+{
+  const float bin = frequency / (22050.0f / samplesFFT);   // default layout is tuned for 22050Hz
+  const FFTBandDef *def = fftDefaultBands[0];
+  float lastCenter = 0.5f * (def[0].firstBin + def[0].lastBin);
+  if (bin <= lastCenter) return 0.0f;
+  for (int i = 1; i < NUM_GEQ_CHANNELS; i++) {
+    const float center = 0.5f * (def[i].firstBin + def[i].lastBin);
+    if (bin < center) return (i - 1) + logf(bin / lastCenter) / logf(center / lastCenter);
+    lastCenter = center;
+  }
+  return NUM_GEQ_CHANNELS - 1;
+}
+
+// (re)builds the GEQ band layout if the band settings have changed - called from processFFTBatch(), i.e. inside the FFT task
+static void fftUpdateBands(FFTState &state, const FFTSettings &settings)
+{
+  const unsigned numBands = constrain(settings.geqBands, 8, MAX_GEQ_BANDS);
+  if (numBands == state.numBands && settings.bandPassFilter == state.bandsBandPass && settings.geqMinFreq == state.bandsMinFreq
+      && settings.geqMaxFreq == state.bandsMaxFreq && settings.sampleRate == state.bandsSampleRate) return;
+  state.numBands = numBands;
+  state.bandsBandPass = settings.bandPassFilter;
+  state.bandsMinFreq = settings.geqMinFreq;
+  state.bandsMaxFreq = settings.geqMaxFreq;
+  state.bandsSampleRate = settings.sampleRate;
+  memset(state.fftCalc, 0, sizeof(state.fftCalc));
+  memset(state.fftAvg, 0, sizeof(state.fftAvg));
+
+  const FFTBandDef *def = fftDefaultBands[settings.bandPassFilter ? 1 : 0];
+  if (numBands == NUM_GEQ_CHANNELS) {  // hand-tuned default layout
+    for (unsigned i = 0; i < numBands; i++) {
+      state.bands[i] = { def[i].firstBin, def[i].lastBin, def[i].damping / float(def[i].lastBin - def[i].firstBin + 1), fftResultPink[i], float(i) };
+      state.channelBands[i][0] = state.channelBands[i][1] = i;
+    }
+    return;
+  }
+
+  // log-spaced band edges, at least one bin apart (low frequencies): band i = bins [edge[i] ... edge[i+1]]
+  const float binWidth = float(settings.sampleRate) / samplesFFT;
+  int minBin = max(settings.bandPassFilter ? 3 : 1, (int)lroundf(settings.geqMinFreq / binWidth)); // band-pass: skip frequencies below 100hz
+  int maxBin = min(FFT_LAST_GEQ_BIN, (int)lroundf(settings.geqMaxFreq / binWidth));
+  maxBin = max(maxBin, min(minBin + (int)numBands, FFT_LAST_GEQ_BIN));
+  minBin = min(minBin, maxBin - (int)numBands);
+  uint8_t edge[MAX_GEQ_BANDS + 1];
+  const float ratio = powf(float(maxBin) / float(minBin), 1.0f / numBands);
+  edge[0] = minBin;
+  for (unsigned i = 1; i <= numBands; i++) {
+    int e = lroundf(minBin * powf(ratio, i));
+    e = max(e, edge[i-1] + 1);
+    edge[i] = min(e, maxBin - int(numBands - i));
+  }
+
+  // pink noise adjustment and damping are interpolated from the default layout at the center frequency of the band
+  for (unsigned i = 0; i < numBands; i++) {
+    const unsigned first = edge[i], last = edge[i+1];
+    const float position = fftChannelPosition(0.5f * (first + last) * binWidth);
+    const int ch = min(int(position), NUM_GEQ_CHANNELS - 2);
+    const float frac = position - ch;
+    const float pink = fftResultPink[ch] + frac * (fftResultPink[ch+1] - fftResultPink[ch]);
+    const float damping = def[ch].damping + frac * (def[ch+1].damping - def[ch].damping);
+    state.bands[i] = { uint8_t(first), uint8_t(last), damping / float(last - first + 1), pink, position };
+  }
+
+  // 16 channel downmix: each channel gets the bands nearest to it, or the closest band if there is none
+  for (int ch = 0; ch < NUM_GEQ_CHANNELS; ch++) {
+    state.channelBands[ch][0] = UINT8_MAX;
+    state.channelBands[ch][1] = 0;
+  }
+  for (unsigned i = 0; i < numBands; i++) {
+    const int ch = constrain((int)lroundf(state.bands[i].position), 0, NUM_GEQ_CHANNELS - 1);
+    state.channelBands[ch][0] = min(state.channelBands[ch][0], uint8_t(i));
+    state.channelBands[ch][1] = max(state.channelBands[ch][1], uint8_t(i));
+  }
+  for (int ch = 0; ch < NUM_GEQ_CHANNELS; ch++) {
+    if (state.channelBands[ch][0] != UINT8_MAX) continue;
+    unsigned nearest = 0;
+    for (unsigned i = 1; i < numBands; i++)
+      if (fabsf(state.bands[i].position - ch) < fabsf(state.bands[nearest].position - ch)) nearest = i;
+    state.channelBands[ch][0] = state.channelBands[ch][1] = nearest;
+  }
+}
+
+// mapping of FFT result bins to frequency channels (GEQ bands)
+static void mapFFTChannels(FFTState &state, const FFTSettings &settings, const float *vReal)
+{
+  float *fftCalc = state.fftCalc;
+  if (fabsf(settings.sampleAvg) > 0.5f) { // noise gate open
+    for (unsigned i = 0; i < state.numBands; i++) {
+      const FFTBand &band = state.bands[i];
+      float sum = 0.0f;
+      for (unsigned bin = band.firstBin; bin <= band.lastBin; bin++) sum += vReal[bin];
+      fftCalc[i] = sum * band.weight;     // weighted average of the bins
+    }
+  } else {  // noise gate closed - just decay old values
+    for (unsigned i=0; i < state.numBands; i++) {
+      fftCalc[i] *= fftGateDecay[settings.overlap];  // decay to zero
+      if (fftCalc[i] < 4.0f) fftCalc[i] = 0.0f;
+    }
+  }
+}
+
+// post-processing and post-amp of GEQ channels
+static void postProcessFFTResults(FFTState &state, const FFTSettings &settings, bool noiseGateOpen, int numberOfChannels, uint8_t *fftResult)
+{
+    float *fftCalc = state.fftCalc;
+    float *fftAvg = state.fftAvg;
+    const uint16_t decayTime = settings.decayTime;
+    const unsigned overlap = settings.overlap ? 1 : 0;
+    for (int i=0; i < numberOfChannels; i++) {
+      const float position = state.bands[i].position;  // channel 0...15 for the high frequency up-scaling
+
+      if (noiseGateOpen) { // noise gate open
+        // Adjustment for frequency curves.
+        fftCalc[i] *= state.bands[i].pink;
+        if (settings.scalingMode > 0) fftCalc[i] *= FFT_DOWNSCALE;  // adjustment related to FFT windowing function
+        // Manual linear adjustment of gain using sampleGain adjustment for different input types.
+        fftCalc[i] *= settings.soundAgc ? settings.multAgc : ((float)settings.sampleGain/40.0f * (float)settings.inputLevel/128.0f + 1.0f/16.0f); //apply gain, with inputLevel adjustment
+        if(fftCalc[i] < 0) fftCalc[i] = 0;
+      }
+
+      // smooth results - rise fast, fall slower
+      const float *smooth;
+      if(fftCalc[i] > fftAvg[i])   // rise fast
+        smooth = fftSmoothRise[overlap];            // will need approx 2 cycles (50ms) for converging against fftCalc[i]
+      else {                       // fall slow
+        if (decayTime < 1000) smooth = fftSmoothFall[overlap][0];       // approx  5 cycles (225ms) for falling to zero
+        else if (decayTime < 2000) smooth = fftSmoothFall[overlap][1];  // default - approx  9 cycles (225ms) for falling to zero
+        else if (decayTime < 3000) smooth = fftSmoothFall[overlap][2];  // approx 14 cycles (350ms) for falling to zero
+        else smooth = fftSmoothFall[overlap][3];                        // approx 20 cycles (500ms) for falling to zero
+      }
+      fftAvg[i] = fftCalc[i]*smooth[0] + smooth[1]*fftAvg[i];
+      // constrain internal vars - just to be sure
+      fftCalc[i] = constrain(fftCalc[i], 0.0f, 1023.0f);
+      fftAvg[i] = constrain(fftAvg[i], 0.0f, 1023.0f);
+
+      float currentResult;
+      if(settings.limiterOn == true)
+        currentResult = fftAvg[i];
+      else
+        currentResult = fftCalc[i];
+
+      switch (settings.scalingMode) {
+        case 1:
+            // Logarithmic scaling
+            currentResult *= 0.42f;                      // 42 is the answer ;-)
+            currentResult -= 8.0f;                       // this skips the lowest row, giving some room for peaks
+            if (currentResult > 1.0f) currentResult = logf(currentResult); // log to base "e", which is the fastest log() function
+            else currentResult = 0.0f;                   // special handling, because log(1) = 0; log(0) = undefined
+            currentResult *= 0.85f + (position/18.0f);  // extra up-scaling for high frequencies
+            currentResult = mapf(currentResult, 0, LOG_256, 0, 255); // map [log(1) ... log(255)] to [0 ... 255]
+        break;
+        case 2:
+            // Linear scaling
+            currentResult *= 0.30f;                     // needs a bit more damping, get stay below 255
+            currentResult -= 4.0f;                       // giving a bit more room for peaks
+            if (currentResult < 1.0f) currentResult = 0.0f;
+            currentResult *= 0.85f + (position/1.8f);   // extra up-scaling for high frequencies
+        break;
+        case 3:
+            // square root scaling
+            currentResult *= 0.38f;
+            currentResult -= 6.0f;
+            if (currentResult > 1.0f) currentResult = sqrtf(currentResult);
+            else currentResult = 0.0f;                   // special handling, because sqrt(0) = undefined
+            currentResult *= 0.85f + (position/4.5f);   // extra up-scaling for high frequencies
+            currentResult = mapf(currentResult, 0.0, 16.0, 0.0, 255.0); // map [sqrt(1) ... sqrt(256)] to [0 ... 255]
+        break;
+
+        case 0:
+        default:
+            // no scaling - leave freq bins as-is
+            currentResult -= 4; // just a bit more room for peaks
+        break;
+      }
+
+      // Now, let's dump it all into fftResult. Need to do this, otherwise other routines might grab fftResult values prematurely.
+      if (settings.soundAgc > 0) {  // apply extra "GEQ Gain" if set by user
+        float post_gain = (float)settings.inputLevel/128.0f;
+        if (post_gain < 1.0f) post_gain = ((post_gain -1.0f) * 0.8f) +1.0f;
+        currentResult *= post_gain;
+      }
+      fftResult[i] = constrain((int)currentResult, 0, 255);
+    }
+}
+
+//////////////////
+// FFT backends //
+//////////////////
+// All backends work on the vReal[]/vImag[] buffers given to the constructor (samplesFFT floats each).
+// compute(): removes the DC offset, applies the "Flat Top" window to the samples in vReal[] and replaces them by the
+//            FFT magnitudes (bin i = i * sampleRate / samplesFFT Hz, upper half mirrored), vImag[] is scratch space
+// majorPeak(): frequency and magnitude of the strongest peak after compute()
+
+#ifdef UM_AUDIOREACTIVE_USE_ARDUINOFFT
+// lib_deps += https://github.com/kosme/arduinoFFT#develop @ 1.9.2
+// these options actually cause slow-downs on all esp32 processors, don't use them.
+// #define FFT_SPEED_OVER_PRECISION     // enables use of reciprocals (1/x etc) - not faster on ESP32
+// #define FFT_SQRT_APPROXIMATION       // enables "quake3" style inverse sqrt  - slower on ESP32
+// Below options are forcing ArduinoFFT to use sqrtf() instead of sqrt()
+// #define sqrt_internal sqrtf          // see https://github.com/kosme/arduinoFFT/pull/83 - since v2.0.0 this must be done in build_flags
+class ArduinoFFTBackend {
+  public:
+    ArduinoFFTBackend(float *vReal, float *vImag, float sampleRate) :
+      _vImag(vImag),
+      _fft(vReal, vImag, samplesFFT, sampleRate, true)   // with weighing factor storage
+    {}
+    bool isReady() const { return true; }
+
+    void compute() {
+      memset(_vImag, 0, samplesFFT * sizeof(float));             // set imaginary parts to 0
+      _fft.dcRemoval();                                            // remove DC offset
+      _fft.windowing( FFTWindow::Flat_top, FFTDirection::Forward); // Weigh data using "Flat Top" function - better amplitude accuracy
+      //_fft.windowing(FFTWindow::Blackman_Harris, FFTDirection::Forward);  // Weigh data using "Blackman- Harris" window - sharp peaks due to excellent sideband rejection
+      _fft.compute( FFTDirection::Forward );                       // Compute FFT
+      _fft.complexToMagnitude();                                   // Compute magnitudes
+    }
+    void majorPeak(float *frequency, float *magnitude) { _fft.majorPeak(frequency, magnitude); }
+
+  private:
+    float *_vImag;
+    ArduinoFFT<float> _fft;
+};
+#endif
+
+// arithmetic of the radix-4 FFT: float, or fixed point with Q30 twiddle factors
+static inline float   fftMulTwiddle(float a, float w)     { return a * w; }
+static inline int32_t fftMulTwiddle(int32_t a, int32_t w) { return (int32_t)(((int64_t)a * w + (1 << 29)) >> 30); } // rounded
+static inline void    fftSetTwiddle(float &t, double v)   { t = (float)v; }
+static inline void    fftSetTwiddle(int32_t &t, double v) { t = (int32_t)lround(v * (1 << 30)); }
+
+/* Real FFT of samplesFFT samples through a samplesFFT/2 point complex FFT (radix-4, decimation in time)
+   Window, twiddle factors and the digit reversal permutation are computed once in the constructor (~3.3kB).
+   T = float, or int32_t for fixed point on MCUs without FPU: samples are scaled to 23 bits, and as the window limits
+   the FFT gain no scaling between the radix-4 stages is needed (GEQ channels within +-1 of the float backend).
+*/
+template<typename T> class Radix4FFTBackend {
+  public:
+    Radix4FFTBackend(float *vReal, float *vImag, float sampleRate) :
+      _vReal(vReal),
+      _work((T*)vImag),                                          // vImag[] holds the N/2 complex values (re, im interleaved)
+      _sampleRate(sampleRate)
+    {
+      static_assert(sizeof(T) == sizeof(float), "complex work buffer must fit into vImag[]");
+      _window = (float*) d_malloc(samplesFFT/2 * sizeof(float));  // tables are read for every batch, prefer DRAM
+      _twiddle = (T*) d_malloc(samplesFFT/2 * 2 * sizeof(T));
+      _reverse = (uint8_t*) d_malloc(fftSize);
+      if (!isReady()) return;
+      const double samplesMinusOne = samplesFFT - 1;
+      for (unsigned i = 0; i < samplesFFT/2; i++) {              // "Flat Top" window, symmetric: first half only
+        const double ratio = double(i) / samplesMinusOne;
+        _window[i] = 0.2810639 - (0.5208972 * cos(2.0 * M_PI * ratio)) + (0.1980399 * cos(4.0 * M_PI * ratio));
+      }
+      for (unsigned k = 0; k < samplesFFT/2; k++) {              // W_N^k = exp(-2*pi*i*k/N), k < N/2
+        fftSetTwiddle(_twiddle[2*k],      cos(2.0 * M_PI * k / samplesFFT));
+        fftSetTwiddle(_twiddle[2*k + 1], -sin(2.0 * M_PI * k / samplesFFT));
+      }
+      for (unsigned i = 0; i < fftSize; i++) {                   // base 4 digit reversal
+        unsigned r = 0;
+        for (unsigned d = 1, j = i; d < fftSize; d <<= 2, j >>= 2) r = (r << 2) | (j & 3);
+        _reverse[i] = r;
+      }
+    }
+    ~Radix4FFTBackend() {
+      d_free(_window);
+      d_free(_twiddle);
+      d_free(_reverse);
+    }
+    bool isReady() const { return _window && _twiddle && _reverse; }
+
+    void compute() {
+      float mean = 0.0f;                                         // remove DC offset
+      for (unsigned i = 0; i < samplesFFT; i++) mean += _vReal[i];
+      mean /= samplesFFT;
+
+      // window the samples and store them as complex values z[n] = x[2n] + i*x[2n+1] in digit reversed order
+      for (unsigned n = 0; n < fftSize; n++) {
+        const unsigned i = 2*n;
+        T *z = _work + 2 * _reverse[n];
+        z[0] = _sample((_vReal[i]     - mean) * _window[i     < samplesFFT/2 ? i     : samplesFFT - 1 - i]);
+        z[1] = _sample((_vReal[i + 1] - mean) * _window[i + 1 < samplesFFT/2 ? i + 1 : samplesFFT - 2 - i]);
+      }
+
+      // radix-4 butterflies
+      for (unsigned quarter = 1; quarter < fftSize; quarter <<= 2) {
+        const unsigned span = quarter * 4;
+        const unsigned step = fftSize / span;                    // twiddle W_span^k = W_(N/2)^(k*step) = W_N^(2*k*step)
+        for (unsigned k = 0; k < quarter; k++) {
+          T w1r, w1i, w2r, w2i, w3r, w3i;
+          _getTwiddle(2 * k * step, w1r, w1i);
+          _getTwiddle(4 * k * step, w2r, w2i);
+          _getTwiddle(6 * k * step, w3r, w3i);
+          for (unsigned j = k; j < fftSize; j += span) {
+            T *a0 = _work + 2*j;
+            T *a1 = a0 + 2*quarter;
+            T *a2 = a1 + 2*quarter;
+            T *a3 = a2 + 2*quarter;
+            const T b1r = fftMulTwiddle(a1[0], w1r) - fftMulTwiddle(a1[1], w1i), b1i = fftMulTwiddle(a1[0], w1i) + fftMulTwiddle(a1[1], w1r);
+            const T b2r = fftMulTwiddle(a2[0], w2r) - fftMulTwiddle(a2[1], w2i), b2i = fftMulTwiddle(a2[0], w2i) + fftMulTwiddle(a2[1], w2r);
+            const T b3r = fftMulTwiddle(a3[0], w3r) - fftMulTwiddle(a3[1], w3i), b3i = fftMulTwiddle(a3[0], w3i) + fftMulTwiddle(a3[1], w3r);
+            const T t0r = a0[0] + b2r, t0i = a0[1] + b2i;
+            const T t1r = a0[0] - b2r, t1i = a0[1] - b2i;
+            const T t2r = b1r + b3r,   t2i = b1i + b3i;
+            const T t3r = b1r - b3r,   t3i = b1i - b3i;
+            a0[0] = t0r + t2r; a0[1] = t0i + t2i;
+            a2[0] = t0r - t2r; a2[1] = t0i - t2i;
+            a1[0] = t1r + t3i; a1[1] = t1i - t3r;                // t1 - i*t3
+            a3[0] = t1r - t3i; a3[1] = t1i + t3r;                // t1 + i*t3
+          }
+        }
+      }
+
+      // split the N/2 point result into the spectrum of the real signal: X[k] = (Z[k] + Z*[N/2-k])/2 - i/2 * W_N^k * (Z[k] - Z*[N/2-k])
+      for (unsigned k = 0; k <= fftSize; k++) {
+        const T *zk = _work + 2 * (k % fftSize);
+        const T *zm = _work + 2 * ((fftSize - k) % fftSize);
+        const float er = 0.5f * (float(zk[0]) + float(zm[0])), ei = 0.5f * (float(zk[1]) - float(zm[1])); // even samples
+        const float or_ = 0.5f * (float(zk[1]) + float(zm[1])), oi = -0.5f * (float(zk[0]) - float(zm[0])); // odd samples
+        float wr, wi;
+        if (k < fftSize) { wr = _twiddleFloat(2*k); wi = _twiddleFloat(2*k + 1); }
+        else { wr = -1.0f; wi = 0.0f; }
+        const float xr = er + or_ * wr - oi * wi;
+        const float xi = ei + or_ * wi + oi * wr;
+        _vReal[k] = _fixedPoint ? sqrtf(xr * xr + xi * xi) * (1.0f / 64.0f) : sqrtf(xr * xr + xi * xi);
+      }
+      for (unsigned k = 1; k < fftSize; k++) _vReal[samplesFFT - k] = _vReal[k]; // mirror, like a complex FFT of real data
+    }
+
+    // strongest peak with parabolic interpolation (same as ArduinoFFT::majorPeak())
+    void majorPeak(float *frequency, float *magnitude) {
+      float maxY = 0;
+      unsigned indexOfMaxY = 0;
+      for (unsigned i = 1; i < ((samplesFFT >> 1) + 1); i++) {
+        if ((_vReal[i - 1] < _vReal[i]) && (_vReal[i] > _vReal[i + 1]) && (_vReal[i] > maxY)) {
+          maxY = _vReal[i];
+          indexOfMaxY = i;
+        }
+      }
+      if (indexOfMaxY == 0) { *frequency = 0; *magnitude = 0; return; }
+      const float curvature = _vReal[indexOfMaxY - 1] - (2.0f * _vReal[indexOfMaxY]) + _vReal[indexOfMaxY + 1];
+      const float delta = 0.5f * ((_vReal[indexOfMaxY - 1] - _vReal[indexOfMaxY + 1]) / curvature);
+      if (indexOfMaxY == (samplesFFT >> 1)) *frequency = ((indexOfMaxY + delta) * _sampleRate) / samplesFFT;
+      else                                  *frequency = ((indexOfMaxY + delta) * _sampleRate) / (samplesFFT - 1);
+      *magnitude = fabsf(curvature);
+    }
+
+  private:
+    static constexpr unsigned fftSize = samplesFFT / 2;          // complex FFT size, must be a power of 4
+    static_assert((fftSize & 0x5555) == fftSize, "radix-4 FFT needs samplesFFT/2 to be a power of 4");
+
+    // fixed point: windowed samples clamped to +-65535 with 6 fractional bits (23 bits incl. sign), float: as is
+    // sum of the "Flat Top" window is ~144, so the FFT results stay below 2^30
+    static const bool _fixedPoint = std::is_integral<T>::value;
+    static T _sample(float v) {
+      if (_fixedPoint) v = constrain(v, -65535.0f, 65535.0f) * 64.0f;
+      return T(v);
+    }
+    float _twiddleFloat(unsigned i) const { return _fixedPoint ? float(_twiddle[i]) * (1.0f / (1 << 30)) : float(_twiddle[i]); }
+    // W_N^m for m < N (table holds m < N/2, W_N^(m+N/2) = -W_N^m)
+    void _getTwiddle(unsigned m, T &re, T &im) const {
+      if (m < samplesFFT/2) { re = _twiddle[2*m]; im = _twiddle[2*m + 1]; }
+      else { re = -_twiddle[2*(m - samplesFFT/2)]; im = -_twiddle[2*(m - samplesFFT/2) + 1]; }
+    }
+
+    float *_vReal;
+    T *_work;
+    float _sampleRate;
+    float *_window = nullptr;
+    T *_twiddle = nullptr;
+    uint8_t *_reverse = nullptr;
+};
+
+#if defined(UM_AUDIOREACTIVE_USE_ARDUINOFFT)
+typedef ArduinoFFTBackend FFTBackend;
+#elif defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32C3)
+typedef Radix4FFTBackend<int32_t> FFTBackend;    // no FPU
+#else
+typedef Radix4FFTBackend<float> FFTBackend;
+#endif
+
+// FFT of a batch of samples (vReal[] filtered by preProcessFFTSamples()), mapped and post-processed into results.geqResult[]/fftResult[]
+// on return vReal[] holds the scaled FFT result bins (used for peak detection)
+template<class Backend> static void processFFTBatch(Backend &FFT, float *vReal, FFTState &state, const FFTSettings &settings, FFTResults &results)
+{
+  fftUpdateBands(state, settings);
+
+  if (settings.forceFFT || settings.sampleAvg > 0.25f) { // noise gate open means that FFT results will be used. Don't run FFT if results are not needed.
+    // run FFT (ArduinoFFT takes 3-5ms on ESP32, ~12ms on ESP32-S2)
+    FFT.compute();                                              // DC removal, "Flat Top" window, FFT, magnitudes
+    vReal[0] = 0;   // The remaining DC offset on the signal produces a strong spike on position 0 that should be eliminated to avoid issues.
+
+    FFT.majorPeak(&results.majorPeak, &results.magnitude);      // let the effects know which freq was most dominant
+    results.majorPeak = constrain(results.majorPeak, 1.0f, 11025.0f);   // restrict value to range expected by effects
+    results.haveFFT = true;
+  } else { // noise gate closed - only clear results as FFT was skipped. MIC samples are still valid when we do this.
+    memset(vReal, 0, samplesFFT * sizeof(float));
+    results.majorPeak = 1;
+    results.magnitude = 0.001;
+    results.haveFFT = false;
+  }
+
+  for (int i = 0; i < samplesFFT; i++) {
+    float t = fabsf(vReal[i]);                      // just to be sure - values in fft bins should be positive any way
+    vReal[i] = t / 16.0f;                           // Reduce magnitude. Want end result to be scaled linear and ~4096 max.
+  } // for()
+
+  // mapping of FFT result bins to frequency channels
+  mapFFTChannels(state, settings, vReal);
+
+  // post-processing of frequency channels (pink noise adjustment, AGC, smoothing, scaling)
+  postProcessFFTResults(state, settings, (fabsf(settings.sampleAvg) > 0.25f)? true : false , state.numBands, results.geqResult);
+  results.numBands = state.numBands;
+
+  // classic 16 channels (same as the bands with the default layout)
+  for (int ch = 0; ch < NUM_GEQ_CHANNELS; ch++) {
+    uint8_t value = 0;
+    for (unsigned i = state.channelBands[ch][0]; i <= state.channelBands[ch][1]; i++) value = max(value, results.geqResult[i]);
+    results.fftResult[ch] = value;
+  }
+}
+
+
+// onset detection and beat tracking
+// Onsets are peaks of the spectral flux - the sum of the increases of the log-compressed magnitudes (log2 of the FFT result bins) from one batch to the next -
+// above an adaptive threshold (running mean + deviation of the flux). The tempo is the strongest lag (60...200 BPM, weighted towards
+// 120 BPM) of a leaky autocorrelation of the onset envelope, the beat phase is a counter running at that tempo which is pulled
+// towards the strongest onsets at that period. Works on the scaled FFT result bins that processFFTBatch() leaves in vReal[].
+#define BEAT_HISTORY 128                        // onset envelope history (batches) - must hold the longest beat period (60 BPM with overlap: 86 batches)
+#define BEAT_MIN_BPM 60
+#define BEAT_MAX_BPM 200
+
+typedef struct BeatState {
+  float    spectrum[FFT_LAST_GEQ_BIN + 1] = {0.0f}; // log-compressed FFT result bins of the last batch
+  bool     haveSpectrum = false;              // false after silence (noise gate closed): first spectrum has no flux
+  float    lastFlux = 0.0f;
+  float    fluxAvg = 0.0f;                    // running mean of the flux
+  float    fluxDev = 0.0f;                    // running mean deviation of the flux
+  uint32_t frame = 0;                         // batch counter
+  uint32_t lastOnset = 0;                     // batch of the last onset
+  float    envelope[BEAT_HISTORY] = {0.0f};   // onset envelope (flux above mean + deviation), ring buffer indexed by frame
+  float    acf[BEAT_HISTORY] = {0.0f};        // leaky autocorrelation of the envelope by lag (in batches)
+  float    energy = 0.0f;                     // same for lag 0
+  float    period = 0.0f;                     // beat period in batches, 0: no tempo found (yet)
+  float    newPeriod = 0.0f;                  // different period found, becomes the tempo if confirmed by the next estimate
+  float    phase = 0.0f;                      // beat phase 0...1
+  float    strength = 0.0f;                   // onset strength, decays
+} BeatState;
+
+typedef struct BeatResults {
+  bool    onset = false;                      // onset detected in this batch
+  uint8_t onsetStrength = 0;                  // 0...255, jumps up on an onset and decays like the GEQ channels
+  float   bpm = 0.0f;                         // tempo, 0: unknown
+  uint8_t beatPhase = 0;                      // position within the beat 0...255, 0 = on the beat
+} BeatResults;
+
+// log2(x) for x > 0 - quadratic approximation of the mantissa, error < 0.01 (avoids logf(), which is slow on MCUs without FPU)
+static inline float fftFastLog2(float x)
+{
+  uint32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  const int exponent = int((bits >> 23) & 0xFF) - 127;
+  bits = (bits & 0x007FFFFF) | 0x3F800000;   // mantissa 1...2
+  float m;
+  memcpy(&m, &bits, sizeof(m));
+  return float(exponent) + (-0.34484843f * m + 2.02466578f) * m - 1.67981735f;
+}
+
+static void detectBeats(BeatState &beat, const FFTSettings &settings, const float *vReal, bool haveFFT, BeatResults &results)
+{
+  const float frameRate = float(settings.sampleRate) / float(fftBatchSamples(settings)); // batches per second
+  beat.frame++;
+
+  // spectral flux
+  float flux = 0.0f;
+  if (haveFFT) {
+    for (int i = 1; i <= FFT_LAST_GEQ_BIN; i++) {
+      const float value = fftFastLog2(max(1.0f, vReal[i]));  // bins below 1 (about the noise floor of a microphone) count as silence
+      const float rise = value - beat.spectrum[i];
+      if (rise > 0.0f) flux += rise;
+      beat.spectrum[i] = value;
+    }
+    if (!beat.haveSpectrum) flux = 0.0f;      // everything is "new" after silence
+  }
+  beat.haveSpectrum = haveFFT;
+
+  // onset: rising flux above the adaptive threshold, at most one onset per 100ms
+  const float threshold = beat.fluxAvg + 2.0f * beat.fluxDev + 0.25f * beat.fluxAvg + 0.5f;
+  results.onset = (flux > threshold) && (flux > beat.lastFlux) && (beat.frame - beat.lastOnset >= frameRate * 0.1f);
+  const float envelope = max(0.0f, flux - beat.fluxAvg - beat.fluxDev);
+  if (results.onset) {
+    beat.lastOnset = beat.frame;
+    beat.strength = max(beat.strength, min(255.0f, 64.0f * (flux - beat.fluxAvg) / (threshold - beat.fluxAvg))); // 64 at the threshold
+  } else {
+    beat.strength *= fftGateDecay[settings.overlap];
+  }
+  beat.lastFlux = flux;
+  const float alpha = max(2.0f / frameRate, 1.0f / beat.frame);  // ~0.5s (plain average at the start)
+  beat.fluxDev += alpha * (fabsf(flux - beat.fluxAvg) - beat.fluxDev);
+  beat.fluxAvg += alpha * (flux - beat.fluxAvg);
+
+  // leaky autocorrelation of the onset envelope for all lags from 200 to 60 BPM (plus one on each side for interpolation)
+  const int minLag = max(2, int(frameRate * 60.0f / BEAT_MAX_BPM));
+  const int maxLag = min(BEAT_HISTORY - 2, int(frameRate * 60.0f / BEAT_MIN_BPM + 1.0f));
+  const float leak = 1.0f - 1.0f / (frameRate * 4.0f); // ~4s memory
+  beat.envelope[beat.frame % BEAT_HISTORY] = envelope;
+  for (int lag = minLag - 1; lag <= maxLag + 1; lag++)
+    beat.acf[lag] = beat.acf[lag] * leak + envelope * beat.envelope[(beat.frame - lag) % BEAT_HISTORY];
+  beat.energy = beat.energy * leak + envelope * envelope;
+
+  // tempo estimate about 5 times per second
+  if (beat.frame - beat.lastOnset > frameRate * 8.0f) {
+    beat.period = 0.0f;                                                 // no onsets for 8 seconds: forget the tempo
+    beat.newPeriod = 0.0f;
+  } else if (beat.frame % max(1, int(frameRate / 5.0f)) == 0) {
+    float bestScore = 0.0f;
+    int bestLag = 0;
+    for (int lag = minLag; lag <= maxLag; lag++) {
+      const float octaves = log2f(frameRate * 60.0f / (lag * 120.0f));    // distance from 120 BPM
+      const float score = beat.acf[lag] * expf(-octaves * octaves);       // log-gaussian tempo preference, 1 octave => 0.37
+      if (score > bestScore) { bestScore = score; bestLag = lag; }
+    }
+    if (bestLag > 0 && beat.acf[bestLag] > 0.3f * beat.energy) { // periodic enough
+      // parabolic interpolation between the neighbouring lags
+      const float l = beat.acf[bestLag - 1], c = beat.acf[bestLag], r = beat.acf[bestLag + 1];
+      const float denominator = l - 2.0f * c + r;
+      const float period = bestLag + ((denominator < 0.0f) ? constrain(0.5f * (l - r) / denominator, -0.5f, 0.5f) : 0.0f);
+      if (beat.period > 0.0f && fabsf(period - beat.period) < 0.05f * beat.period) {
+        beat.period += 0.25f * (period - beat.period);                  // same tempo: smooth
+        beat.newPeriod = 0.0f;
+      } else if (beat.period == 0.0f || (beat.newPeriod > 0.0f && fabsf(period - beat.newPeriod) < 0.05f * beat.newPeriod)) {
+        beat.period = period;                                           // first or confirmed new tempo
+        beat.newPeriod = 0.0f;
+      } else {
+        beat.newPeriod = period;
+      }
+    }
+  }
+
+  // beat phase
+  if (beat.period > 0.0f) {
+    beat.phase += 1.0f / beat.period;
+    if (beat.phase >= 1.0f) beat.phase -= 1.0f;
+    if (beat.frame % max(1, int(frameRate / 5.0f)) == 0) {
+      // align the phase to the strongest onsets: beat positions (offset + multiples of the period back in the history) with the highest envelope sum
+      const int period = int(beat.period + 0.5f);
+      float bestSum = 0.0f;
+      int bestOffset = -1;
+      for (int offset = 0; offset < period; offset++) {
+        float sum = 0.0f;
+        for (int back = offset; back < BEAT_HISTORY; back += period) sum += beat.envelope[(beat.frame - back) % BEAT_HISTORY];
+        if (sum > bestSum) { bestSum = sum; bestOffset = offset; }
+      }
+      if (bestOffset >= 0) {
+        float error = float(bestOffset) / beat.period - beat.phase;     // phase is the time since the last beat
+        if (error >= 0.5f) error -= 1.0f;
+        if (error < -0.5f) error += 1.0f;
+        beat.phase += 0.5f * error;
+        if (beat.phase < 0.0f) beat.phase += 1.0f;
+        if (beat.phase >= 1.0f) beat.phase -= 1.0f;
+      }
+    }
+    results.bpm = frameRate * 60.0f / beat.period;
+  } else {
+    beat.phase = 0.0f;
+    results.bpm = 0.0f;
+  }
+  results.beatPhase = min(255, int(beat.phase * 256.0f));
+  results.onsetStrength = beat.strength;
+}
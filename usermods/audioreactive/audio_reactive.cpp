@@ -58,6 +58,7 @@ static uint8_t audioSyncEnabled = 0;          // bit field: bit 0 - send, bit 1
 static bool udpSyncConnected = false;         // UDP connection status -> true if connected to multicast group
 
 #define NUM_GEQ_CHANNELS 16                                           // number of frequency channels. Don't change !!
+#define MAX_GEQ_BANDS 32                                              // maximum number of GEQ bands (configurable band layout)
 
 // audioreactive variables
 #ifdef ARDUINO_ARCH_ESP32
@@ -76,7 +77,18 @@ static float FFT_Magnitude = 0.0f;              // FFT: volume (magnitude) of pe
 static bool samplePeak = false;      // Boolean flag for peak - used in effects. Responding routine may reset this flag. Auto-reset after strip.getFrameTime()
 static bool udpSamplePeak = false;   // Boolean flag for peak. Set at the same time as samplePeak, but reset by transmitAudioData
 static unsigned long timeOfPeak = 0; // time of last sample peak detection.
+static uint8_t onsetStrength = 0;    // strength of the last onset 0..255, decays (beat tracker)
+static float beatBPM = 0.0f;         // tempo (BPM) found by the beat tracker, 0 = unknown
+static uint8_t beatPhase = 0;        // position within the current beat 0..255, 0 = on the beat
 static uint8_t fftResult[NUM_GEQ_CHANNELS]= {0};// Our calculated freq. channel result table to be used by effects
+static uint8_t geqResult[MAX_GEQ_BANDS] = {0};  // GEQ bands of the configured layout (16, 24 or 32), for effects that can show more than 16 channels
+static uint8_t geqBands = NUM_GEQ_CHANNELS;     // number of bands in geqResult[] - always 16 in audio sync receive mode
+
+// GEQ bands are the 16 channels (audio sync receive mode, reset)
+static void geqFromChannels() {
+  memcpy(geqResult, fftResult, NUM_GEQ_CHANNELS);
+  geqBands = NUM_GEQ_CHANNELS;
+}
 
 // TODO: probably best not used by receive nodes
 //static float agcSensitivity = 128;            // AGC sensitivity estimation, based on agc gain (multAgc). calculated by getSensitivity(). range 0..255
@@ -90,18 +102,18 @@ static bool limiterOn = true;
 static uint16_t attackTime =  80;             // int: attack time in milliseconds. Default 0.08sec
 static uint16_t decayTime = 1400;             // int: decay time in milliseconds.  Default 1.40sec
 
-// peak detection
-#ifdef ARDUINO_ARCH_ESP32
-static void detectSamplePeak(void);  // peak detection function (needs scaled FFT results in vReal[]) - no used for 8266 receive-only mode
-#endif
+// peak detection - samplePeak is set on every onset found by the beat tracker (detectBeats() in audio_fft.h)
 static void autoResetPeak(void);     // peak auto-reset function
-static uint8_t maxVol = 31;          // (was 10) Reasonable value for constant volume for 'peak detector', as it won't always trigger  (deprecated)
-static uint8_t binNum = 8;           // Used to select the bin for FFT based beat detection  (deprecated)
+static uint8_t maxVol = 31;          // (was 10) Reasonable value for constant volume for 'peak detector', as it won't always trigger  (deprecated, not used any more)
+static uint8_t binNum = 8;           // Used to select the bin for FFT based beat detection  (deprecated, not used any more)
 
 #ifdef ARDUINO_ARCH_ESP32
 
 // use audio source class (ESP32 specific)
 #include "audio_source.h"
+
+// FFT pipeline (filtering, FFT, GEQ channels) - FFT backend object is created in FFTcode
+#include "audio_fft.h"
 constexpr i2s_port_t I2S_PORT = I2S_NUM_0;       // I2S port to use (do not change !)
 constexpr int BLOCK_SIZE = 128;                  // I2S buffer size (samples)
 
@@ -119,6 +131,10 @@ static uint8_t inputLevel = 128;              // UI slider value
 #endif
 // user settable options for FFTResult scaling
 static uint8_t FFTScalingMode = 3;            // 0 none; 1 optimized logarithmic; 2 optimized linear; 3 optimized square root
+// user settable GEQ band layout
+static uint8_t  numGEQBands = NUM_GEQ_CHANNELS;           // 16 (hand-tuned layout), 24 or 32 (log-spaced between geqMinFreq and geqMaxFreq)
+static uint16_t geqMinFreq = UM_AUDIOREACTIVE_GEQ_MIN_FREQ;
+static uint16_t geqMaxFreq = UM_AUDIOREACTIVE_GEQ_MAX_FREQ;
 
 // 
 // AGC presets
@@ -147,16 +163,10 @@ static bool useBandPassFilter = false;                    // if true, enables a
 ////////////////////
 
 // some prototypes, to ensure consistent interfaces
-static float fftAddAvg(int from, int to);   // average of several FFT result bins
 void FFTcode(void * parameter);      // audio processing task: read samples, run FFT, fill GEQ channels from FFT results
-static void runMicFilter(uint16_t numSamples, float *sampleBuffer);          // pre-filtering of raw samples (band-pass)
-static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels); // post-processing and post-amp of GEQ channels
 
 static TaskHandle_t FFT_Task = nullptr;
 
-// Table of multiplication factors so that we can even out the frequency response.
-static float fftResultPink[NUM_GEQ_CHANNELS] = { 1.70f, 1.71f, 1.73f, 1.78f, 1.68f, 1.56f, 1.55f, 1.63f, 1.79f, 1.62f, 1.80f, 2.06f, 2.47f, 3.35f, 6.83f, 9.55f };
-
 // globals and FFT Output variables shared with animations
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
 static uint64_t fftTime = 0;
@@ -164,8 +174,13 @@ static uint64_t sampleTime = 0;
 #endif
 
 // FFT Task variables (filtering and post-processing)
-static float   fftCalc[NUM_GEQ_CHANNELS] = {0.0f};                    // Try and normalize fftBin values to a max of 4096, so that 4096/16 = 256.
-static float   fftAvg[NUM_GEQ_CHANNELS] = {0.0f};                     // Calculated frequency channel results, with smoothing (used if dynamics limiter is ON)
+static FFTState fftState;                                             // filter and smoothing state of the FFT pipeline (see audio_fft.h)
+static BeatState beatState;                                           // onset detector / beat tracker state
+static unsigned long fftCaptureTime = 0;                              // millis() when the last FFT results were published (capture time for audio sync)
+// GEQ bands are handed over to loop() which publishes them to geqResult[]/geqBands, so effects never see a band count that does not match the bands
+static uint8_t geqStage[MAX_GEQ_BANDS] = {0};
+static volatile uint8_t geqStageBands = 0;                            // 0 = no new bands
+static portMUX_TYPE geqStageMux = portMUX_INITIALIZER_UNLOCKED;       // FFT task and loop() run concurrently
 #ifdef SR_DEBUG
 static float   fftResultMax[NUM_GEQ_CHANNELS] = {0.0f};               // A table used for testing to determine how our post-processing is working.
 #endif
@@ -175,43 +190,19 @@ constexpr SRate_t SAMPLE_RATE = 22050;        // Base sample rate in Hz - 22Khz
 //constexpr SRate_t SAMPLE_RATE = 16000;        // 16kHz - use if FFTtask takes more than 20ms. Physical sample time -> 32ms
 //constexpr SRate_t SAMPLE_RATE = 20480;        // Base sample rate in Hz - 20Khz is experimental.    Physical sample time -> 25ms
 //constexpr SRate_t SAMPLE_RATE = 10240;        // Base sample rate in Hz - previous default.         Physical sample time -> 50ms
+#if FFT_OVERLAP
+#define FFT_MIN_CYCLE 10                      // minimum time before FFT task is repeated. Use with 22Khz sampling and 256 new samples per batch
+#else
 #define FFT_MIN_CYCLE 21                      // minimum time before FFT task is repeated. Use with 22Khz sampling
+#endif
 //#define FFT_MIN_CYCLE 30                      // Use with 16Khz sampling
 //#define FFT_MIN_CYCLE 23                      // minimum time before FFT task is repeated. Use with 20Khz sampling
 //#define FFT_MIN_CYCLE 46                      // minimum time before FFT task is repeated. Use with 10Khz sampling
 
-// FFT Constants
-constexpr uint16_t samplesFFT = 512;            // Samples in an FFT batch - This value MUST ALWAYS be a power of 2
-constexpr uint16_t samplesFFT_2 = 256;          // meaningfull part of FFT results - only the "lower half" contains useful information.
-// the following are observed values, supported by a bit of "educated guessing"
-//#define FFT_DOWNSCALE 0.65f                             // 20kHz - downscaling factor for FFT results - "Flat-Top" window @20Khz, old freq channels 
-#define FFT_DOWNSCALE 0.46f                             // downscaling factor for FFT results - for "Flat-Top" window @22Khz, new freq channels
-#define LOG_256  5.54517744f                            // log(256)
-
 // These are the input and output vectors.  Input vectors receive computed results from FFT.
 static float* vReal = nullptr;                  // FFT sample inputs / freq output -  these are our raw result bins
 static float* vImag = nullptr;                  // imaginary parts
 
-// Create FFT object
-// lib_deps += https://github.com/kosme/arduinoFFT#develop @ 1.9.2
-// these options actually cause slow-downs on all esp32 processors, don't use them.
-// #define FFT_SPEED_OVER_PRECISION     // enables use of reciprocals (1/x etc) - not faster on ESP32
-// #define FFT_SQRT_APPROXIMATION       // enables "quake3" style inverse sqrt  - slower on ESP32
-// Below options are forcing ArduinoFFT to use sqrtf() instead of sqrt()
-// #define sqrt_internal sqrtf          // see https://github.com/kosme/arduinoFFT/pull/83 - since v2.0.0 this must be done in build_flags
-
-#include <arduinoFFT.h>             // FFT object is created in FFTcode
-// Helper functions
-
-// compute average of several FFT result bins
-static float fftAddAvg(int from, int to) {
-  float result = 0.0f;
-  for (int i = from; i <= to; i++) {
-    result += vReal[i];
-  }
-  return result / float(to - from + 1);
-}
-
 //
 // FFT main task
 //
@@ -228,8 +219,13 @@ void FFTcode(void * parameter)
     if (vImag) free(vImag); vImag = nullptr;
     return;
   }
-  // Create FFT object with weighing factor storage
-  ArduinoFFT<float> FFT = ArduinoFFT<float>( vReal, vImag, samplesFFT, SAMPLE_RATE, true);
+  // Create FFT backend (window and twiddle tables)
+  FFTBackend FFT(vReal, vImag, SAMPLE_RATE);
+  if (!FFT.isReady()) {
+    free(vReal); vReal = nullptr;
+    free(vImag); vImag = nullptr;
+    return;
+  }
 
   // see https://www.freertos.org/vtaskdelayuntil.html
   const TickType_t xFrequency = FFT_MIN_CYCLE * portTICK_PERIOD_MS;  
@@ -247,12 +243,32 @@ void FFTcode(void * parameter)
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
     uint64_t start = esp_timer_get_time();
-    bool haveDoneFFT = false; // indicates if second measurement (FFT time) is valid
 #endif
 
-    // get a fresh batch of samples from I2S
-    if (audioSource) audioSource->getSamples(vReal, samplesFFT);
-    memset(vImag, 0, samplesFFT * sizeof(float));   // set imaginary parts to 0
+    FFTSettings settings;
+    settings.sampleAvg      = sampleAvg;
+    settings.multAgc        = multAgc;
+    settings.soundAgc       = soundAgc;
+    settings.sampleGain     = sampleGain;
+    settings.inputLevel     = inputLevel;
+    settings.scalingMode    = FFTScalingMode;
+    settings.bandPassFilter = useBandPassFilter;
+    settings.limiterOn      = limiterOn;
+    settings.decayTime      = decayTime;
+    settings.geqBands       = numGEQBands;
+    settings.geqMinFreq     = geqMinFreq;
+    settings.geqMaxFreq     = geqMaxFreq;
+    settings.sampleRate     = SAMPLE_RATE;
+#if !defined(I2S_GRAB_ADC1_COMPLETELY)
+    if (audioSource && audioSource->getType() == AudioSource::Type_I2SAdc)
+      settings.overlap      = false; // ADC is switched off between reads, samples of consecutive batches are not continuous
+#endif
+#ifdef SR_DEBUG
+    settings.forceFFT       = true;  // this allows measure FFT runtimes, as it disables the "only when needed" optimization
+#endif
+
+    // get a fresh batch of samples from I2S (appended to the sliding FFT window)
+    if (audioSource) audioSource->getSamples(fftNewSamples(fftState, settings), fftBatchSamples(settings));
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
     if (start < esp_timer_get_time()) { // filter out overflows
@@ -264,131 +280,43 @@ void FFTcode(void * parameter)
 
     xLastWakeTime = xTaskGetTickCount();       // update "last unblocked time" for vTaskDelay
 
-    // band pass filter - can reduce noise floor by a factor of 50
-    // downside: frequencies below 100Hz will be ignored
-    if (useBandPassFilter) runMicFilter(samplesFFT, vReal);
-
-    // find highest sample in the batch
-    float maxSample = 0.0f;                         // max sample from FFT batch
-    for (int i=0; i < samplesFFT; i++) {
-	    // pick our  our current mic sample - we take the max value from all samples that go into FFT
-	    if ((vReal[i] <= (INT16_MAX - 1024)) && (vReal[i] >= (INT16_MIN + 1024)))  //skip extreme values - normally these are artefacts
-        if (fabsf((float)vReal[i]) > maxSample) maxSample = fabsf((float)vReal[i]);
-    }
+    // band pass filter and highest sample in the batch
     // release highest sample to volume reactive effects early - not strictly necessary here - could also be done at the end of the function
     // early release allows the filters (getSample() and agcAvg()) to work with fresh values - we will have matching gain and noise gate values when we want to process the FFT results.
-    micDataReal = maxSample;
-
-#ifdef SR_DEBUG
-    if (true) {  // this allows measure FFT runtimes, as it disables the "only when needed" optimization 
-#else
-    if (sampleAvg > 0.25f) { // noise gate open means that FFT results will be used. Don't run FFT if results are not needed.
-#endif
-
-      // run FFT (takes 3-5ms on ESP32, ~12ms on ESP32-S2)
-      FFT.dcRemoval();                                            // remove DC offset
-      FFT.windowing( FFTWindow::Flat_top, FFTDirection::Forward); // Weigh data using "Flat Top" function - better amplitude accuracy
-      //FFT.windowing(FFTWindow::Blackman_Harris, FFTDirection::Forward);  // Weigh data using "Blackman- Harris" window - sharp peaks due to excellent sideband rejection
-      FFT.compute( FFTDirection::Forward );                       // Compute FFT
-      FFT.complexToMagnitude();                                   // Compute magnitudes
-      vReal[0] = 0;   // The remaining DC offset on the signal produces a strong spike on position 0 that should be eliminated to avoid issues.
-
-      FFT.majorPeak(&FFT_MajorPeak, &FFT_Magnitude);                // let the effects know which freq was most dominant
-      FFT_MajorPeak = constrain(FFT_MajorPeak, 1.0f, 11025.0f);   // restrict value to range expected by effects
-
-#if defined(WLED_DEBUG) || defined(SR_DEBUG)
-      haveDoneFFT = true;
-#endif
-
-    } else { // noise gate closed - only clear results as FFT was skipped. MIC samples are still valid when we do this.
-      memset(vReal, 0, samplesFFT * sizeof(float));
-      FFT_MajorPeak = 1;
-      FFT_Magnitude = 0.001;
-    }
-
-    for (int i = 0; i < samplesFFT; i++) {
-      float t = fabsf(vReal[i]);                      // just to be sure - values in fft bins should be positive any way
-      vReal[i] = t / 16.0f;                           // Reduce magnitude. Want end result to be scaled linear and ~4096 max.
-    } // for()
-
-    // mapping of FFT result bins to frequency channels
-    if (fabsf(sampleAvg) > 0.5f) { // noise gate open
-#if 0
-    /* This FFT post processing is a DIY endeavour. What we really need is someone with sound engineering expertise to do a great job here AND most importantly, that the animations look GREAT as a result.
-    *
-    * Andrew's updated mapping of 256 bins down to the 16 result bins with Sample Freq = 10240, samplesFFT = 512 and some overlap.
-    * Based on testing, the lowest/Start frequency is 60 Hz (with bin 3) and a highest/End frequency of 5120 Hz in bin 255.
-    * Now, Take the 60Hz and multiply by 1.320367784 to get the next frequency and so on until the end. Then determine the bins.
-    * End frequency = Start frequency * multiplier ^ 16
-    * Multiplier = (End frequency/ Start frequency) ^ 1/16
-    * Multiplier = 1.320367784
-    */                                    //  Range
-      fftCalc[ 0] = fftAddAvg(2,4);       // 60 - 100
-      fftCalc[ 1] = fftAddAvg(4,5);       // 80 - 120
-      fftCalc[ 2] = fftAddAvg(5,7);       // 100 - 160
-      fftCalc[ 3] = fftAddAvg(7,9);       // 140 - 200
-      fftCalc[ 4] = fftAddAvg(9,12);      // 180 - 260
-      fftCalc[ 5] = fftAddAvg(12,16);     // 240 - 340
-      fftCalc[ 6] = fftAddAvg(16,21);     // 320 - 440
-      fftCalc[ 7] = fftAddAvg(21,29);     // 420 - 600
-      fftCalc[ 8] = fftAddAvg(29,37);     // 580 - 760
-      fftCalc[ 9] = fftAddAvg(37,48);     // 740 - 980
-      fftCalc[10] = fftAddAvg(48,64);     // 960 - 1300
-      fftCalc[11] = fftAddAvg(64,84);     // 1280 - 1700
-      fftCalc[12] = fftAddAvg(84,111);    // 1680 - 2240
-      fftCalc[13] = fftAddAvg(111,147);   // 2220 - 2960
-      fftCalc[14] = fftAddAvg(147,194);   // 2940 - 3900
-      fftCalc[15] = fftAddAvg(194,250);   // 3880 - 5000 // avoid the last 5 bins, which are usually inaccurate
-#else
-      /* new mapping, optimized for 22050 Hz by softhack007 */
-                                                    // bins frequency  range
-      if (useBandPassFilter) {
-        // skip frequencies below 100hz
-        fftCalc[ 0] = 0.8f * fftAddAvg(3,4);
-        fftCalc[ 1] = 0.9f * fftAddAvg(4,5);
-        fftCalc[ 2] = fftAddAvg(5,6);
-        fftCalc[ 3] = fftAddAvg(6,7);
-        // don't use the last bins from 206 to 255. 
-        fftCalc[15] = fftAddAvg(165,205) * 0.75f;   // 40 7106 - 8828 high             -- with some damping
-      } else {
-        fftCalc[ 0] = fftAddAvg(1,2);               // 1    43 - 86   sub-bass
-        fftCalc[ 1] = fftAddAvg(2,3);               // 1    86 - 129  bass
-        fftCalc[ 2] = fftAddAvg(3,5);               // 2   129 - 216  bass
-        fftCalc[ 3] = fftAddAvg(5,7);               // 2   216 - 301  bass + midrange
-        // don't use the last bins from 216 to 255. They are usually contaminated by aliasing (aka noise) 
-        fftCalc[15] = fftAddAvg(165,215) * 0.70f;   // 50 7106 - 9259 high             -- with some damping
-      }
-      fftCalc[ 4] = fftAddAvg(7,10);                // 3   301 - 430  midrange
-      fftCalc[ 5] = fftAddAvg(10,13);               // 3   430 - 560  midrange
-      fftCalc[ 6] = fftAddAvg(13,19);               // 5   560 - 818  midrange
-      fftCalc[ 7] = fftAddAvg(19,26);               // 7   818 - 1120 midrange -- 1Khz should always be the center !
-      fftCalc[ 8] = fftAddAvg(26,33);               // 7  1120 - 1421 midrange
-      fftCalc[ 9] = fftAddAvg(33,44);               // 9  1421 - 1895 midrange
-      fftCalc[10] = fftAddAvg(44,56);               // 12 1895 - 2412 midrange + high mid
-      fftCalc[11] = fftAddAvg(56,70);               // 14 2412 - 3015 high mid
-      fftCalc[12] = fftAddAvg(70,86);               // 16 3015 - 3704 high mid
-      fftCalc[13] = fftAddAvg(86,104);              // 18 3704 - 4479 high mid
-      fftCalc[14] = fftAddAvg(104,165) * 0.88f;     // 61 4479 - 7106 high mid + high  -- with slight damping
-#endif
-    } else {  // noise gate closed - just decay old values
-      for (int i=0; i < NUM_GEQ_CHANNELS; i++) {
-        fftCalc[i] *= 0.85f;  // decay to zero
-        if (fftCalc[i] < 4.0f) fftCalc[i] = 0.0f;
-      }
-    }
-
-    // post-processing of frequency channels (pink noise adjustment, AGC, smoothing, scaling)
-    postProcessFFTResults((fabsf(sampleAvg) > 0.25f)? true : false , NUM_GEQ_CHANNELS);
+    micDataReal = preProcessFFTSamples(fftState, settings, vReal);
+
+    // FFT, mapping of FFT result bins to frequency channels and post-processing of frequency channels
+    FFTResults results;
+    processFFTBatch(FFT, vReal, fftState, settings, results);
+    FFT_MajorPeak = results.majorPeak;
+    FFT_Magnitude = results.magnitude;
+    memcpy(fftResult, results.fftResult, sizeof(fftResult));
+    portENTER_CRITICAL(&geqStageMux);
+    memcpy(geqStage, results.geqResult, results.numBands);
+    geqStageBands = results.numBands;
+    portEXIT_CRITICAL(&geqStageMux);
+    fftCaptureTime = millis();
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
-    if (haveDoneFFT && (start < esp_timer_get_time())) { // filter out overflows
+    if (results.haveFFT && (start < esp_timer_get_time())) { // filter out overflows
       uint64_t fftTimeInMillis = ((esp_timer_get_time() - start) +5ULL) / 10ULL; // "+5" to ensure proper rounding
       fftTime  = (fftTimeInMillis*3 + fftTime*7)/10; // smooth
     }
 #endif
+    // onset detection and beat tracking (needs scaled FFT results in vReal[])
+    BeatResults beat;
+    detectBeats(beatState, settings, vReal, results.haveFFT, beat);
+    onsetStrength = beat.onsetStrength;
+    beatBPM       = beat.bpm;
+    beatPhase     = beat.beatPhase;
+
     // run peak detection
     autoResetPeak();
-    detectSamplePeak();
+    if (beat.onset) {
+      samplePeak    = true;
+      timeOfPeak    = millis();
+      udpSamplePeak = true;
+    }
     
     #if !defined(I2S_GRAB_ADC1_COMPLETELY)    
     if ((audioSource == nullptr) || (audioSource->getType() != AudioSource::Type_I2SAdc))  // the "delay trick" does not help for analog ADC
@@ -399,140 +327,13 @@ void FFTcode(void * parameter)
 } // FFTcode() task end
 
 
-///////////////////////////
-// Pre / Postprocessing  //
-///////////////////////////
-
-static void runMicFilter(uint16_t numSamples, float *sampleBuffer)          // pre-filtering of raw samples (band-pass)
-{
-  // low frequency cutoff parameter - see https://dsp.stackexchange.com/questions/40462/exponential-moving-average-cut-off-frequency
-  //constexpr float alpha = 0.04f;   // 150Hz
-  //constexpr float alpha = 0.03f;   // 110Hz
-  constexpr float alpha = 0.0225f; // 80hz
-  //constexpr float alpha = 0.01693f;// 60hz
-  // high frequency cutoff  parameter
-  //constexpr float beta1 = 0.75f;   // 11Khz
-  //constexpr float beta1 = 0.82f;   // 15Khz
-  //constexpr float beta1 = 0.8285f; // 18Khz
-  constexpr float beta1 = 0.85f;  // 20Khz
-
-  constexpr float beta2 = (1.0f - beta1) / 2.0f;
-  static float last_vals[2] = { 0.0f }; // FIR high freq cutoff filter
-  static float lowfilt = 0.0f;          // IIR low frequency cutoff filter
-
-  for (int i=0; i < numSamples; i++) {
-        // FIR lowpass, to remove high frequency noise
-        float highFilteredSample;
-        if (i < (numSamples-1)) highFilteredSample = beta1*sampleBuffer[i] + beta2*last_vals[0] + beta2*sampleBuffer[i+1];  // smooth out spikes
-        else highFilteredSample = beta1*sampleBuffer[i] + beta2*last_vals[0]  + beta2*last_vals[1];                  // special handling for last sample in array
-        last_vals[1] = last_vals[0];
-        last_vals[0] = sampleBuffer[i];
-        sampleBuffer[i] = highFilteredSample;
-        // IIR highpass, to remove low frequency noise
-        lowfilt += alpha * (sampleBuffer[i] - lowfilt);
-        sampleBuffer[i] = sampleBuffer[i] - lowfilt;
-  }
-}
-
-static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) // post-processing and post-amp of GEQ channels
-{
-    for (int i=0; i < numberOfChannels; i++) {
-
-      if (noiseGateOpen) { // noise gate open
-        // Adjustment for frequency curves.
-        fftCalc[i] *= fftResultPink[i];
-        if (FFTScalingMode > 0) fftCalc[i] *= FFT_DOWNSCALE;  // adjustment related to FFT windowing function
-        // Manual linear adjustment of gain using sampleGain adjustment for different input types.
-        fftCalc[i] *= soundAgc ? multAgc : ((float)sampleGain/40.0f * (float)inputLevel/128.0f + 1.0f/16.0f); //apply gain, with inputLevel adjustment
-        if(fftCalc[i] < 0) fftCalc[i] = 0;
-      }
-
-      // smooth results - rise fast, fall slower
-      if(fftCalc[i] > fftAvg[i])   // rise fast 
-        fftAvg[i] = fftCalc[i] *0.75f + 0.25f*fftAvg[i];  // will need approx 2 cycles (50ms) for converging against fftCalc[i]
-      else {                       // fall slow
-        if (decayTime < 1000) fftAvg[i] = fftCalc[i]*0.22f + 0.78f*fftAvg[i];       // approx  5 cycles (225ms) for falling to zero
-        else if (decayTime < 2000) fftAvg[i] = fftCalc[i]*0.17f + 0.83f*fftAvg[i];  // default - approx  9 cycles (225ms) for falling to zero
-        else if (decayTime < 3000) fftAvg[i] = fftCalc[i]*0.14f + 0.86f*fftAvg[i];  // approx 14 cycles (350ms) for falling to zero
-        else fftAvg[i] = fftCalc[i]*0.1f  + 0.9f*fftAvg[i];                         // approx 20 cycles (500ms) for falling to zero
-      }
-      // constrain internal vars - just to be sure
-      fftCalc[i] = constrain(fftCalc[i], 0.0f, 1023.0f);
-      fftAvg[i] = constrain(fftAvg[i], 0.0f, 1023.0f);
-
-      float currentResult;
-      if(limiterOn == true)
-        currentResult = fftAvg[i];
-      else
-        currentResult = fftCalc[i];
-
-      switch (FFTScalingMode) {
-        case 1:
-            // Logarithmic scaling
-            currentResult *= 0.42f;                      // 42 is the answer ;-)
-            currentResult -= 8.0f;                       // this skips the lowest row, giving some room for peaks
-            if (currentResult > 1.0f) currentResult = logf(currentResult); // log to base "e", which is the fastest log() function
-            else currentResult = 0.0f;                   // special handling, because log(1) = 0; log(0) = undefined
-            currentResult *= 0.85f + (float(i)/18.0f);  // extra up-scaling for high frequencies
-            currentResult = mapf(currentResult, 0, LOG_256, 0, 255); // map [log(1) ... log(255)] to [0 ... 255]
-        break;
-        case 2:
-            // Linear scaling
-            currentResult *= 0.30f;                     // needs a bit more damping, get stay below 255
-            currentResult -= 4.0f;                       // giving a bit more room for peaks
-            if (currentResult < 1.0f) currentResult = 0.0f;
-            currentResult *= 0.85f + (float(i)/1.8f);   // extra up-scaling for high frequencies
-        break;
-        case 3:
-            // square root scaling
-            currentResult *= 0.38f;
-            currentResult -= 6.0f;
-            if (currentResult > 1.0f) currentResult = sqrtf(currentResult);
-            else currentResult = 0.0f;                   // special handling, because sqrt(0) = undefined
-            currentResult *= 0.85f + (float(i)/4.5f);   // extra up-scaling for high frequencies
-            currentResult = mapf(currentResult, 0.0, 16.0, 0.0, 255.0); // map [sqrt(1) ... sqrt(256)] to [0 ... 255]
-        break;
-
-        case 0:
-        default:
-            // no scaling - leave freq bins as-is
-            currentResult -= 4; // just a bit more room for peaks
-        break;
-      }
+#endif
 
-      // Now, let's dump it all into fftResult. Need to do this, otherwise other routines might grab fftResult values prematurely.
-      if (soundAgc > 0) {  // apply extra "GEQ Gain" if set by user
-        float post_gain = (float)inputLevel/128.0f;
-        if (post_gain < 1.0f) post_gain = ((post_gain -1.0f) * 0.8f) +1.0f;
-        currentResult *= post_gain;
-      }
-      fftResult[i] = constrain((int)currentResult, 0, 255);
-    }
-}
 ////////////////////
 // Peak detection //
 ////////////////////
 
-// peak detection is called from FFT task when vReal[] contains valid FFT results
-static void detectSamplePeak(void) {
-  bool havePeak = false;
-  // softhack007: this code continuously triggers while amplitude in the selected bin is above a certain threshold. So it does not detect peaks - it detects high activity in a frequency bin.
-  // Poor man's beat detection by seeing if sample > Average + some value.
-  // This goes through ALL of the 255 bins - but ignores stupid settings
-  // Then we got a peak, else we don't. The peak has to time out on its own in order to support UDP sound sync.
-  if ((sampleAvg > 1) && (maxVol > 0) && (binNum > 4) && (vReal[binNum] > maxVol) && ((millis() - timeOfPeak) > 100)) {
-    havePeak = true;
-  }
-
-  if (havePeak) {
-    samplePeak    = true;
-    timeOfPeak    = millis();
-    udpSamplePeak = true;
-  }
-}
-
-#endif
-
+// the peak has to time out on its own in order to support UDP sound sync
 static void autoResetPeak(void) {
   uint16_t peakDelay = max(uint16_t(50), strip.getFrameTime());
   if (millis() - timeOfPeak > peakDelay) {          // Auto-reset of samplePeak after at least one complete frame has passed.
@@ -588,13 +389,14 @@ class AudioReactive : public Usermod {
     // new "V2" audiosync struct - 44 Bytes
     struct __attribute__ ((packed)) audioSyncPacket {  // "packed" ensures that there are no additional gaps
       char    header[6];      //  06 Bytes  offset 0
-      uint8_t reserved1[2];   //  02 Bytes, offset 6  - gap required by the compiler - not used yet 
+      uint8_t onsetStrength;  //  01 Bytes, offset 6  - onset strength 0..255 (was reserved, 0 from older senders)
+      uint8_t reserved1;      //  01 Bytes, offset 7  - gap required by the compiler - not used yet
       float   sampleRaw;      //  04 Bytes  offset 8  - either "sampleRaw" or "rawSampleAgc" depending on soundAgc setting
       float   sampleSmth;     //  04 Bytes  offset 12 - either "sampleAvg" or "sampleAgc" depending on soundAgc setting
-      uint8_t samplePeak;     //  01 Bytes  offset 16 - 0 no peak; >=1 peak detected. In future, this will also provide peak Magnitude
-      uint8_t reserved2;      //  01 Bytes  offset 17 - for future extensions - not used yet
+      uint8_t samplePeak;     //  01 Bytes  offset 16 - 0 no peak; >=1 peak (onset) detected
+      uint8_t beatPhase;      //  01 Bytes  offset 17 - beat phase 0..255 (was reserved, 0 from older senders)
       uint8_t fftResult[16];  //  16 Bytes  offset 18
-      uint16_t reserved3;     //  02 Bytes, offset 34 - gap required by the compiler - not used yet
+      uint16_t beatBPM;       //  02 Bytes, offset 34 - tempo in 1/100 BPM, 0 = unknown (was reserved, 0 from older senders)
       float  FFT_Magnitude;   //  04 Bytes  offset 36
       float  FFT_MajorPeak;   //  04 Bytes  offset 40
     };
@@ -612,7 +414,18 @@ class AudioReactive : public Usermod {
       double FFT_MajorPeak;   //  08 Bytes
     };
 
+    // "V3" audiosync struct - 52 Bytes: V2 data plus capture time and sequence number, so receivers can present it in sync (see syncLatency)
+    struct __attribute__ ((packed)) audioSyncPacket_v3 {
+      audioSyncPacket data;   //  44 Bytes  offset 0  - same as V2 (with header "00003")
+      uint32_t captureTime;   //  04 Bytes  offset 44 - toki time (seconds * 1000 + ms, wraps around) when the FFT results were captured
+      uint8_t  timeSource;    //  01 Bytes  offset 48 - toki time source of the sender (TOKI_TS_xx), >99: clock is millisecond accurate
+      uint8_t  reserved;      //  01 Bytes  offset 49 - not used yet
+      uint16_t sequence;      //  02 Bytes  offset 50 - packet counter
+    };
+
     #define UDPSOUND_MAX_PACKET 88 // max packet size for audiosync
+    #define SYNC_PLAYOUT_SIZE  10  // V3 playout buffer size (packets) - 200ms at 50 packets per second
+    #define SYNC_MAX_LATENCY  200  // ms
 
     // set your config variables to their boot default value (this can also be done in readFromConfig() or a constructor if you prefer)
     #ifdef UM_AUDIOREACTIVE_ENABLE
@@ -630,6 +443,31 @@ class AudioReactive : public Usermod {
     unsigned long lastTime = 0;   // last time of running UDP Microphone Sync
     const uint16_t delayMs = 10;  // I don't want to sample too often and overload WLED
     uint16_t audioSyncPort= 11988;// default port for UDP sound sync
+    #ifndef UM_AUDIOREACTIVE_SYNC_LATENCY
+    uint16_t syncLatency = 0;     // receive: V3 packets are presented at capture time + syncLatency ms (config value), 0 = when they arrive
+    #else
+    uint16_t syncLatency = UM_AUDIOREACTIVE_SYNC_LATENCY;
+    #endif
+#ifdef ARDUINO_ARCH_ESP32
+    #ifndef UM_AUDIOREACTIVE_SYNC_VERSION
+    uint8_t  syncVersion = 2;     // send: packet format (config value), 2 = compatible with older firmware, 3 = with capture time
+    #else
+    uint8_t  syncVersion = UM_AUDIOREACTIVE_SYNC_VERSION;
+    #endif
+    uint16_t syncSequence = 0;    // send: V3 packet counter
+#endif
+
+    // V3 receive: playout buffer (V2 part of the packets, ring buffer) and sender clock
+    audioSyncPacket playoutBuffer[SYNC_PLAYOUT_SIZE];
+    unsigned long playoutTime[SYNC_PLAYOUT_SIZE]; // millis() when the packet is due
+    uint8_t playoutFirst = 0;
+    uint8_t playoutCount = 0;
+    bool     syncHaveSequence = false;
+    uint16_t syncLastSequence = 0;
+    bool     syncClockValid = false;
+    uint32_t syncClockOffset = 0; // millis() - capture time of the fastest packet (shortest network delay)
+    uint32_t syncClockMin = 0;    // fastest packet of the current window, replaces syncClockOffset at the end of the window
+    unsigned long syncClockTime = 0;
 
     bool updateIsRunning = false; // true during OTA.
 
@@ -656,7 +494,7 @@ class AudioReactive : public Usermod {
 
     // used to feed "Info" Page
     unsigned long last_UDPTime = 0;    // time of last valid UDP sound sync datapacket
-    int receivedFormat = 0;            // last received UDP sound sync format - 0=none, 1=v1 (0.13.x), 2=v2 (0.14.x)
+    int receivedFormat = 0;            // last received UDP sound sync format - 0=none, 1=v1 (0.13.x), 2=v2 (0.14.x), 3=v3
     float maxSample5sec = 0.0f;        // max sample (after AGC) in last 5 seconds 
     unsigned long sampleMaxTimer = 0;  // last time maxSample5sec was reset
     #define CYCLE_SAMPLEMAX 3500       // time window for merasuring
@@ -675,6 +513,7 @@ class AudioReactive : public Usermod {
     static const char _addPalettes[];
     static const char UDP_SYNC_HEADER[];
     static const char UDP_SYNC_HEADER_v1[];
+    static const char UDP_SYNC_HEADER_v3[];
 
     // private methods
     void removeAudioPalettes(void);
@@ -912,12 +751,6 @@ class AudioReactive : public Usermod {
       // keep "peak" sample, but decay value if current sample is below peak
       if ((sampleMax < sampleReal) && (sampleReal > 0.5f)) {
         sampleMax = sampleMax + 0.5f * (sampleReal - sampleMax);  // new peak - with some filtering
-        // another simple way to detect samplePeak - cannot detect beats, but reacts on peak volume
-        if (((binNum < 12) || ((maxVol < 1))) && (millis() - timeOfPeak > 80) && (sampleAvg > 1)) {
-          samplePeak    = true;
-          timeOfPeak    = millis();
-          udpSamplePeak = true;
-        }
       } else {
         if ((multAgc*sampleMax > agcZoneStop[AGC_preset]) && (soundAgc > 0))
           sampleMax += 0.5f * (sampleReal - sampleMax);        // over AGC Zone - get back quickly
@@ -990,15 +823,27 @@ class AudioReactive : public Usermod {
       if (!udpSyncConnected) return;
       //DEBUGSR_PRINTLN("Transmitting UDP Mic Packet");
 
-      audioSyncPacket transmitData;
-      memset(reinterpret_cast<void *>(&transmitData), 0, sizeof(transmitData)); // make sure that the packet - including "invisible" padding bytes added by the compiler - is fully initialized
-
-      strncpy_P(transmitData.header, PSTR(UDP_SYNC_HEADER), 6);
+      audioSyncPacket_v3 packet;
+      memset(reinterpret_cast<void *>(&packet), 0, sizeof(packet)); // make sure that the packet - including "invisible" padding bytes added by the compiler - is fully initialized
+      audioSyncPacket &transmitData = packet.data;
+
+      size_t packetSize = sizeof(audioSyncPacket);
+      if (syncVersion == 3) {
+        strncpy_P(transmitData.header, PSTR(UDP_SYNC_HEADER_v3), 6);
+        packetSize = sizeof(audioSyncPacket_v3);
+        packet.captureTime = tokiMillis() - (millis() - fftCaptureTime);
+        packet.timeSource  = toki.getTimeSource();
+        packet.sequence    = syncSequence++;
+      } else
+        strncpy_P(transmitData.header, PSTR(UDP_SYNC_HEADER), 6);   // V2, understood by receivers with older firmware
       // transmit samples that were not modified by limitSampleDynamics()
       transmitData.sampleRaw   = (soundAgc) ? rawSampleAgc: sampleRaw;
       transmitData.sampleSmth  = (soundAgc) ? sampleAgc   : sampleAvg;
       transmitData.samplePeak  = udpSamplePeak ? 1:0;
       udpSamplePeak            = false;           // Reset udpSamplePeak after we've transmitted it
+      transmitData.onsetStrength = onsetStrength;
+      transmitData.beatPhase   = beatPhase;
+      transmitData.beatBPM     = (uint16_t)constrain(beatBPM * 100.0f + 0.5f, 0.0f, 65535.0f);
 
       for (int i = 0; i < NUM_GEQ_CHANNELS; i++) {
         transmitData.fftResult[i] = (uint8_t)constrain(fftResult[i], 0, 254);
@@ -1008,7 +853,7 @@ class AudioReactive : public Usermod {
       transmitData.FFT_MajorPeak = FFT_MajorPeak;
 
       if (fftUdp.beginMulticastPacket() != 0) { // beginMulticastPacket returns 0 in case of error
-        fftUdp.write(reinterpret_cast<uint8_t *>(&transmitData), sizeof(transmitData));
+        fftUdp.write(reinterpret_cast<uint8_t *>(&packet), packetSize);
         fftUdp.endPacket();
       }
       return;
@@ -1022,6 +867,15 @@ class AudioReactive : public Usermod {
     static bool isValidUdpSyncVersion_v1(const char *header) {
       return strncmp_P(header, UDP_SYNC_HEADER_v1, 6) == 0;
     }
+    static bool isValidUdpSyncVersion_v3(const char *header) {
+      return strncmp_P(header, UDP_SYNC_HEADER_v3, 6) == 0;
+    }
+
+    // toki time in ms (wraps around) - comparable between devices if their clocks are synced (NTP)
+    static uint32_t tokiMillis() {
+      Toki::Time t = toki.getTime();
+      return t.sec * 1000U + t.ms;
+    }
 
     void decodeAudioData(int packetSize, uint8_t *fftBuff) {
       audioSyncPacket receivedPacket;
@@ -1049,6 +903,10 @@ class AudioReactive : public Usermod {
       }
       //These values are only computed by ESP32
       for (int i = 0; i < NUM_GEQ_CHANNELS; i++) fftResult[i] = receivedPacket.fftResult[i];
+      geqFromChannels();
+      onsetStrength = receivedPacket.onsetStrength;
+      beatPhase     = receivedPacket.beatPhase;
+      beatBPM       = receivedPacket.beatBPM / 100.0f;
       my_magnitude  = fmaxf(receivedPacket.FFT_Magnitude, 0.0f);
       FFT_Magnitude = my_magnitude;
       FFT_MajorPeak = constrain(receivedPacket.FFT_MajorPeak, 1.0f, 11025.0f);  // restrict value to range expected by effects
@@ -1077,19 +935,74 @@ class AudioReactive : public Usermod {
       }
       //These values are only available on the ESP32
       for (int i = 0; i < NUM_GEQ_CHANNELS; i++) fftResult[i] = receivedPacket->fftResult[i];
+      geqFromChannels();
+      onsetStrength = 0;   // V1 format does not have beat tracker results
+      beatPhase     = 0;
+      beatBPM       = 0.0f;
       my_magnitude  = fmaxf(receivedPacket->FFT_Magnitude, 0.0);
       FFT_Magnitude = my_magnitude;
       FFT_MajorPeak = constrain(receivedPacket->FFT_MajorPeak, 1.0, 11025.0);  // restrict value to range expected by effects
     }
 
-    bool receiveAudioData()   // check & process new data. return TRUE in case that new audio data was received. 
+    // V3 packet: put it into the playout buffer, to be presented at capture time + syncLatency
+    void queueAudioData(const audioSyncPacket_v3 &packet) {
+      // offset between the sender's clock and millis() from the fastest packet (shortest network delay)
+      // also used with NTP on both sides, as NTP is only accurate to some 10ms
+      const unsigned long now = millis();
+      const uint32_t offset = now - packet.captureTime;
+      const int32_t diff = int32_t(offset - syncClockOffset);
+      if (!syncClockValid || (diff < 0) || (diff > 1000)) {     // first packet, faster packet or sender clock changed
+        syncClockOffset = offset;
+        syncClockMin = offset;
+        syncClockValid = true;
+        syncClockTime = now;
+      } else {
+        if (int32_t(offset - syncClockMin) < 0) syncClockMin = offset;
+        if (now - syncClockTime > 10000) {                        // fastest packet of the last 10s: follows clock drift and small steps of the sender clock
+          syncClockOffset = syncClockMin;
+          syncClockMin = offset;
+          syncClockTime = now;
+        }
+      }
+      unsigned long due = packet.captureTime + syncClockOffset + syncLatency;
+      if (int32_t(due - now) > SYNC_MAX_LATENCY) due = now + syncLatency; // clocks don't agree
+      if (playoutCount == SYNC_PLAYOUT_SIZE) {                   // buffer full: present the oldest packet now
+        decodeAudioData(sizeof(audioSyncPacket), reinterpret_cast<uint8_t *>(&playoutBuffer[playoutFirst]));
+        playoutFirst = (playoutFirst + 1) % SYNC_PLAYOUT_SIZE;
+        playoutCount--;
+      }
+      const unsigned i = (playoutFirst + playoutCount) % SYNC_PLAYOUT_SIZE;
+      playoutBuffer[i] = packet.data;
+      playoutTime[i] = due;
+      playoutCount++;
+    }
+
+    // present the packets of the playout buffer that are due, returns TRUE if new audio data was presented
+    bool playoutAudioData() {
+      bool presented = false;
+      while ((playoutCount > 0) && (int32_t(millis() - playoutTime[playoutFirst]) >= 0)) {
+        decodeAudioData(sizeof(audioSyncPacket), reinterpret_cast<uint8_t *>(&playoutBuffer[playoutFirst]));
+        playoutFirst = (playoutFirst + 1) % SYNC_PLAYOUT_SIZE;
+        playoutCount--;
+        presented = true;
+      }
+      return presented;
+    }
+
+    void resetPlayout() {
+      playoutCount = 0;
+      syncHaveSequence = false;
+      syncClockValid = false;
+    }
+
+    bool receiveAudioData()   // check & process new data. return TRUE in case that new audio data was received (FALSE if it was queued for playout), every packet is read or discarded
     {
       if (!udpSyncConnected) return false;
       bool haveFreshData = false;
 
       size_t packetSize = fftUdp.parsePacket();
 #ifdef ARDUINO_ARCH_ESP32
-      if ((packetSize > 0) && ((packetSize < 5) || (packetSize > UDPSOUND_MAX_PACKET))) fftUdp.flush(); // discard invalid packets (too small or too big) - only works on esp32
+      if ((packetSize > 0) && ((packetSize <= 5) || (packetSize > UDPSOUND_MAX_PACKET))) fftUdp.flush(); // discard invalid packets (too small or too big) - only works on esp32
 #endif
       if ((packetSize > 5) && (packetSize <= UDPSOUND_MAX_PACKET)) {
         //DEBUGSR_PRINTLN("Received UDP Sync Packet");
@@ -1097,7 +1010,21 @@ class AudioReactive : public Usermod {
         fftUdp.read(fftBuff, packetSize);
 
         // VERIFY THAT THIS IS A COMPATIBLE PACKET
-        if (packetSize == sizeof(audioSyncPacket) && (isValidUdpSyncVersion((const char *)fftBuff))) {
+        if (packetSize == sizeof(audioSyncPacket_v3) && (isValidUdpSyncVersion_v3((const char *)fftBuff))) {
+          audioSyncPacket_v3 packet;
+          memcpy(&packet, fftBuff, sizeof(packet));           // don't violate alignment
+          if (millis() - last_UDPTime > 2500) resetPlayout();  // no data for a while: the sender may have restarted
+          const int16_t age = syncLastSequence - packet.sequence;
+          if (!syncHaveSequence || (age < 0) || (age > 50)) { // drop duplicate and late (out of order) packets - unless the sender restarted
+            syncHaveSequence = true;
+            syncLastSequence = packet.sequence;
+            if (syncLatency == 0) {
+              decodeAudioData(sizeof(audioSyncPacket), fftBuff);
+              haveFreshData = true;
+            } else queueAudioData(packet);                    // presented by playoutAudioData()
+          }
+          receivedFormat = 3;
+        } else if (packetSize == sizeof(audioSyncPacket) && (isValidUdpSyncVersion((const char *)fftBuff))) {
           decodeAudioData(packetSize, fftBuff);
           //DEBUGSR_PRINTLN("Finished parsing UDP Sync Packet v2");
           haveFreshData = true;
@@ -1134,7 +1061,7 @@ class AudioReactive : public Usermod {
         // usermod exchangeable data
         // we will assign all usermod exportable data here as pointers to original variables or arrays and allocate memory for pointers
         um_data = new um_data_t;
-        um_data->u_size = 8;
+        um_data->u_size = 13;
         um_data->u_type = new um_types_t[um_data->u_size];
         um_data->u_data = new void*[um_data->u_size];
         um_data->u_data[0] = &volumeSmth;      //*used (New)
@@ -1149,10 +1076,20 @@ class AudioReactive : public Usermod {
         um_data->u_type[4] = UMT_FLOAT;
         um_data->u_data[5] = &my_magnitude;   // used (New)
         um_data->u_type[5] = UMT_FLOAT;
-        um_data->u_data[6] = &maxVol;          // assigned in effect function from UI element!!! (Puddlepeak, Ripplepeak, Waterfall)
+        um_data->u_data[6] = &maxVol;          // deprecated, not used (kept for usermods and custom effects)
         um_data->u_type[6] = UMT_BYTE;
-        um_data->u_data[7] = &binNum;          // assigned in effect function from UI element!!! (Puddlepeak, Ripplepeak, Waterfall)
+        um_data->u_data[7] = &binNum;          // deprecated, not used (kept for usermods and custom effects)
         um_data->u_type[7] = UMT_BYTE;
+        um_data->u_data[8] = geqResult;        //*used (GEQ, PS GEQ 2D) - up to MAX_GEQ_BANDS bands
+        um_data->u_type[8] = UMT_BYTE_ARR;
+        um_data->u_data[9] = &geqBands;        //*used (GEQ, PS GEQ 2D) - number of bands in geqResult
+        um_data->u_type[9] = UMT_BYTE;
+        um_data->u_data[10] = &onsetStrength;  // used (New) - onset strength 0..255, decays after each onset
+        um_data->u_type[10] = UMT_BYTE;
+        um_data->u_data[11] = &beatBPM;        // used (New) - tempo in BPM, 0 = unknown
+        um_data->u_type[11] = UMT_FLOAT;
+        um_data->u_data[12] = &beatPhase;      // used (New) - position within the beat 0..255, 0 = on the beat
+        um_data->u_type[12] = UMT_BYTE;
       }
 
 
@@ -1281,6 +1218,7 @@ class AudioReactive : public Usermod {
         udpSyncConnected = false;
         fftUdp.stop();
       }
+      resetPlayout();
       
       if (audioSyncPort > 0 && (audioSyncEnabled & 0x03)) {
       #ifdef ARDUINO_ARCH_ESP32
@@ -1372,6 +1310,14 @@ class AudioReactive : public Usermod {
         } while (userloopDelay > 0);
         lastUMRun = t_now;                    // update time keeping
 
+        if (geqStageBands) {                  // publish GEQ bands of the last FFT batch (band count and bands together)
+          portENTER_CRITICAL(&geqStageMux);
+          geqBands = geqStageBands;
+          memcpy(geqResult, geqStage, geqBands);
+          geqStageBands = 0;
+          portEXIT_CRITICAL(&geqStageMux);
+        }
+
         // update samples for effects (raw, smooth) 
         volumeSmth = (soundAgc) ? sampleAgc   : sampleAvg;
         volumeRaw  = (soundAgc) ? rawSampleAgc: sampleRaw;
@@ -1393,17 +1339,19 @@ class AudioReactive : public Usermod {
       if ((audioSyncEnabled & 0x02) && udpSyncConnected) {
           // Only run the audio listener code if we're in Receive mode
           static float syncVolumeSmth = 0;
+          static uint8_t syncBeatPhase = 0;
           bool have_new_sample = false;
           if (millis() - lastTime > delayMs) {
-            have_new_sample = receiveAudioData();
-            if (have_new_sample) last_UDPTime = millis();
-#ifdef ARDUINO_ARCH_ESP32
-            else fftUdp.flush(); // Flush udp input buffers if we haven't read it - avoids hickups in receive mode. Does not work on 8266.
-#endif
+            have_new_sample = receiveAudioData(); // reads or flushes (esp32) the packet, V3 packets may be queued for later (have_new_sample = false)
             lastTime = millis();
           }
+          if (playoutAudioData()) have_new_sample = true;    // V3 packets that are due (if syncLatency > 0)
+          if (have_new_sample) last_UDPTime = millis();
           if (have_new_sample) syncVolumeSmth = volumeSmth;   // remember received sample
           else volumeSmth = syncVolumeSmth;                   // restore originally received sample for next run of dynamics limiter
+          // keep the beat phase running between packets
+          if (have_new_sample) syncBeatPhase = beatPhase;
+          else if (beatBPM > 0.0f) beatPhase = syncBeatPhase + uint8_t(uint32_t((millis() - last_UDPTime) * beatBPM * (256.0f / 60000.0f)));
           limitSampleDynamics();                              // run dynamics limiter on received volumeSmth, to hide jumps and hickups
       }
 
@@ -1472,10 +1420,10 @@ class AudioReactive : public Usermod {
       my_magnitude = 0; FFT_Magnitude = 0; FFT_MajorPeak = 1;
       multAgc = 1;
       // reset FFT data
-      memset(fftCalc, 0, sizeof(fftCalc)); 
-      memset(fftAvg, 0, sizeof(fftAvg)); 
+      fftState = FFTState();
       memset(fftResult, 0, sizeof(fftResult)); 
       for(int i=(init?0:1); i<NUM_GEQ_CHANNELS; i+=2) fftResult[i] = 16; // make a tiny pattern
+      geqFromChannels();
       inputLevel = 128;                                    // reset level slider to default
       autoResetPeak();
 
@@ -1515,6 +1463,7 @@ class AudioReactive : public Usermod {
       // reset sound data
       volumeRaw = 0; volumeSmth = 0;
       for(int i=(init?0:1); i<NUM_GEQ_CHANNELS; i+=2) fftResult[i] = 16; // make a tiny pattern
+      geqFromChannels();
       autoResetPeak();
       if (init) {
         if (udpSyncConnected) {   // close UDP sync connection (if open)
@@ -1667,7 +1616,9 @@ class AudioReactive : public Usermod {
         if (audioSyncEnabled) {
           if (audioSyncEnabled & 0x01) {
             infoArr.add(F("send mode"));
-            if ((udpSyncConnected) && (millis() - lastTime < 2500)) infoArr.add(F(" v2"));
+#ifdef ARDUINO_ARCH_ESP32
+            if ((udpSyncConnected) && (millis() - lastTime < 2500)) infoArr.add(syncVersion == 3 ? F(" v3") : F(" v2"));
+#endif
           } else if (audioSyncEnabled & 0x02) {
               infoArr.add(F("receive mode"));
           }
@@ -1677,6 +1628,7 @@ class AudioReactive : public Usermod {
         if (audioSyncEnabled && udpSyncConnected && (millis() - last_UDPTime < 2500)) {
             if (receivedFormat == 1) infoArr.add(F(" v1"));
             if (receivedFormat == 2) infoArr.add(F(" v2"));
+            if (receivedFormat == 3) infoArr.add(F(" v3"));
         }
 
         #if defined(WLED_DEBUG) || defined(SR_DEBUG)
@@ -1817,6 +1769,9 @@ class AudioReactive : public Usermod {
 
       JsonObject freqScale = top.createNestedObject(FPSTR(_frequency));
       freqScale[F("scale")] = FFTScalingMode;
+      freqScale[F("bands")] = numGEQBands;
+      freqScale[F("min")] = geqMinFreq;
+      freqScale[F("max")] = geqMaxFreq;
 #endif
 
       JsonObject dynLim = top.createNestedObject(FPSTR(_dynamics));
@@ -1827,6 +1782,10 @@ class AudioReactive : public Usermod {
       JsonObject sync = top.createNestedObject("sync");
       sync["port"] = audioSyncPort;
       sync["mode"] = audioSyncEnabled;
+      sync[F("latency")] = syncLatency;
+#ifdef ARDUINO_ARCH_ESP32
+      sync[F("version")] = syncVersion;
+#endif
     }
 
 
@@ -1880,6 +1839,12 @@ class AudioReactive : public Usermod {
       configComplete &= getJsonValue(top[FPSTR(_config)][F("AGC")],     soundAgc);
 
       configComplete &= getJsonValue(top[FPSTR(_frequency)][F("scale")], FFTScalingMode);
+      configComplete &= getJsonValue(top[FPSTR(_frequency)][F("bands")], numGEQBands);
+      configComplete &= getJsonValue(top[FPSTR(_frequency)][F("min")], geqMinFreq);
+      configComplete &= getJsonValue(top[FPSTR(_frequency)][F("max")], geqMaxFreq);
+      numGEQBands = constrain(numGEQBands, NUM_GEQ_CHANNELS, MAX_GEQ_BANDS);
+      geqMaxFreq = constrain(geqMaxFreq, 200, SAMPLE_RATE/2);
+      geqMinFreq = constrain(geqMinFreq, 20, geqMaxFreq / 2);
 
       configComplete &= getJsonValue(top[FPSTR(_dynamics)][F("limiter")], limiterOn);
       configComplete &= getJsonValue(top[FPSTR(_dynamics)][F("rise")],  attackTime);
@@ -1887,6 +1852,12 @@ class AudioReactive : public Usermod {
 #endif
       configComplete &= getJsonValue(top["sync"]["port"], audioSyncPort);
       configComplete &= getJsonValue(top["sync"]["mode"], audioSyncEnabled);
+      configComplete &= getJsonValue(top["sync"][F("latency")], syncLatency);
+      syncLatency = min(syncLatency, uint16_t(SYNC_MAX_LATENCY));
+#ifdef ARDUINO_ARCH_ESP32
+      configComplete &= getJsonValue(top["sync"][F("version")], syncVersion);
+      if (syncVersion != 3) syncVersion = 2;
+#endif
 
       if (initDone) {
         // add/remove custom/audioreactive palettes
@@ -1933,6 +1904,12 @@ class AudioReactive : public Usermod {
       uiScript.print(F("addOption(dd,'Linear (Amplitude)',2);"));
       uiScript.print(F("addOption(dd,'Square Root (Energy)',3);"));
       uiScript.print(F("addOption(dd,'Logarithmic (Loudness)',1);"));
+      uiScript.print(F("dd=addDropdown(ux,'frequency:bands');"));
+      uiScript.print(F("addOption(dd,'16 (default)',16);"));
+      uiScript.print(F("addOption(dd,'24',24);"));
+      uiScript.print(F("addOption(dd,'32',32);"));
+      uiScript.print(F("addInfo(ux+':frequency:min',1,'Hz <i>(24/32 bands only)</i>');"));
+      uiScript.print(F("addInfo(ux+':frequency:max',1,'Hz <i>(24/32 bands only)</i>');"));
 #endif
 
       uiScript.print(F("dd=addDropdown(ux,'sync:mode');"));
@@ -1941,7 +1918,12 @@ class AudioReactive : public Usermod {
       uiScript.print(F("addOption(dd,'Send',1);"));
 #endif
       uiScript.print(F("addOption(dd,'Receive',2);"));
+      uiScript.print(F("addInfo(ux+':sync:latency',1,'ms <i>(receive, 0-200)</i>');"));
 #ifdef ARDUINO_ARCH_ESP32
+      uiScript.print(F("dd=addDropdown(ux,'sync:version');"));
+      uiScript.print(F("addOption(dd,'v2 (default)',2);"));
+      uiScript.print(F("addOption(dd,'v3 (capture time)',3);"));
+      uiScript.print(F("addInfo(ux+':sync:version',1,'<i>(send)</i>');"));
       uiScript.print(F("addInfo(ux+':digitalmic:type',1,'<i>requires reboot!</i>');"));  // 0 is field type, 1 is actual field
       uiScript.print(F("addInfo(uxp,0,'<i>sd/data/dout</i>','I2S SD');"));
       uiScript.print(F("addInfo(uxp,1,'<i>ws/clk/lrck</i>','I2S WS');"));
@@ -2076,6 +2058,7 @@ const char AudioReactive::_digitalmic[] PROGMEM = "digitalmic";
 const char AudioReactive::_addPalettes[]       PROGMEM = "add-palettes";
 const char AudioReactive::UDP_SYNC_HEADER[]    PROGMEM = "00002"; // new sync header version, as format no longer compatible with previous structure
 const char AudioReactive::UDP_SYNC_HEADER_v1[] PROGMEM = "00001"; // old sync header version - need to add backwards-compatibility feature
+const char AudioReactive::UDP_SYNC_HEADER_v3[] PROGMEM = "00003"; // V2 plus capture time and sequence number
 
 static AudioReactive ar_module;
 REGISTER_USERMOD(ar_module);
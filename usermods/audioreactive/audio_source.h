@@ -770,4 +770,208 @@ class SPH0654 : public I2SSource {
 #endif
     }
 };
+
+/* WAV file "microphone"
+   Streams PCM samples (8/16/24/32 bit, mono or stereo - only the first channel is used) from a .wav file on the
+   filesystem instead of reading I2S. The file must use the sample rate of the audio source, it is not resampled.
+   Used to feed recorded audio into the FFT pipeline, for example in the host-native audio benchmark.
+*/
+class WavFileSource : public AudioSource {
+  public:
+    WavFileSource(SRate_t sampleRate, int blockSize, const char *fileName, bool loop = false, float sampleScale = 1.0f) :
+      AudioSource(sampleRate, blockSize, sampleScale),
+      _fileName(fileName),
+      _loop(loop)
+    {}
+
+    void initialize(int8_t = I2S_PIN_NO_CHANGE, int8_t = I2S_PIN_NO_CHANGE, int8_t = I2S_PIN_NO_CHANGE, int8_t = I2S_PIN_NO_CHANGE) {
+      DEBUGSR_PRINTLN(F("WavFileSource:: initialize()."));
+      _file = WLED_FS.open(_fileName, "r");
+      if (!_file || !_readHeader()) {
+        DEBUGSR_PRINTF("AR: cannot use %s as audio source.\n", _fileName);
+        if (_file) _file.close();
+        return;
+      }
+      _eof = false;
+      _initialized = true;
+    }
+
+    void deinitialize() {
+      _initialized = false;
+      if (_file) _file.close();
+    }
+
+    // fills the buffer with the next num_samples samples, with silence after the end of the file (unless looping)
+    void getSamples(float *buffer, uint16_t num_samples) {
+      if (!_initialized) return;
+      uint8_t chunk[64 * 8];                                   // up to 64 frames of stereo 32bit samples
+      const unsigned framesPerChunk = sizeof(chunk) / _frameSize;
+      unsigned done = 0;
+      while (done < num_samples) {
+        if (_dataLeft < _frameSize) {                          // end of data chunk
+          if (!_loop || !_file.seek(_dataStart)) { _eof = true; break; }
+          _dataLeft = _dataSize;
+        }
+        unsigned frames = min((unsigned)(num_samples - done), min(framesPerChunk, (unsigned)(_dataLeft / _frameSize)));
+        size_t bytes = _file.read(chunk, frames * _frameSize);
+        frames = bytes / _frameSize;
+        if (frames == 0) { _eof = true; break; }               // truncated file
+        _dataLeft -= frames * _frameSize;
+        for (unsigned i = 0; i < frames; i++) {
+          const uint8_t *s = chunk + i * _frameSize;           // first channel of the frame, little endian
+          float currSample;
+          switch (_bytesPerSample) {
+            case 1:  currSample = float(int(s[0]) - 128) * 256.0f; break;                                          // 8bit is unsigned
+            case 2:  currSample = float(int16_t(s[0] | (s[1] << 8))); break;
+            case 3:  currSample = float(int32_t((s[0] << 8) | (s[1] << 16) | (uint32_t(s[2]) << 24))) / 65536.0f; break;
+            default: currSample = float(int32_t(s[0] | (s[1] << 8) | (s[2] << 16) | (uint32_t(s[3]) << 24))) / 65536.0f; break;
+          }
+          buffer[done++] = currSample * _sampleScale;          // 16bit range, like I2SSource
+        }
+      }
+      while (done < num_samples) buffer[done++] = 0.0f;
+    }
+
+    /* true once all samples of the file have been delivered (never if looping) */
+    bool endOfFile(void) const { return _eof; }
+
+  private:
+    // parses the RIFF header and positions the file at the first sample
+    bool _readHeader() {
+      uint8_t hdr[12];
+      if (_file.read(hdr, 12) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4)) return false;
+      bool haveFormat = false;
+      while (_file.read(hdr, 8) == 8) {                        // chunk id and size
+        uint32_t size = hdr[4] | (hdr[5] << 8) | (hdr[6] << 16) | (uint32_t(hdr[7]) << 24);
+        if (!memcmp(hdr, "fmt ", 4)) {
+          uint8_t fmt[16];
+          if (size < 16 || _file.read(fmt, 16) != 16) return false;
+          uint16_t format   = fmt[0] | (fmt[1] << 8);
+          uint16_t channels = fmt[2] | (fmt[3] << 8);
+          uint32_t rate     = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | (uint32_t(fmt[7]) << 24);
+          uint16_t bits     = fmt[14] | (fmt[15] << 8);
+          if ((format != 1 && format != 0xFFFE) || channels < 1 || bits < 8 || bits > 32 || (bits & 7)) return false; // PCM only
+          if (rate != (uint32_t)_sampleRate) {
+            DEBUGSR_PRINTF("AR: %s has %u Hz, expected %u Hz.\n", _fileName, (unsigned)rate, (unsigned)_sampleRate);
+            return false;
+          }
+          _bytesPerSample = bits / 8;
+          _frameSize = _bytesPerSample * channels;
+          if (_frameSize > 8) return false;
+          haveFormat = true;
+          size -= 16;
+        } else if (!memcmp(hdr, "data", 4)) {
+          if (!haveFormat) return false;
+          _dataStart = _file.position();
+          _dataSize = _dataLeft = size;
+          return true;
+        }
+        if (!_file.seek(_file.position() + size + (size & 1))) return false; // skip (rest of) chunk, chunks are word aligned
+      }
+      return false;
+    }
+
+    const char *_fileName;
+    bool _loop;
+    bool _eof = true;
+    File _file;
+    uint8_t _bytesPerSample = 2;
+    uint8_t _frameSize = 2;
+    uint32_t _dataStart = 0;
+    uint32_t _dataSize = 0;
+    uint32_t _dataLeft = 0;
+};
+
+/* Signal generator "microphone"
+   Produces deterministic test signals instead of reading I2S: the output only depends on the number of samples
+   read since initialize(), so the same signal gives the same FFT results on every run.
+   Sine:      constant tone (default 1kHz)
+   Sweep:     logarithmic sine sweep from 40Hz to 10kHz, repeated (default every 8 seconds)
+   PinkNoise: white noise filtered to -3dB/octave
+   Beats:     beat train - a decaying 55Hz "kick" on every beat and a short noise "hi-hat" between beats (default 120 BPM)
+*/
+class SignalGeneratorSource : public AudioSource {
+  public:
+    typedef enum { Sine = 0, Sweep = 1, PinkNoise = 2, Beats = 3 } Signal;
+
+    SignalGeneratorSource(SRate_t sampleRate, int blockSize, Signal signal, float amplitude = 256.0f, float sampleScale = 1.0f) :
+      AudioSource(sampleRate, blockSize, sampleScale),
+      _signal(signal),
+      _amplitude(amplitude)
+    {}
+
+    void initialize(int8_t = I2S_PIN_NO_CHANGE, int8_t = I2S_PIN_NO_CHANGE, int8_t = I2S_PIN_NO_CHANGE, int8_t = I2S_PIN_NO_CHANGE) {
+      _sampleCount = 0;
+      _phase = 0.0f;
+      _noiseSeed = 0x2545F491;
+      _pink[0] = _pink[1] = _pink[2] = 0.0f;
+      _initialized = true;
+    }
+
+    void deinitialize() {
+      _initialized = false;
+    }
+
+    void getSamples(float *buffer, uint16_t num_samples) {
+      if (!_initialized) return;
+      const float rate = float(_sampleRate);
+      for (unsigned i = 0; i < num_samples; i++, _sampleCount++) {
+        float currSample = 0.0f;
+        switch (_signal) {
+          case Sine:
+            currSample = _tone(_frequency / rate);
+            break;
+          case Sweep: {
+            const uint32_t period = _sweepTime * rate;
+            const float pos = float(_sampleCount % period) / float(period); // 0..1 within the sweep
+            currSample = _tone(40.0f * expf(pos * logf(10000.0f / 40.0f)) / rate);
+          } break;
+          case PinkNoise: { // Paul Kellet's "economy" pink noise filter
+            const float white = _noise();
+            _pink[0] = 0.99765f * _pink[0] + white * 0.0990460f;
+            _pink[1] = 0.96300f * _pink[1] + white * 0.2965164f;
+            _pink[2] = 0.57000f * _pink[2] + white * 1.0526913f;
+            currSample = (_pink[0] + _pink[1] + _pink[2] + white * 0.1848f) * 0.25f;
+          } break;
+          case Beats: {
+            const uint32_t beat = 60.0f * rate / _bpm;           // samples per beat
+            const float kickTime = float(_sampleCount % beat) / rate;
+            const float hatTime = float((_sampleCount + beat / 2) % beat) / rate;
+            currSample = expf(-kickTime * 12.0f) * _tone(55.0f / rate) + 0.3f * expf(-hatTime * 60.0f) * _noise();
+          } break;
+        }
+        buffer[i] = currSample * _amplitude * _sampleScale;
+      }
+    }
+
+    void setFrequency(float frequency) { _frequency = frequency; }  // Sine
+    void setSweepTime(float seconds) { _sweepTime = seconds; }      // Sweep
+    void setBPM(float bpm) { _bpm = bpm; }                          // Beats
+
+  private:
+    // next sample of a sine with the given frequency (in cycles per sample), continuous phase
+    float _tone(float step) {
+      float s = sinf(_phase * float(2.0 * M_PI));
+      _phase += step;
+      if (_phase >= 1.0f) _phase -= 1.0f;
+      return s;
+    }
+    // white noise -1...1 (xorshift32)
+    float _noise() {
+      _noiseSeed ^= _noiseSeed << 13;
+      _noiseSeed ^= _noiseSeed >> 17;
+      _noiseSeed ^= _noiseSeed << 5;
+      return float(int32_t(_noiseSeed)) / 2147483648.0f;
+    }
+
+    Signal _signal;
+    float _amplitude;                 // peak amplitude in 16bit sample units (256 is a normal microphone level)
+    float _frequency = 1000.0f;
+    float _sweepTime = 8.0f;
+    float _bpm = 120.0f;
+    uint32_t _sampleCount = 0;
+    float _phase = 0.0f;
+    uint32_t _noiseSeed = 0x2545F491;
+    float _pink[3] = {0.0f};
+};
 #endif
@@ -48,7 +48,11 @@
   bool      samplePeak = false;
   float     FFT_MajorPeak = 1.0;
   uint8_t  *fftResult = nullptr;
-  float    *fftBin = nullptr;
+  uint8_t  *geqResult = nullptr;
+  uint8_t   geqBands = 16;
+  uint8_t   onsetStrength = 0;
+  float     beatBPM = 0.0f;
+  uint8_t   beatPhase = 0;
   um_data_t *um_data = getAudioData();
   volumeSmth    = *(float*)   um_data->u_data[0];
   volumeRaw     = *(float*)   um_data->u_data[1];
@@ -56,9 +60,13 @@
   samplePeak    = *(uint8_t*) um_data->u_data[3];
   FFT_MajorPeak = *(float*)   um_data->u_data[4];
   my_magnitude  = *(float*)   um_data->u_data[5];
-  maxVol        =  (uint8_t*) um_data->u_data[6];  // requires UI element (SEGMENT.customX?), changes source element
-  binNum        =  (uint8_t*) um_data->u_data[7];  // requires UI element (SEGMENT.customX?), changes source element
-  fftBin        =  (float*)   um_data->u_data[8];
+  maxVol        =  (uint8_t*) um_data->u_data[6];  // deprecated, not used by the peak detector any more
+  binNum        =  (uint8_t*) um_data->u_data[7];  // deprecated, not used by the peak detector any more
+  geqResult     =  (uint8_t*) um_data->u_data[8];  // GEQ bands of the configured layout (16 to 32), use getGEQBands()
+  geqBands      = *(uint8_t*) um_data->u_data[9];
+  onsetStrength = *(uint8_t*) um_data->u_data[10]; // strength of the last onset (decays), samplePeak is set on every onset
+  beatBPM       = *(float*)   um_data->u_data[11]; // tempo, 0 = unknown
+  beatPhase     = *(uint8_t*) um_data->u_data[12]; // position within the beat (0 = on the beat), advances with the tempo
 */
 
 #define IBN 5100
@@ -125,6 +133,16 @@ static um_data_t* getAudioData() {
   return um_data;
 }
 
+// GEQ bands of the configured band layout (16 to 32 bands), falls back to the 16 channels of fftResult
+static uint8_t* getGEQBands(um_data_t *um_data, unsigned &numBands) {
+  if (um_data->u_size > 9) {
+    numBands = *(uint8_t*)um_data->u_data[9];
+    return (uint8_t*)um_data->u_data[8];
+  }
+  numBands = 16;
+  return (uint8_t*)um_data->u_data[2];
+}
+
 
 // effect functions
 
@@ -6687,19 +6705,9 @@ uint16_t mode_ripplepeak(void) {                // * Ripple peak. By Andrew Tuli
   #ifdef ESP32
   float   FFT_MajorPeak = *(float*)  um_data->u_data[4];
   #endif
-  uint8_t *maxVol       =  (uint8_t*)um_data->u_data[6];
-  uint8_t *binNum       =  (uint8_t*)um_data->u_data[7];
 
   // printUmData();
 
-  if (SEGENV.call == 0) {
-    SEGMENT.custom1 = *binNum;
-    SEGMENT.custom2 = *maxVol * 2;
-  }
-
-  *binNum = SEGMENT.custom1;                              // Select a bin.
-  *maxVol = SEGMENT.custom2 / 2;                          // Our volume comparator.
-
   SEGMENT.fade_out(240);                                  // Lower frame rate means less effective fading than FastLED
   SEGMENT.fade_out(240);
 
@@ -6741,7 +6749,7 @@ uint16_t mode_ripplepeak(void) {                // * Ripple peak. By Andrew Tuli
 
   return FRAMETIME;
 } // mode_ripplepeak()
-static const char _data_FX_MODE_RIPPLEPEAK[] PROGMEM = "Ripple Peak@Fade rate,Max # of ripples,Select bin,Volume (min);!,!;!;1v;c2=0,m12=0,si=0"; // Pixel, Beatsin
+static const char _data_FX_MODE_RIPPLEPEAK[] PROGMEM = "Ripple Peak@Fade rate,Max # of ripples;!,!;!;1v;m12=0,si=0"; // Pixel, Beatsin
 
 
 #ifndef WLED_DISABLE_2D
@@ -7179,13 +7187,9 @@ uint16_t mode_puddles_base(bool peakdetect) {
   um_data_t *um_data = getAudioData();
   int volumeRaw    = *(int16_t*)um_data->u_data[1];
   uint8_t samplePeak = *(uint8_t*)um_data->u_data[3];
-  uint8_t *maxVol    =  (uint8_t*)um_data->u_data[6];
-  uint8_t *binNum    =  (uint8_t*)um_data->u_data[7];
   float   volumeSmth   = *(float*)  um_data->u_data[0];
 
   if(peakdetect) {                                          // puddles peak
-    *binNum = SEGMENT.custom1;                              // Select a bin.
-    *maxVol = SEGMENT.custom2 / 2;                          // Our volume comparator.
     if (samplePeak == 1) {
       size = volumeSmth * SEGMENT.intensity /256 /4 + 1;    // Determine size of the flash based on the volume.
       if (pos+size>= SEGLEN) size = SEGLEN - pos;
@@ -7208,7 +7212,7 @@ uint16_t mode_puddles_base(bool peakdetect) {
 uint16_t mode_puddlepeak(void) {                // Puddlepeak. By Andrew Tuline.
   return mode_puddles_base(true);
 } 
-static const char _data_FX_MODE_PUDDLEPEAK[] PROGMEM = "Puddlepeak@Fade rate,Puddle size,Select bin,Volume (min);!,!;!;1v;c2=0,m12=0,si=0"; // Pixels, Beatsin
+static const char _data_FX_MODE_PUDDLEPEAK[] PROGMEM = "Puddlepeak@Fade rate,Puddle size;!,!;!;1v;m12=0,si=0"; // Pixels, Beatsin
 
 uint16_t mode_puddles(void) {                   // Puddles. By Andrew Tuline.
   return mode_puddles_base(false);
@@ -7561,8 +7565,6 @@ uint16_t mode_waterfall(void) {                   // Waterfall. By: Andrew Tulin
   um_data_t *um_data    = getAudioData();
   uint8_t samplePeak    = *(uint8_t*)um_data->u_data[3];
   float   FFT_MajorPeak = *(float*)  um_data->u_data[4];
-  uint8_t *maxVol       =  (uint8_t*)um_data->u_data[6];
-  uint8_t *binNum       =  (uint8_t*)um_data->u_data[7];
   float   my_magnitude  = *(float*)   um_data->u_data[5] / 8.0f;
 
   if (FFT_MajorPeak < 1) FFT_MajorPeak = 1;                                         // log10(0) is "forbidden" (throws exception)
@@ -7570,13 +7572,8 @@ uint16_t mode_waterfall(void) {                   // Waterfall. By: Andrew Tulin
   if (SEGENV.call == 0) {
     for (unsigned i = 0; i < SEGLEN; i++) pixels[i] = BLACK;   // may not be needed as resetIfRequired() clears buffer
     SEGENV.aux0 = 255;
-    SEGMENT.custom1 = *binNum;
-    SEGMENT.custom2 = *maxVol * 2;
   }
 
-  *binNum = SEGMENT.custom1;                              // Select a bin.
-  *maxVol = SEGMENT.custom2 / 2;                          // Our volume comparator.
-
   uint8_t secondHand = micros() / (256-SEGMENT.speed)/500 + 1 % 16;
   if (SEGENV.aux0 != secondHand) {                        // Triggered millis timing.
     SEGENV.aux0 = secondHand;
@@ -7601,7 +7598,7 @@ uint16_t mode_waterfall(void) {                   // Waterfall. By: Andrew Tulin
 
   return FRAMETIME;
 } // mode_waterfall()
-static const char _data_FX_MODE_WATERFALL[] PROGMEM = "Waterfall@!,Adjust color,Select bin,Volume (min);!,!;!;01f;c2=0,m12=2,si=0"; // Circles, Beatsin
+static const char _data_FX_MODE_WATERFALL[] PROGMEM = "Waterfall@!,Adjust color;!,!;!;01f;m12=2,si=0"; // Circles, Beatsin
 
 
 #ifndef WLED_DISABLE_2D
@@ -7611,17 +7608,19 @@ static const char _data_FX_MODE_WATERFALL[] PROGMEM = "Waterfall@!,Adjust color,
 uint16_t mode_2DGEQ(void) { // By Will Tatam. Code reduction by Ewoud Wijma.
   if (!strip.isMatrix || !SEGMENT.is2D()) return mode_static(); // not a 2D set-up
 
-  const int NUM_BANDS = map(SEGMENT.custom1, 0, 255, 1, 16);
-  const int CENTER_BIN = map(SEGMENT.custom3, 0, 31, 0, 15);
+  um_data_t *um_data = getAudioData();
+  unsigned numGEQBands;
+  uint8_t *fftResult = getGEQBands(um_data, numGEQBands); // 16 to 32 bands, depending on AR settings
+  const int maxBand = numGEQBands - 1;
+
+  const int NUM_BANDS = map(SEGMENT.custom1, 0, 255, 1, numGEQBands);
+  const int CENTER_BIN = map(SEGMENT.custom3, 0, 31, 0, maxBand);
   const int cols = SEG_W;
   const int rows = SEG_H;
 
   if (!SEGENV.allocateData(cols*sizeof(uint16_t))) return mode_static(); //allocation failed
   uint16_t *previousBarHeight = reinterpret_cast<uint16_t*>(SEGENV.data); //array of previous bar heights per frequency band
 
-  um_data_t *um_data = getAudioData();
-  uint8_t *fftResult = (uint8_t*)um_data->u_data[2];
-
   if (SEGENV.call == 0) for (int i=0; i<cols; i++) previousBarHeight[i] = 0;
 
   bool rippleTime = false;
@@ -7635,15 +7634,15 @@ uint16_t mode_2DGEQ(void) { // By Will Tatam. Code reduction by Ewoud Wijma.
 
   for (int x=0; x < cols; x++) {
     int band = map(x, 0, cols, 0, NUM_BANDS);
-    if (NUM_BANDS < 16) {
-        int startBin = constrain(CENTER_BIN - NUM_BANDS/2, 0, 15 - NUM_BANDS + 1);
+    if (NUM_BANDS < (int)numGEQBands) {
+        int startBin = constrain(CENTER_BIN - NUM_BANDS/2, 0, maxBand - NUM_BANDS + 1);
         if(NUM_BANDS <= 1)
           band = CENTER_BIN; // map() does not work for single band
         else
           band = map(band, 0, NUM_BANDS - 1, startBin, startBin + NUM_BANDS - 1);
     }
-    band = constrain(band, 0, 15);
-    unsigned colorIndex = band * 17;
+    band = constrain(band, 0, maxBand);
+    unsigned colorIndex = band * 255 / maxBand;
     int barHeight  = map(fftResult[band], 0, 255, 0, rows); // do not subtract -1 from rows here
     if (barHeight > previousBarHeight[x]) previousBarHeight[x] = barHeight; //drive the peak up
 
@@ -9134,15 +9133,16 @@ uint16_t mode_particleGEQ(void) {
   PartSys->setGravity(SEGMENT.custom3 << 2); // set gravity strength
 
   um_data_t *um_data = getAudioData();
-  uint8_t *fftResult = (uint8_t *)um_data->u_data[2]; // 16 bins with FFT data, log mapped already, each band contains frequency amplitude 0-255
+  unsigned numBands;
+  uint8_t *fftResult = getGEQBands(um_data, numBands); // 16 to 32 bins with FFT data, log mapped already, each band contains frequency amplitude 0-255
 
-  //map the bands into 16 positions on x axis, emit some particles according to frequency loudness
+  //map the bands into numBands positions on x axis, emit some particles according to frequency loudness
   i = 0;
-  uint32_t binwidth = (PartSys->maxX + 1)>>4; //emit poisition variation for one bin (+/-) is equal to width/16 (for 16 bins)
+  uint32_t binwidth = (PartSys->maxX + 1) / numBands; //emit poisition variation for one bin (+/-) is equal to width/numBands
   uint32_t threshold = 300 - SEGMENT.intensity;
   uint32_t emitparticles = 0;
 
-  for (uint32_t bin = 0; bin < 16; bin++) {
+  for (uint32_t bin = 0; bin < numBands; bin++) {
     uint32_t xposition = binwidth*bin + (binwidth>>1); // emit position according to frequency band
     uint8_t emitspeed = ((uint32_t)fftResult[bin] * (uint32_t)SEGMENT.speed) >> 9; // emit speed according to loudness of band (127 max!)
     emitparticles = 0;
@@ -9164,7 +9164,7 @@ uint16_t mode_particleGEQ(void) {
         PartSys->particles[i].y = 0; // start at the bottom
         PartSys->particles[i].vx = hw_random16(SEGMENT.custom1>>1)-(SEGMENT.custom1>>2) ; //x-speed variation: +/- custom1/4
         PartSys->particles[i].vy = emitspeed;
-        PartSys->particles[i].hue = (bin<<4) + hw_random16(17) - 8; // color from palette according to bin
+        PartSys->particles[i].hue = ((bin << 8) / numBands) + hw_random16(17) - 8; // color from palette according to bin
         emitparticles--;
       }
       i++;
@@ -79,6 +79,18 @@ extern byte realtimeMode;           // used in getMappedPixelIndex()
 #endif
 #define FPS_UNLIMITED    0
 
+#ifndef TRANSITION_POOL_TIMEOUT
+  #define TRANSITION_POOL_TIMEOUT 30000 // ms without a running transition after which snapshot buffers are returned to the heap
+#endif
+
+// dual-core ESP32 only: effects run in a separate task on the other core while the loop task outputs the previous frame
+#if defined(WLED_ENABLE_PIPELINED_RENDER) && defined(ARDUINO_ARCH_ESP32) && !defined(CONFIG_FREERTOS_UNICORE)
+  #define WLED_PIPELINED_RENDER
+  #ifndef WLED_RENDER_TASK_STACK
+    #define WLED_RENDER_TASK_STACK 8192 // same as Arduino loop task, effects may use large local buffers
+  #endif
+#endif
+
 // FPS calculation (can be defined as compile flag for debugging)
 #ifndef FPS_CALC_AVG
 #define FPS_CALC_AVG 7 // average FPS calculation over this many frames (moving average)
@@ -488,6 +500,7 @@ class Segment {
         bool    _manualW  : 1;
       };
     };
+    mutable uint32_t _blendKey;       // blending parameters this segment was last composed into frame buffer with (0 = needs blending, see WS2812FX::show())
 
     // static variables are use to speed up effect calculations by stashing common pre-calculated values
     static unsigned      _usedSegmentData;    // amount of data used by all segments
@@ -530,12 +543,27 @@ class Segment {
       , _bri(0)
       , _cct(0)
       {}
-      ~Transition() {
-        //DEBUGFX_PRINTF_P(PSTR("-- Destroying transition: %p\n"), this);
-        if (_oldSegment) delete _oldSegment;
-      }
     } *_t;
 
+    // transitions and their segment snapshots are taken from a pool of MAX_NUM_SEGMENTS slots (allocated on first use),
+    // a slot keeps its pixel and data buffers after the transition ends so playlists do not churn the heap;
+    // the pool is freed once no transition ran for TRANSITION_POOL_TIMEOUT ms (see handleTransitionPool())
+    struct TransitionSlot;
+    static TransitionSlot *_transitionPool;
+    static unsigned       _transitionAllocs;   // heap allocations made for transitions since boot
+    static unsigned       _transitionsInUse;   // slots currently holding a running transition
+    static unsigned long  _transitionPoolIdle; // millis() when the last running transition ended
+    static Transition    *acquireTransition(uint16_t dur);
+    static void           releaseTransition(Transition *t);
+    Segment              *takeSnapshot(Transition *t) const; // copies segment into transition's pool slot
+
+    // raw pixel indices each 1D pixel expands to in arc, corner and pinwheel mapping (built by beginDraw(), see updateMappingTable())
+    struct MappingTable;
+    mutable MappingTable *_mapTable;
+    const MappingTable   *mappingTable() const;       // table if it matches current draw dimensions and mapping, nullptr otherwise
+    void                  updateMappingTable() const;
+    inline void           freeMappingTable() const    { p_free(_mapTable); _mapTable = nullptr; }
+
   protected:
 
     inline static void     addUsedSegmentData(int len)     { Segment::_usedSegmentData += len; }
@@ -560,6 +588,9 @@ class Segment {
     inline uint16_t progress() const          { return isInTransition() ? _t->_progress : 0xFFFFU; } // relies on handleTransition()/updateTransitionProgress() to update progression variable
     inline Segment *getOldSegment() const     { return isInTransition() ? _t->_oldSegment : nullptr; }
 
+    static void trimTransitionPool();         // frees buffers of unused transition pool slots
+    static void handleTransitionPool();       // frees the pool after it was idle for TRANSITION_POOL_TIMEOUT ms
+
     inline static void modeBlend(bool blend)  { Segment::_modeBlend = blend; }
     inline static void setClippingRect(int startX, int stopX, int startY = 0, int stopY = 1) { _clipStart = startX; _clipStop = stopX; _clipStartY = startY; _clipStopY = stopY; };
     inline static bool isPreviousMode()       { return Segment::_modeBlend; }    // needed for determining CCT/opacity during non-BLEND_STYLE_FADE transition
@@ -601,7 +632,9 @@ class Segment {
     , _dataLen(0)
     , _default_palette(6)
     , _capabilities(0)
+    , _blendKey(0)
     , _t(nullptr)
+    , _mapTable(nullptr)
     {
       DEBUGFX_PRINTF_P(PSTR("-- Creating segment: %p [%d,%d:%d,%d]\n"), this, (int)start, (int)stop, (int)startY, (int)stopY);
       // allocate render buffer (always entire segment), prefer PSRAM if DRAM is running low. Note: impact on FPS with PSRAM buffer is low (<2% with QSPI PSRAM)
@@ -629,8 +662,10 @@ class Segment {
       #ifdef WLED_ENABLE_GIF
       endImagePlayback(this);
       #endif
+      if (_t) stopTransition();
       deallocateData();
       p_free(pixels);
+      p_free(_mapTable);
     }
 
     Segment& operator= (const Segment &orig); // copy assignment
@@ -680,6 +715,7 @@ class Segment {
     bool allocateData(size_t len);  // allocates effect data buffer in heap and clears it
     void deallocateData();          // deallocates (frees) effect data buffer from heap
     inline static unsigned getUsedSegmentData()            { return Segment::_usedSegmentData; }
+    inline static unsigned getTransitionAllocations()      { return Segment::_transitionAllocs; }
     /**
       * Flags that before the next effect is calculated,
       * the internal segment state should be reset.
@@ -687,6 +723,7 @@ class Segment {
       * Safe to call from interrupts and network requests.
       */
     inline Segment &markForReset() { reset = true; return *this; }  // setOption(SEG_OPTION_RESET, true)
+    inline void markDirty() const  { _blendKey = 0; }  // pixels were changed outside effect function, frame buffer region needs re-blending
 
     void startTransition(uint16_t dur, bool segmentCopy = true);    // transition has to start before actual segment values change
     uint8_t  currentCCT() const; // current segment's CCT (blended while in transition)
@@ -849,6 +886,17 @@ class WS2812FX {
       // true private variables
       _pixels(nullptr),
       _pixelCCT(nullptr),
+      _pixelsMapped(nullptr),
+      _pixelsMappedLen(0),
+#ifdef WLED_PIPELINED_RENDER
+      _pixelsOut(nullptr),
+      _pixelCCTOut(nullptr),
+      _renderTask(nullptr),
+      _serviceTask(nullptr),
+      _renderUp(0),
+      _frameRendered(false),
+      _frameQueued(false),
+#endif
       _suspend(false),
       _brightness(DEFAULT_BRIGHTNESS),
       _length(DEFAULT_LED_COUNT),
@@ -860,6 +908,7 @@ class WS2812FX {
       _isOffRefreshRequired(false),
       _hasWhiteChannel(false),
       _triggered(false),
+      _composed(false),
       _segment_index(0),
       _mainSegment(0),
       _modeCount(MODE_COUNT),
@@ -878,6 +927,12 @@ class WS2812FX {
     ~WS2812FX() {
       p_free(_pixels);
       p_free(_pixelCCT); // just in case
+      p_free(_pixelsMapped);
+#ifdef WLED_PIPELINED_RENDER
+      if (_renderTask) vTaskDelete(_renderTask);
+      p_free(_pixelsOut);
+      p_free(_pixelCCTOut);
+#endif
       d_free(customMappingTable);
       _mode.clear();
       _modeData.clear();
@@ -908,7 +963,7 @@ class WS2812FX {
       waitForIt();                                // wait until frame is over (service() has finished or time for 1 frame has passed)
 
     void setRealtimePixelColor(unsigned i, uint32_t c);
-    inline void setPixelColor(unsigned n, uint32_t c) const   { if (n < getLengthTotal()) _pixels[n] = c; }  // paints absolute strip pixel with index n and color c
+    inline void setPixelColor(unsigned n, uint32_t c) const   { if (n < getLengthTotal()) { _pixels[n] = c; _composed = false; } }  // paints absolute strip pixel with index n and color c
     inline void resetTimebase()                               { timebase = 0UL - millis(); }
     inline void setPixelColor(unsigned n, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) const
                                                               { setPixelColor(n, RGBW32(r,g,b,w)); }
@@ -1025,8 +1080,34 @@ class WS2812FX {
     Segment *_currentSegment;
 
   private:
+    void composeSegments();   // blends visible segments into (cleared) frame buffer, skips unchanged ones
+    bool renderEffects(unsigned long nowUp);  // runs due effects, returns true if a new frame has to be shown
+    void composeFrame();      // builds the output frame in _pixels (and _pixelCCT)
+    void drawOverlays();      // runs usermod overlays on the composed frame (loop task only)
+    void outputFrame(const uint32_t *pixels, const uint8_t *pixelCCT); // gamma, mapping and hand-off to buses
+    bool deserializeBinaryMap(const char *binName, size_t jsonSize, unsigned n); // fast path of deserializeMap()
+    // blendSegment() kernels for segments that are not in transition, specialized on blend mode (Op), mirroring and CCT tracking
+    template<class Op> void blendSegmentPlain(const Segment &topSegment, Op op, uint8_t opacity, uint8_t cct, bool is2D) const;
+    template<class Op, bool MIRRORED, bool TRACK_CCT> void blendPlain1D(const Segment &topSegment, Op op, uint8_t opacity, uint8_t cct) const;
+    template<class Op, bool MIRRORED, bool TRACK_CCT> void blendPlain2D(const Segment &topSegment, Op op, uint8_t opacity, uint8_t cct) const;
+
     uint32_t *_pixels;
     uint8_t  *_pixelCCT;
+    uint32_t *_pixelsMapped;    // ledmap output in physical order followed by a bit mask of written pixels (allocated on first use)
+    size_t    _pixelsMappedLen; // pixels _pixelsMapped was allocated for
+#ifdef WLED_PIPELINED_RENDER
+    // render task composes frame N+1 into _pixels while loop task sends frame N from _pixelsOut
+    uint32_t     *_pixelsOut;
+    uint8_t      *_pixelCCTOut;
+    TaskHandle_t  _renderTask;
+    TaskHandle_t  _serviceTask;   // task waiting in service() for the render task
+    unsigned long _renderUp;      // millis() of the frame being rendered
+    bool          _frameRendered; // set by render task before notifying _serviceTask
+    bool          _frameQueued;   // _pixelsOut holds a frame that has not been sent yet
+
+    static void renderTask(void *parameter);
+    void dropQueuedFrame();
+#endif
     std::vector<Segment> _segments;
 
     volatile bool _suspend;
@@ -1046,6 +1127,7 @@ class WS2812FX {
       bool _hasWhiteChannel      : 1;
       bool _triggered            : 1;
     };
+    mutable bool _composed; // frame buffer holds unmodified result of last segment composition (see show())
 
     uint8_t _segment_index;
     uint8_t _mainSegment;
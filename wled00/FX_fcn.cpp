@@ -55,6 +55,23 @@ uint16_t Segment::_clipStop = 0;
 uint8_t  Segment::_clipStartY = 0;
 uint8_t  Segment::_clipStopY = 1;
 
+// transition pool slot: transition data, storage for the snapshot of the segment and the buffers it uses
+struct Segment::TransitionSlot {
+  Transition t;
+  bool       used;
+  bool       dataLent;  // data buffer was handed to the snapshot (old effect may have replaced & freed it)
+  unsigned   pixelsLen; // capacity of pixel buffer (in pixels)
+  unsigned   dataLen;   // capacity of data buffer (in bytes)
+  uint32_t  *pixels;
+  byte      *data;
+  char      *name;      // copy of the segment name (WLED_MAX_SEGNAME_LEN+1 bytes), owned by the slot
+  alignas(Segment) uint8_t snapshot[sizeof(Segment)];
+};
+Segment::TransitionSlot *Segment::_transitionPool = nullptr;
+unsigned Segment::_transitionAllocs = 0;
+unsigned Segment::_transitionsInUse = 0;
+unsigned long Segment::_transitionPoolIdle = 0;
+
 // copy constructor
 Segment::Segment(const Segment &orig) {
   //DEBUG_PRINTF_P(PSTR("-- Copy segment constructor: %p -> %p\n"), &orig, this);
@@ -64,6 +81,8 @@ Segment::Segment(const Segment &orig) {
   data = nullptr;
   _dataLen = 0;
   pixels = nullptr;
+  _mapTable = nullptr; // rebuilt on first draw
+  _blendKey = 0; // copy was never blended into frame buffer
   if (!stop) return;  // nothing to do if segment is inactive/invalid
   if (orig.pixels) {
     // allocate pixel buffer: prefer IRAM/PSRAM
@@ -89,6 +108,7 @@ Segment::Segment(Segment &&orig) noexcept {
   orig.data = nullptr;
   orig._dataLen = 0;
   orig.pixels = nullptr;
+  orig._mapTable = nullptr;
 }
 
 // copy assignment
@@ -100,12 +120,15 @@ Segment& Segment::operator= (const Segment &orig) {
     if (_t) stopTransition(); // also erases _t
     deallocateData();
     p_free(pixels);
+    freeMappingTable();
     // copy source
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     // erase pointers to allocated data
     data = nullptr;
     _dataLen = 0;
     pixels = nullptr;
+    _mapTable = nullptr;
+    _blendKey = 0; // copy was never blended into frame buffer
     if (!stop) return *this;  // nothing to do if segment is inactive/invalid
     // copy source data
     if (orig.pixels) {
@@ -133,12 +156,14 @@ Segment& Segment::operator= (Segment &&orig) noexcept {
     if (_t) stopTransition(); // also erases _t
     deallocateData(); // free old runtime data
     p_free(pixels);   // free old pixel buffer
+    freeMappingTable();
     // move source data
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     orig.name = nullptr;
     orig.data = nullptr;
     orig._dataLen = 0;
     orig.pixels = nullptr;
+    orig._mapTable = nullptr;
     orig._t = nullptr; // old segment cannot be in transition
   }
   return *this;
@@ -217,6 +242,7 @@ void Segment::resetIfRequired() {
     DEBUG_PRINTF_P(PSTR("-- Segment %p reset, data cleared\n"), this);
   }
   if (pixels) for (size_t i = 0; i < length(); i++) pixels[i] = BLACK; // clear pixel buffer
+  markDirty();
   next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0;
   reset = false;
   #ifdef WLED_ENABLE_GIF
@@ -272,7 +298,7 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
         targetPalette = *fastledPalettes[pal - DYNAMIC_PALETTE_COUNT];
       } else {
         byte tcp[72];
-        memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[pal - (DYNAMIC_PALETTE_COUNT + FASTLED_PALETTE_COUNT)])), sizeof(tcp));
+        memcpy_P(tcp, (const byte*)pgm_read_ptr(&(gGradientPalettes[pal - (DYNAMIC_PALETTE_COUNT + FASTLED_PALETTE_COUNT)])), sizeof(tcp));
         targetPalette.loadDynamicGradientPalette(tcp);
       }
       break;
@@ -281,6 +307,138 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
 }
 
 // starting a transition has to occur before change so we get current values 1st
+// takes a free slot from the transition pool (allocates the pool on first use)
+Segment::Transition *Segment::acquireTransition(uint16_t dur) {
+  if (!_transitionPool) {
+    _transitionPool = static_cast<TransitionSlot*>(d_calloc(MAX_NUM_SEGMENTS, sizeof(TransitionSlot)));
+    if (!_transitionPool) return nullptr;
+    _transitionAllocs++;
+  }
+  for (unsigned i = 0; i < MAX_NUM_SEGMENTS; i++) {
+    TransitionSlot &slot = _transitionPool[i];
+    if (slot.used) continue;
+    slot.used = true;
+    slot.dataLent = false;
+    _transitionsInUse++;
+    return new(&slot.t) Transition(dur);
+  }
+  return nullptr;
+}
+
+// returns transition to the pool, buffers of the snapshot remain in the slot
+void Segment::releaseTransition(Transition *t) {
+  TransitionSlot &slot = *reinterpret_cast<TransitionSlot*>(t); // transition is the first member of its slot
+  Segment *old = t->_oldSegment;
+  if (old) {
+    if (old->pixels == slot.pixels) old->pixels = nullptr;
+    if (old->name == slot.name) old->name = nullptr;
+    if (slot.dataLent) {
+      if (old->data == slot.data) {
+        Segment::addUsedSegmentData(-old->_dataLen);
+        old->data = nullptr;
+        old->_dataLen = 0;
+      } else {
+        slot.data = nullptr; // old effect reallocated its data, allocateData() already freed the pool buffer
+        slot.dataLen = 0;
+      }
+    }
+    old->~Segment();
+    t->_oldSegment = nullptr;
+  }
+  slot.used = false;
+  if (--_transitionsInUse == 0) _transitionPoolIdle = millis();
+}
+
+// frees buffers of all unused slots (and the pool itself if no transition is running), e.g. after segments were reset
+void Segment::trimTransitionPool() {
+  if (!_transitionPool) return;
+  bool inUse = false;
+  for (unsigned i = 0; i < MAX_NUM_SEGMENTS; i++) {
+    TransitionSlot &slot = _transitionPool[i];
+    if (slot.used) { inUse = true; continue; }
+    p_free(slot.pixels);
+    d_free(slot.data);
+    p_free(slot.name);
+    slot.pixels = nullptr; slot.pixelsLen = 0;
+    slot.data   = nullptr; slot.dataLen   = 0;
+    slot.name   = nullptr;
+  }
+  if (inUse) return;
+  d_free(_transitionPool);
+  _transitionPool = nullptr;
+}
+
+// releases the pool once no transition was started for TRANSITION_POOL_TIMEOUT ms, a playlist stepping faster keeps its buffers
+void Segment::handleTransitionPool() {
+  if (_transitionPool && _transitionsInUse == 0 && millis() - _transitionPoolIdle > TRANSITION_POOL_TIMEOUT) {
+    DEBUGFX_PRINTLN(F("-- Releasing idle transition pool."));
+    trimTransitionPool();
+  }
+}
+
+// same as copy constructor but buffers (including the name) come from the transition pool slot
+Segment *Segment::takeSnapshot(Transition *t) const {
+  TransitionSlot &slot = *reinterpret_cast<TransitionSlot*>(t);
+  if (!pixels || !stop) return nullptr;
+  const unsigned len = length();
+  if (slot.pixelsLen < len) {
+    // buffer grows to the segment using this slot, slots are released together with the pool once transitions are idle
+    p_free(slot.pixels);
+    slot.pixels = static_cast<uint32_t*>(allocate_buffer(len * sizeof(uint32_t), BFRALLOC_PREFER_PSRAM | BFRALLOC_NOBYTEACCESS));
+    slot.pixelsLen = slot.pixels ? len : 0;
+    _transitionAllocs++;
+    if (!slot.pixels) {
+      DEBUGFX_PRINTLN(F("!!! Not enough RAM for transition buffer !!!"));
+      errorFlag = ERR_NORAM_PX;
+      return nullptr;
+    }
+  }
+  Segment *old = reinterpret_cast<Segment*>(slot.snapshot);
+  memcpy((void*)old, (const void*)this, sizeof(Segment));
+  old->_t   = nullptr; // copied segment cannot be in transition
+  old->name = nullptr;
+  old->data = nullptr;
+  old->_dataLen = 0;
+  old->pixels = slot.pixels;
+  if (name) {
+    // old effect may depend on the name (scrolling text), name buffer has maximum size so it is allocated only once per slot
+    if (!slot.name) {
+      slot.name = static_cast<char*>(allocate_buffer(WLED_MAX_SEGNAME_LEN+1, BFRALLOC_PREFER_PSRAM));
+      _transitionAllocs++;
+    }
+    if (slot.name) {
+      strlcpy(slot.name, name, WLED_MAX_SEGNAME_LEN+1);
+      old->name = slot.name;
+    }
+  }
+  old->_mapTable = nullptr; // snapshot calculates mapping per pixel (see beginDraw())
+  old->_blendKey = 0; // copy was never blended into frame buffer
+  memcpy(old->pixels, pixels, sizeof(uint32_t) * len);
+  if (data && _dataLen) {
+    #ifndef BOARD_HAS_PSRAM
+    if (Segment::getUsedSegmentData() + _dataLen > MAX_SEGMENT_DATA) {
+      DEBUG_PRINTF_P(PSTR("SegmentData limit reached: %d/%d\n"), _dataLen, Segment::getUsedSegmentData());
+      errorFlag = ERR_NORAM;
+      return old;
+    }
+    #endif
+    if (slot.dataLen < _dataLen) {
+      d_free(slot.data);
+      slot.data = static_cast<byte*>(allocate_buffer(_dataLen, BFRALLOC_PREFER_DRAM));
+      slot.dataLen = slot.data ? _dataLen : 0;
+      _transitionAllocs++;
+    }
+    if (slot.data) {
+      memcpy(slot.data, data, _dataLen);
+      old->data = slot.data;
+      old->_dataLen = _dataLen;
+      Segment::addUsedSegmentData(_dataLen);
+      slot.dataLent = true;
+    } else errorFlag = ERR_NORAM;
+  }
+  return old;
+}
+
 void Segment::startTransition(uint16_t dur, bool segmentCopy) {
   if (dur == 0 || !isActive()) {
     if (isInTransition()) _t->_dur = 0;
@@ -289,7 +447,7 @@ void Segment::startTransition(uint16_t dur, bool segmentCopy) {
   if (isInTransition()) {
     if (segmentCopy && !_t->_oldSegment) {
       // already in transition but segment copy requested and not yet created
-      _t->_oldSegment = new(std::nothrow) Segment(*this); // store/copy current segment settings
+      _t->_oldSegment = takeSnapshot(_t);                 // store/copy current segment settings
       _t->_start = millis();                              // restart countdown
       _t->_dur   = dur;
       _t->_prevPaletteBlends = 0;
@@ -303,8 +461,8 @@ void Segment::startTransition(uint16_t dur, bool segmentCopy) {
     return;
   }
 
-  // no previous transition running, start by allocating memory for segment copy
-  _t = new(std::nothrow) Transition(dur);
+  // no previous transition running, start by taking a slot from the transition pool
+  _t = acquireTransition(dur);
   if (_t) {
     _t->_bri = on ? opacity : 0;
     _t->_cct = cct;
@@ -313,7 +471,7 @@ void Segment::startTransition(uint16_t dur, bool segmentCopy) {
     loadPalette(_t->_palT, palette);
     #endif
     for (int i=0; i<NUM_COLORS; i++) _t->_colors[i] = colors[i];
-    if (segmentCopy) _t->_oldSegment = new(std::nothrow) Segment(*this); // store/copy current segment settings
+    if (segmentCopy) _t->_oldSegment = takeSnapshot(_t); // store/copy current segment settings
     if (_t->_oldSegment) {
       DEBUGFX_PRINTF_P(PSTR("-- Started transition: S=%p T(%p) O[%p] OP[%p]\n"), this, _t, _t->_oldSegment, _t->_oldSegment->pixels);
       if (!_t->_oldSegment->isActive()) stopTransition();
@@ -325,7 +483,7 @@ void Segment::startTransition(uint16_t dur, bool segmentCopy) {
 
 void Segment::stopTransition() {
   DEBUG_PRINTF_P(PSTR("-- Stopping transition: S=%p T(%p) O[%p]\n"), this, _t, _t->_oldSegment);
-  delete _t;
+  releaseTransition(_t);
   _t = nullptr;
 }
 
@@ -367,6 +525,9 @@ uint8_t Segment::currentBri() const {
 // which does not have transition structure
 void Segment::beginDraw(uint16_t prog) {
   setDrawDimensions();
+  #ifndef WLED_DISABLE_2D
+  if (!_modeBlend) updateMappingTable(); // old effect of a transition does without a table (avoids allocation for a short time)
+  #endif
   // load colors into _currentColors
   for (unsigned i = 0; i < NUM_COLORS; i++) _currentColors[i] = colors[i];
   // load palette into _currentPalette
@@ -427,6 +588,7 @@ void Segment::setGeometry(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, ui
   boundsUnchanged &= (grouping == grp && spacing == spc); // changing grouping and/or spacing changes virtual segment length (painting dimensions)
 
   if (stop && (spc > 0 || m12 != map1D2D)) clear();
+  if (!boundsUnchanged || m12 != map1D2D) freeMappingTable(); // rebuilt on next draw
   if (grp) { // prevent assignment of 0
     grouping = grp;
     spacing = spc;
@@ -599,9 +761,9 @@ Segment &Segment::setName(const char *newName) {
   if (newName) {
     const int newLen = min(strlen(newName), (size_t)WLED_MAX_SEGNAME_LEN);
     if (newLen) {
+      if (mode == FX_MODE_2DSCROLLTEXT) startTransition(strip.getTransition(), true); // if the name changes in scrolling text mode, we need to copy the segment (with the old name) for blending
       if (name) p_free(name); // free old name
       name = static_cast<char*>(allocate_buffer(newLen+1, BFRALLOC_PREFER_PSRAM));
-      if (mode == FX_MODE_2DSCROLLTEXT) startTransition(strip.getTransition(), true); // if the name changes in scrolling text mode, we need to copy the segment for blending
       if (name) strlcpy(name, newName, newLen+1);
       return *this;
     }
@@ -646,6 +808,252 @@ static void setPinwheelParameters(int i, int vW, int vH, int& startx, int& start
   startx = (vW * Fixed_Scale) / 2; // + cosVal[0] / 4; // starting position = center + 1/4 pixel (in fixed point)
   starty = (vH * Fixed_Scale) / 2; // + sinVal[0] / 4;
 }
+
+// index groups of a pinwheel ray: its two edge lines are shared with the adjacent rays and only drawn
+// if the adjacent ray was not drawn just before (arc and corner only use M12_DRAW_ALWAYS)
+enum : uint8_t { M12_DRAW_ALWAYS = 0, M12_DRAW_FIRST, M12_DRAW_LAST, M12_DRAW_BOTH, M12_DRAW_GROUPS };
+
+// calls put(group, x, y) for every virtual pixel 1D pixel i expands to in arc, corner or pinwheel mapping
+// (pixels may be outside the segment or repeated)
+template<typename PUT>
+static void expand1D2D(unsigned m12, int i, int vW, int vH, PUT put) {
+  switch (m12) {
+    case M12_pArc:
+      // expand in circular fashion from center
+      if (i == 0)
+        put(M12_DRAW_ALWAYS, 0, 0);
+      else {
+        float r = i;
+        float step = HALF_PI / (2.8284f * r + 4); // we only need (PI/4)/(r/sqrt(2)+1) steps
+        for (float rad = 0.0f; rad <= (HALF_PI/2)+step/2; rad += step) {
+          int x = roundf(sin_t(rad) * r);
+          int y = roundf(cos_t(rad) * r);
+          // exploit symmetry
+          put(M12_DRAW_ALWAYS, x, y);
+          put(M12_DRAW_ALWAYS, y, x);
+        }
+        // Bresenham’s Algorithm (may not fill every pixel)
+        //int d = 3 - (2*i);
+        //int y = i, x = 0;
+        //while (y >= x) {
+        //  put(M12_DRAW_ALWAYS, x, y);
+        //  put(M12_DRAW_ALWAYS, y, x);
+        //  x++;
+        //  if (d > 0) {
+        //    y--;
+        //    d += 4 * (x - y) + 10;
+        //  } else {
+        //    d += 4 * x + 6;
+        //  }
+        //}
+      }
+      break;
+    case M12_pCorner:
+      for (int x = 0; x <= i; x++) put(M12_DRAW_ALWAYS, x, i); // note: <= to include i=0
+      for (int y = 0; y <  i; y++) put(M12_DRAW_ALWAYS, i, y);
+      break;
+    case M12_sPinwheel: {
+      // Uses Bresenham's algorithm to place coordinates of two lines in arrays then draws between them
+      int startX, startY, cosVal[2], sinVal[2]; // in fixed point scale
+      setPinwheelParameters(i, vW, vH, startX, startY, cosVal, sinVal);
+
+      unsigned maxLineLength = max(vW, vH) + 2; // pixels drawn is always smaller than dx or dy, +1 pair for rounding errors
+      uint16_t lineCoords[2][maxLineLength];    // uint16_t to save ram
+      int lineLength[2] = {0};
+
+      int closestEdgeIdx = INT_MAX; // index of the closest edge pixel
+
+      for (int lineNr = 0; lineNr < 2; lineNr++) {
+        int x0 = startX; // x, y coordinates in fixed scale
+        int y0 = startY;
+        int x1 = (startX + (cosVal[lineNr] << 9)); // outside of grid
+        int y1 = (startY + (sinVal[lineNr] << 9)); // outside of grid
+        const int dx =  abs(x1-x0), sx = x0<x1 ? 1 : -1; // x distance & step
+        const int dy = -abs(y1-y0), sy = y0<y1 ? 1 : -1; // y distance & step
+        uint16_t* coordinates = lineCoords[lineNr]; // 1D access is faster
+        int* length = &lineLength[lineNr];          // faster access
+        x0 /= Fixed_Scale; // convert to pixel coordinates
+        y0 /= Fixed_Scale;
+
+        // Bresenham's algorithm
+        int idx = 0;
+        int err = dx + dy;
+        while (true) {
+          if ((unsigned)x0 >= (unsigned)vW || (unsigned)y0 >= (unsigned)vH) {
+            closestEdgeIdx = min(closestEdgeIdx, idx-2);
+            break; // stop if outside of grid (exploit unsigned int overflow)
+          }
+          coordinates[idx++] = x0;
+          coordinates[idx++] = y0;
+          (*length)++;
+          // note: since endpoint is out of grid, no need to check if endpoint is reached
+          int e2 = 2 * err;
+          if (e2 >= dy) { err += dy; x0 += sx; }
+          if (e2 <= dx) { err += dx; y0 += sy; }
+        }
+      }
+
+      // fill up the shorter line with missing coordinates, so block filling works correctly and efficiently
+      int diff = lineLength[0] - lineLength[1];
+      int longLineIdx = (diff > 0) ? 0 : 1;
+      int shortLineIdx = longLineIdx ? 0 : 1;
+      if (diff != 0) {
+        int idx = (lineLength[shortLineIdx] - 1) * 2; // last valid coordinate index
+        int lastX = lineCoords[shortLineIdx][idx++];
+        int lastY = lineCoords[shortLineIdx][idx++];
+        bool keepX = lastX == 0 || lastX == vW - 1;
+        for (int d = 0; d < abs(diff); d++) {
+          lineCoords[shortLineIdx][idx] = keepX ? lastX :lineCoords[longLineIdx][idx];
+          idx++;
+          lineCoords[shortLineIdx][idx] =  keepX ? lineCoords[longLineIdx][idx] : lastY;
+          idx++;
+        }
+      }
+
+      // block-fill the line coordinates. Note: block filling only efficient if angle between lines is small
+      closestEdgeIdx += 2;
+      for (int idx = 0; idx < lineLength[longLineIdx] * 2;) { //!! should be long line idx!
+        int x1 = lineCoords[0][idx];
+        int x2 = lineCoords[1][idx++];
+        int y1 = lineCoords[0][idx];
+        int y2 = lineCoords[1][idx++];
+        int minX, maxX, minY, maxY;
+        (x1 < x2) ? (minX = x1, maxX = x2) : (minX = x2, maxX = x1);
+        (y1 < y2) ? (minY = y1, maxY = y2) : (minY = y2, maxY = y1);
+
+        // fill the block between the two x,y points
+        bool alwaysDraw = (idx > closestEdgeIdx)  || // Edge pixels on uneven lines are always drawn
+                          (i == 0 && idx == 2);      // Center pixel special case
+        for (int x = minX; x <= maxX; x++) {
+          for (int y = minY; y <= maxY; y++) {
+            bool onLine1 = x == x1 && y == y1;
+            bool onLine2 = x == x2 && y == y2;
+            if (alwaysDraw || (!onLine1 && !onLine2)) put(M12_DRAW_ALWAYS, x, y); // middle pixels
+            else if (!onLine2)                        put(M12_DRAW_FIRST,  x, y);
+            else if (!onLine1)                        put(M12_DRAW_LAST,   x, y);
+            else                                      put(M12_DRAW_BOTH,   x, y); // both lines meet
+          }
+        }
+      }
+      break;
+    }
+  }
+}
+
+// virtual pixel read by getPixelColor() for 1D pixel i in arc, corner or pinwheel mapping
+static void mapped1D2DPixel(unsigned m12, int i, int vW, int vH, int &x, int &y) {
+  switch (m12) {
+    case M12_pArc:
+      if (i > vW && i > vH) {
+        x = y = sqrt32_bw(i*i/2);
+        break; // use diagonal
+      }
+      // otherwise fallthrough
+    case M12_pCorner:
+      // use longest dimension
+      if (vW > vH) x = i;
+      else         y = i;
+      break;
+    case M12_sPinwheel: {
+      // not 100% accurate, returns pixel at outer edge
+      int cosVal[2], sinVal[2];
+      setPinwheelParameters(i, vW, vH, x, y, cosVal, sinVal, true);
+      int maxX = (vW-1) * Fixed_Scale;
+      int maxY = (vH-1) * Fixed_Scale;
+      // trace ray from center until we hit any edge - to avoid rounding problems, we use fixed point coordinates
+      while ((x < maxX)  && (y < maxY) && (x > Fixed_Scale) && (y > Fixed_Scale)) {
+        x += cosVal[0]; // advance to next position
+        y += sinVal[0];
+      }
+      x /= Fixed_Scale;
+      y /= Fixed_Scale;
+      break;
+    }
+  }
+}
+
+struct Segment::MappingTable {
+  uint16_t  width, height; // virtual dimensions and mapping the table was built for
+  uint8_t   mapping;
+  uint8_t   groups;        // index groups per 1D pixel (M12_DRAW_GROUPS for pinwheel, 1 otherwise)
+  uint32_t *first;         // start of each group in index[] (1D pixel i, group g: first[i*groups+g]), one extra entry for the end
+  uint16_t *index;         // raw pixel buffer indices (x + y * width), each one only once per group
+  uint16_t *read;          // raw pixel index read by getPixelColor() for each 1D pixel (UINT16_MAX if outside of segment)
+};
+
+// a table without index arrays (first == nullptr) records that there was not enough RAM for its dimensions and mapping
+const Segment::MappingTable *Segment::mappingTable() const {
+  const MappingTable *t = _mapTable;
+  return (t && t->first && t->width == vWidth() && t->height == vHeight() && t->mapping == map1D2D) ? t : nullptr;
+}
+
+// (re)builds mapping table for current draw dimensions if segment uses arc, corner or pinwheel mapping
+// if there is not enough RAM get/setPixelColor() calculate the mapping for each pixel
+void Segment::updateMappingTable() const {
+  if (!is2D() || (map1D2D != M12_pArc && map1D2D != M12_pCorner && map1D2D != M12_sPinwheel)) {
+    if (_mapTable) freeMappingTable();
+    return;
+  }
+  const unsigned vW = vWidth();
+  const unsigned vH = vHeight();
+  if (_mapTable && _mapTable->width == vW && _mapTable->height == vH && _mapTable->mapping == map1D2D) return; // up to date (or allocation already failed)
+  freeMappingTable();
+  const unsigned vL = vLength();
+  const unsigned groups = map1D2D == M12_sPinwheel ? M12_DRAW_GROUPS : 1;
+
+  std::vector<uint32_t> px; // (group << 16) | raw index of all pixels of one 1D pixel, sorted and without duplicates
+  const auto expand = [&](int i) {
+    px.clear();
+    expand1D2D(map1D2D, i, vW, vH, [&](unsigned group, int x, int y) {
+      if ((unsigned)x < vW && (unsigned)y < vH) px.push_back((group << 16) | (x + y * vW));
+    });
+    std::sort(px.begin(), px.end());
+    px.erase(std::unique(px.begin(), px.end()), px.end());
+  };
+  size_t total = 0;
+  for (unsigned i = 0; i < vL; i++) { expand(i); total += px.size(); }
+
+  const size_t size = sizeof(MappingTable) + (vL * groups + 1) * sizeof(uint32_t) + (total + vL) * sizeof(uint16_t);
+  MappingTable *t = static_cast<MappingTable*>(allocate_buffer(size, BFRALLOC_PREFER_PSRAM));
+  if (!t) {
+    DEBUGFX_PRINTLN(F("!!! Not enough RAM for mapping table !!!"));
+    // remember failure so the expansion is not repeated every frame, dimension or mapping change frees it and retries
+    t = static_cast<MappingTable*>(allocate_buffer(sizeof(MappingTable), BFRALLOC_PREFER_PSRAM));
+    if (t) {
+      t->width   = vW;
+      t->height  = vH;
+      t->mapping = map1D2D;
+      t->groups  = groups;
+      t->first   = nullptr;
+      t->index   = nullptr;
+      t->read    = nullptr;
+    }
+    _mapTable = t;
+    return;
+  }
+  t->width   = vW;
+  t->height  = vH;
+  t->mapping = map1D2D;
+  t->groups  = groups;
+  t->first   = reinterpret_cast<uint32_t*>(t + 1);
+  t->index   = reinterpret_cast<uint16_t*>(t->first + vL * groups + 1);
+  t->read    = t->index + total;
+  size_t n = 0;
+  for (unsigned i = 0; i < vL; i++) {
+    expand(i);
+    size_t k = 0;
+    for (unsigned g = 0; g < groups; g++) {
+      t->first[i * groups + g] = n;
+      while (k < px.size() && (px[k] >> 16) == g) t->index[n++] = px[k++] & 0xFFFF;
+    }
+    int x = 0, y = 0;
+    mapped1D2DPixel(map1D2D, i, vW, vH, x, y);
+    t->read[i] = ((unsigned)x < vW && (unsigned)y < vH) ? x + y * vW : UINT16_MAX;
+  }
+  t->first[vL * groups] = n;
+  _mapTable = t;
+  DEBUGFX_PRINTF_P(PSTR("Segment mapping table: %ux%u m12=%u, %u bytes\n"), vW, vH, (unsigned)map1D2D, (unsigned)size);
+}
 #endif
 
 // 1D strip
@@ -743,132 +1151,31 @@ void WLED_O2_ATTR Segment::setPixelColor(int i, uint32_t col) const
         else for (int x = 0; x < vW; x++) setPixelColorRaw(XY(x, vH - i - 1), col);
         break;
       case M12_pArc:
-        // expand in circular fashion from center
-        if (i == 0)
-          setPixelColorRaw(XY(0, 0), col);
-        else {
-          float r = i;
-          float step = HALF_PI / (2.8284f * r + 4); // we only need (PI/4)/(r/sqrt(2)+1) steps
-          for (float rad = 0.0f; rad <= (HALF_PI/2)+step/2; rad += step) {
-            int x = roundf(sin_t(rad) * r);
-            int y = roundf(cos_t(rad) * r);
-            // exploit symmetry
-            setPixelColorXY(x, y, col);
-            setPixelColorXY(y, x, col);
-          }
-          // Bresenham’s Algorithm (may not fill every pixel)
-          //int d = 3 - (2*i);
-          //int y = i, x = 0;
-          //while (y >= x) {
-          //  setPixelColorXY(x, y, col);
-          //  setPixelColorXY(y, x, col);
-          //  x++;
-          //  if (d > 0) {
-          //    y--;
-          //    d += 4 * (x - y) + 10;
-          //  } else {
-          //    d += 4 * x + 6;
-          //  }
-          //}
-        }
-        break;
       case M12_pCorner:
-        for (int x = 0; x <= i; x++) setPixelColorXY(x, i, col); // note: <= to include i=0. Relies on overflow check in sPC()
-        for (int y = 0; y <  i; y++) setPixelColorXY(i, y, col);
-        break;
       case M12_sPinwheel: {
-        // Uses Bresenham's algorithm to place coordinates of two lines in arrays then draws between them
-        int startX, startY, cosVal[2], sinVal[2]; // in fixed point scale
-        setPinwheelParameters(i, vW, vH, startX, startY, cosVal, sinVal);
-
-        unsigned maxLineLength = max(vW, vH) + 2; // pixels drawn is always smaller than dx or dy, +1 pair for rounding errors
-        uint16_t lineCoords[2][maxLineLength];    // uint16_t to save ram
-        int lineLength[2] = {0};
-
-        static int prevRays[2] = {INT_MAX, INT_MAX}; // previous two ray numbers
-        int closestEdgeIdx = INT_MAX; // index of the closest edge pixel
-
-        for (int lineNr = 0; lineNr < 2; lineNr++) {
-          int x0 = startX; // x, y coordinates in fixed scale
-          int y0 = startY;
-          int x1 = (startX + (cosVal[lineNr] << 9)); // outside of grid
-          int y1 = (startY + (sinVal[lineNr] << 9)); // outside of grid
-          const int dx =  abs(x1-x0), sx = x0<x1 ? 1 : -1; // x distance & step
-          const int dy = -abs(y1-y0), sy = y0<y1 ? 1 : -1; // y distance & step
-          uint16_t* coordinates = lineCoords[lineNr]; // 1D access is faster
-          int* length = &lineLength[lineNr];          // faster access
-          x0 /= Fixed_Scale; // convert to pixel coordinates
-          y0 /= Fixed_Scale;
-
-          // Bresenham's algorithm
-          int idx = 0;
-          int err = dx + dy;
-          while (true) {
-            if ((unsigned)x0 >= (unsigned)vW || (unsigned)y0 >= (unsigned)vH) {
-              closestEdgeIdx = min(closestEdgeIdx, idx-2);
-              break; // stop if outside of grid (exploit unsigned int overflow)
-            }
-            coordinates[idx++] = x0;
-            coordinates[idx++] = y0;
-            (*length)++;
-            // note: since endpoint is out of grid, no need to check if endpoint is reached
-            int e2 = 2 * err;
-            if (e2 >= dy) { err += dy; x0 += sx; }
-            if (e2 <= dx) { err += dx; y0 += sy; }
-          }
+        unsigned draw = 1U << M12_DRAW_ALWAYS; // index groups to draw
+        if (map1D2D == M12_sPinwheel) {
+          static int prevRays[2] = {INT_MAX, INT_MAX}; // previous two ray numbers
+          int max_i = getPinwheelLength(vW, vH) - 1;
+          bool drawFirst = !(prevRays[0] == i - 1 || (i == 0 && prevRays[0] == max_i)); // draw first line if previous ray was not adjacent including wrap
+          bool drawLast  = !(prevRays[0] == i + 1 || (i == max_i && prevRays[0] == 0)); // same as above for last line
+          bool drawAll   = (drawFirst && drawLast) || // No adjacent rays, draw all pixels
+                           (i == prevRays[1]);        // Effect drawing twice in 1 frame
+          if (drawFirst || drawAll) draw |= 1U << M12_DRAW_FIRST;
+          if (drawLast  || drawAll) draw |= 1U << M12_DRAW_LAST;
+          if (drawAll)              draw |= 1U << M12_DRAW_BOTH;
+          prevRays[1] = prevRays[0];
+          prevRays[0] = i;
         }
-
-        // fill up the shorter line with missing coordinates, so block filling works correctly and efficiently
-        int diff = lineLength[0] - lineLength[1];
-        int longLineIdx = (diff > 0) ? 0 : 1;
-        int shortLineIdx = longLineIdx ? 0 : 1;
-        if (diff != 0) {
-          int idx = (lineLength[shortLineIdx] - 1) * 2; // last valid coordinate index
-          int lastX = lineCoords[shortLineIdx][idx++];
-          int lastY = lineCoords[shortLineIdx][idx++];
-          bool keepX = lastX == 0 || lastX == vW - 1;
-          for (int d = 0; d < abs(diff); d++) {
-            lineCoords[shortLineIdx][idx] = keepX ? lastX :lineCoords[longLineIdx][idx];
-            idx++;
-            lineCoords[shortLineIdx][idx] =  keepX ? lineCoords[longLineIdx][idx] : lastY;
-            idx++;
+        if (const MappingTable *t = mappingTable()) {
+          const unsigned groups = t->groups;
+          for (unsigned g = 0; g < groups; g++) {
+            if (!(draw & (1U << g))) continue;
+            const uint32_t end = t->first[i * groups + g + 1];
+            for (uint32_t k = t->first[i * groups + g]; k < end; k++) setPixelColorRaw(t->index[k], col);
           }
-        }
-
-        // draw and block-fill the line coordinates. Note: block filling only efficient if angle between lines is small
-        closestEdgeIdx += 2;
-        int max_i = getPinwheelLength(vW, vH) - 1;
-        bool drawFirst = !(prevRays[0] == i - 1 || (i == 0 && prevRays[0] == max_i)); // draw first line if previous ray was not adjacent including wrap
-        bool drawLast  = !(prevRays[0] == i + 1 || (i == max_i && prevRays[0] == 0)); // same as above for last line
-        for (int idx = 0; idx < lineLength[longLineIdx] * 2;) { //!! should be long line idx!
-          int x1 = lineCoords[0][idx];
-          int x2 = lineCoords[1][idx++];
-          int y1 = lineCoords[0][idx];
-          int y2 = lineCoords[1][idx++];
-          int minX, maxX, minY, maxY;
-          (x1 < x2) ? (minX = x1, maxX = x2) : (minX = x2, maxX = x1);
-          (y1 < y2) ? (minY = y1, maxY = y2) : (minY = y2, maxY = y1);
-
-          // fill the block between the two x,y points
-          bool alwaysDraw = (drawFirst && drawLast) || // No adjacent rays, draw all pixels
-                            (idx > closestEdgeIdx)  || // Edge pixels on uneven lines are always drawn
-                            (i == 0 && idx == 2)    || // Center pixel special case
-                            (i == prevRays[1]);        // Effect drawing twice in 1 frame
-          for (int x = minX; x <= maxX; x++) {
-            for (int y = minY; y <= maxY; y++) {
-              bool onLine1 = x == x1 && y == y1;
-              bool onLine2 = x == x2 && y == y2;
-              if ((alwaysDraw) ||
-                  (!onLine1 && (!onLine2 || drawLast))  || // Middle pixels and line2 if drawLast
-                  (!onLine2 && (!onLine1 || drawFirst))    // Middle pixels and line1 if drawFirst
-                ) {
-                setPixelColorXY(x, y, col);
-              }
-            }
-          }
-        }
-        prevRays[1] = prevRays[0];
-        prevRays[0] = i;
+        } else
+          expand1D2D(map1D2D, i, vW, vH, [&](unsigned group, int x, int y) { if (draw & (1U << group)) setPixelColorXY(x, y, col); });
         break;
       }
     }
@@ -947,31 +1254,11 @@ uint32_t WLED_O2_ATTR Segment::getPixelColor(int i) const
         else            { y = vH - i - 1; };
         break;
       case M12_pArc:
-        if (i > vW && i > vH) {
-          x = y = sqrt32_bw(i*i/2);
-          break; // use diagonal
-        }
-        // otherwise fallthrough
       case M12_pCorner:
-        // use longest dimension
-        if (vW > vH) x = i;
-        else         y = i;
-        break;
-      case M12_sPinwheel: {
-        // not 100% accurate, returns pixel at outer edge
-        int cosVal[2], sinVal[2];
-        setPinwheelParameters(i, vW, vH, x, y, cosVal, sinVal, true);
-        int maxX = (vW-1) * Fixed_Scale;
-        int maxY = (vH-1) * Fixed_Scale;
-        // trace ray from center until we hit any edge - to avoid rounding problems, we use fixed point coordinates
-        while ((x < maxX)  && (y < maxY) && (x > Fixed_Scale) && (y > Fixed_Scale)) {
-          x += cosVal[0]; // advance to next position
-          y += sinVal[0];
-        }
-        x /= Fixed_Scale;
-        y /= Fixed_Scale;
+      case M12_sPinwheel:
+        if (const MappingTable *t = mappingTable()) return t->read[i] < unsigned(vW * vH) ? getPixelColorRaw(t->read[i]) : 0;
+        mapped1D2DPixel(map1D2D, i, vW, vH, x, y);
         break;
-      }
     }
     return getPixelColorXY(x, y);
   }
@@ -1053,15 +1340,13 @@ void Segment::fade_out(uint8_t rate) const {
 // fades all pixels to secondary color
 void Segment::fadeToSecondaryBy(uint8_t fadeBy) const {
   if (!isActive() || fadeBy == 0) return;   // optimization - no scaling to apply
-  const size_t rlength = rawLength();  // calculate only once
-  for (unsigned i = 0; i < rlength; i++) setPixelColorRaw(i, color_blend(getPixelColorRaw(i), colors[1], fadeBy));
+  blendBuffer(pixels, rawLength(), colors[1], fadeBy);
 }
 
 // fades all pixels to black using nscale8()
 void Segment::fadeToBlackBy(uint8_t fadeBy) const {
   if (!isActive() || fadeBy == 0) return;   // optimization - no scaling to apply
-  const size_t rlength = rawLength();  // calculate only once
-  for (unsigned i = 0; i < rlength; i++) setPixelColorRaw(i, fast_color_scale(getPixelColorRaw(i), 255-fadeBy));
+  fadeBuffer(pixels, rawLength(), 255-fadeBy);
 }
 
 /*
@@ -1080,20 +1365,7 @@ void Segment::blur(uint8_t blur_amount, bool smear) const {
 #endif
   uint8_t keep = smear ? 255 : 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
-  unsigned vlength = vLength();
-  // handle first pixel to avoid conditional in loop (faster)
-  uint32_t cur = getPixelColorRaw(0);
-  uint32_t carryover = fast_color_scale(cur, seep);
-  setPixelColorRaw(0, fast_color_scale(cur, keep));
-  for (unsigned i = 1; i < vlength; i++) {
-    cur = getPixelColorRaw(i);
-    uint32_t part = fast_color_scale(cur, seep);
-    cur = fast_color_scale(cur, keep);
-    cur = color_add(cur, carryover);
-    setPixelColorRaw(i - 1, color_add(getPixelColorRaw(i - 1), part)); // previous pixel
-    setPixelColorRaw(i, cur); // current pixel
-    carryover = part;
-  }
+  blurRow(pixels, vLength(), 1, keep, seep);
 }
 
 /*
@@ -1252,6 +1524,18 @@ void WS2812FX::finalizeInit() {
   p_free(_pixels); // using realloc on large buffers can cause additional fragmentation instead of reducing it
   // use PSRAM if available: there is no measurable perfomance impact between PSRAM and DRAM on S2/S3 with QSPI PSRAM for this buffer
   _pixels = static_cast<uint32_t*>(allocate_buffer(getLengthTotal() * sizeof(uint32_t), BFRALLOC_ENFORCE_PSRAM | BFRALLOC_NOBYTEACCESS | BFRALLOC_CLEAR));
+  _composed = false;
+  p_free(_pixelsMapped); // reallocated on first use with a ledmap
+  _pixelsMapped    = nullptr;
+  _pixelsMappedLen = 0;
+#ifdef WLED_PIPELINED_RENDER
+  dropQueuedFrame();
+  p_free(_pixelsOut);
+  _pixelsOut = static_cast<uint32_t*>(allocate_buffer(getLengthTotal() * sizeof(uint32_t), BFRALLOC_ENFORCE_PSRAM | BFRALLOC_NOBYTEACCESS | BFRALLOC_CLEAR));
+  if (!_pixelsOut) DEBUG_PRINTLN(F("No memory for output buffer, rendering in loop task."));
+  // Arduino loop task runs on core 1 (WiFi on core 0), render on the other one
+  if (!_renderTask) xTaskCreatePinnedToCore(renderTask, "FX_render", WLED_RENDER_TASK_STACK, this, 1, &_renderTask, xPortGetCoreID() ? 0 : 1);
+#endif
   DEBUG_PRINTF_P(PSTR("strip buffer size: %uB\n"), getLengthTotal() * sizeof(uint32_t));
   DEBUG_PRINTF_P(PSTR("Heap after strip init: %uB\n"), getFreeHeapSize());
 }
@@ -1265,9 +1549,62 @@ void WS2812FX::service() {
     if (elapsed < _frametime) return;                   // too early for service
   }
 
-  bool doShow = false;
-
   _isServicing = true;
+#ifdef WLED_PIPELINED_RENDER
+  if (_renderTask && _pixelsOut && (realtimeMode == REALTIME_MODE_INACTIVE || useMainSegmentOnly || realtimeOverride > REALTIME_OVERRIDE_NONE)) {
+    // frame N+1 is rendered on the other core while this one sends out frame N
+    // loop task blocks until rendering is done so code running in loop() context can still modify segments
+    _renderUp    = nowUp;
+    _serviceTask = xTaskGetCurrentTaskHandle();
+    xTaskNotifyGive(_renderTask);
+    if (_frameQueued) {
+      outputFrame(_pixelsOut, _pixelCCTOut);
+      dropQueuedFrame();
+    }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (_frameRendered) {
+      drawOverlays(); // after the join, render task is idle
+      const size_t totalLen = getLengthTotal();
+      for (size_t i = 0; i < totalLen; i++) _pixelsOut[i] = _pixels[i]; // no byte access allowed, _pixels keeps composition for next frame
+      _pixelCCTOut = _pixelCCT; // CCT buffer is allocated per frame, hand it over
+      _pixelCCT    = nullptr;
+      _frameQueued = true;
+    }
+  } else
+#endif
+  if (renderEffects(nowUp)) {
+    show();
+    #ifdef WLED_DEBUG
+    if ((_targetFps != FPS_UNLIMITED) && (millis() - nowUp > _frametime)) DEBUG_PRINTF_P(PSTR("Slow strip %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
+    #endif
+  }
+
+  _triggered = false;
+  _isServicing = false;
+}
+
+#ifdef WLED_PIPELINED_RENDER
+void WS2812FX::renderTask(void *parameter) {
+  WS2812FX *instance = static_cast<WS2812FX*>(parameter);
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // wait for service()
+    instance->_frameRendered = instance->renderEffects(instance->_renderUp);
+    if (instance->_frameRendered) instance->composeFrame();
+    xTaskNotifyGive(instance->_serviceTask);
+    vTaskDelay(1); // with FPS_UNLIMITED the next request is already pending, let IDLE task run (task watchdog)
+  }
+}
+
+void WS2812FX::dropQueuedFrame() {
+  p_free(_pixelCCTOut);
+  _pixelCCTOut = nullptr;
+  _frameQueued = false;
+}
+#endif
+
+// runs effect functions of all segments that are due, returns true if frame needs to be shown
+bool WS2812FX::renderEffects(unsigned long nowUp) {
+  bool doShow = false;
   _segment_index = 0;
 
   for (Segment &seg : _segments) {
@@ -1283,10 +1620,13 @@ void WS2812FX::service() {
     // last condition ensures all solid segments are updated at the same time
     if (nowUp > seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))
     {
+      // a solid segment refreshed only to stay in sync with others renders the same pixels again (colour changes come with trigger())
+      const bool redraw = nowUp > seg.next_time || _triggered || seg.isInTransition();
       doShow = true;
       unsigned frameDelay = FRAMETIME;
 
       if (!seg.freeze) { //only run effect function if not frozen
+        if (redraw) seg.markDirty();    // segment's region in frame buffer needs re-blending
         // Effect blending
         uint16_t prog = seg.progress();
         seg.beginDraw(prog);                // set up parameters for get/setPixelColor() (will also blend colors and palette if blend style is FADE)
@@ -1318,18 +1658,17 @@ void WS2812FX::service() {
   #ifdef WLED_DEBUG
   if ((_targetFps != FPS_UNLIMITED) && (millis() - nowUp > _frametime)) DEBUG_PRINTF_P(PSTR("Slow effects %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
   #endif
+  Segment::handleTransitionPool();
+  #ifndef WLED_DISABLE_PARTICLESYSTEM2D
+  handleCollisionGrid2D();
+  #endif
   if (doShow && !_suspend) {
     yield();
     Segment::handleRandomPalette(); // slowly transition random palette; move it into for loop when each segment has individual random palette
     _lastServiceShow = nowUp; // update timestamp, for precise FPS control
-    show();
+    return true;
   }
-  #ifdef WLED_DEBUG
-  if ((_targetFps != FPS_UNLIMITED) && (millis() - nowUp > _frametime)) DEBUG_PRINTF_P(PSTR("Slow strip %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
-  #endif
-
-  _triggered = false;
-  _isServicing = false;
+  return false;
 }
 
 // https://en.wikipedia.org/wiki/Blend_modes but using a for top layer & b for bottom layer
@@ -1358,6 +1697,127 @@ static uint8_t _softlight (uint8_t a, uint8_t b) { return (b * b * (255 - 2 * a)
 static uint8_t _dodge     (uint8_t a, uint8_t b) { return _divide(~a,b); }
 static uint8_t _burn      (uint8_t a, uint8_t b) { return ~_divide(a,~b); }
 
+// blend mode applied to all 4 channels, specialized per blend function so the kernels below inline it
+template<uint8_t (*FN)(uint8_t, uint8_t)>
+struct BlendOp {
+  inline uint32_t operator()(uint32_t top, uint32_t bottom) const { return RGBW32(FN(R(top),R(bottom)), FN(G(top),G(bottom)), FN(B(top),B(bottom)), FN(W(top),W(bottom))); }
+};
+template<> struct BlendOp<_top> {
+  inline uint32_t operator()(uint32_t top, uint32_t bottom) const { return top; }
+};
+// blend mode selected at runtime (blend modes without specialized kernel)
+struct BlendOpAny {
+  uint8_t (*fn)(uint8_t, uint8_t);
+  inline uint32_t operator()(uint32_t top, uint32_t bottom) const { return RGBW32(fn(R(top),R(bottom)), fn(G(top),G(bottom)), fn(B(top),B(bottom)), fn(W(top),W(bottom))); }
+};
+
+template<class Op, bool MIRRORED, bool TRACK_CCT>
+void WLED_O2_ATTR WS2812FX::blendPlain1D(const Segment &topSegment, Op op, uint8_t o, uint8_t cct) const {
+  const int nLen   = topSegment.virtualLength();
+  const int length = topSegment.length();
+  const unsigned groupLen = topSegment.groupLength();
+  const uint32_t *src = topSegment.getPixels();
+  const auto put = [&](unsigned indx, uint32_t c) {
+    if (indx >= topSegment.stop) indx -= length; // wrap
+    const uint32_t blended = op(c, _pixels[indx]);
+    _pixels[indx] = o == 255 ? blended : color_blend(_pixels[indx], blended, o);
+    if (TRACK_CCT) _pixelCCT[indx] = cct;
+  };
+  for (int k = 0; k < nLen; k++) {
+    const uint32_t c = src[k];
+    int i = (topSegment.reverse ? nLen - k - 1 : k) * groupLen;
+    const int maxI = std::min(i + topSegment.grouping, length); // make sure to not go beyond physical length
+    for (; i < maxI; i++) {
+      if (MIRRORED) put(topSegment.stop - i - 1 + topSegment.offset, c);
+      put(topSegment.start + i + topSegment.offset, c);
+    }
+  }
+}
+
+#ifndef WLED_DISABLE_2D
+template<class Op, bool MIRRORED, bool TRACK_CCT>
+void WLED_O2_ATTR WS2812FX::blendPlain2D(const Segment &topSegment, Op op, uint8_t o, uint8_t cct) const {
+  const int nCols  = topSegment.virtualWidth();
+  const int nRows  = topSegment.virtualHeight();
+  const int width  = topSegment.width();
+  const int height = topSegment.height();
+  const unsigned groupLen = topSegment.groupLength();
+  const uint32_t *src = topSegment.getPixels();
+  const auto XY = [](int x, int y){ return x + y*Segment::maxWidth; };
+  const auto put = [&](size_t indx, uint32_t c) {
+    const uint32_t blended = op(c, _pixels[indx]);
+    _pixels[indx] = o == 255 ? blended : color_blend(_pixels[indx], blended, o);
+    if (TRACK_CCT) _pixelCCT[indx] = cct;
+  };
+  const auto putMirrored = [&](int x, int y, uint32_t c) {
+    const int baseX = topSegment.start  + x;
+    const int baseY = topSegment.startY + y;
+    put(XY(baseX, baseY), c);
+    if (MIRRORED) {
+      const int mirrorX = topSegment.start  + width  - x - 1;
+      const int mirrorY = topSegment.startY + height - y - 1;
+      if (topSegment.mirror)   put(XY(topSegment.transpose ? baseX : mirrorX, topSegment.transpose ? mirrorY : baseY), c);
+      if (topSegment.mirror_y) put(XY(topSegment.transpose ? mirrorX : baseX, topSegment.transpose ? baseY : mirrorY), c);
+      if (topSegment.mirror && topSegment.mirror_y) put(XY(mirrorX, mirrorY), c);
+    }
+  };
+  for (int r = 0; r < nRows; r++) for (int c = 0; c < nCols; c++) {
+    const uint32_t col = src[c + r*nCols];
+    int x = topSegment.reverse   ? nCols - c - 1 : c;
+    int y = topSegment.reverse_y ? nRows - r - 1 : r;
+    if (topSegment.transpose) std::swap(x,y); // swap X & Y if segment transposed
+    if (groupLen == 1) {
+      putMirrored(x, y, col);
+    } else {
+      // handle grouping and spacing
+      x *= groupLen; // expand to physical pixels
+      y *= groupLen; // expand to physical pixels
+      const int maxX = std::min(x + topSegment.grouping, width);
+      const int maxY = std::min(y + topSegment.grouping, height);
+      for (; y < maxY; y++) for (int _x = x; _x < maxX; _x++) putMirrored(_x, y, col);
+    }
+  }
+}
+#endif
+
+// segment without transition: a top layer at full opacity is a plain copy, everything else goes through a kernel
+template<class Op>
+void WS2812FX::blendSegmentPlain(const Segment &topSegment, Op op, uint8_t o, uint8_t cct, bool is2D) const {
+  const uint32_t *src = topSegment.getPixels();
+  const bool copy = std::is_same<Op, BlendOp<_top>>::value && o == 255 && topSegment.groupLength() == 1 && !topSegment.reverse && !topSegment.mirror;
+#ifndef WLED_DISABLE_2D
+  if (is2D) {
+    if (copy && !topSegment.mirror_y && !topSegment.transpose) {
+      // row-wise copy
+      const int nCols = topSegment.virtualWidth();
+      const int nRows = topSegment.virtualHeight();
+      for (int r = 0; r < nRows; r++) {
+        const int    y    = topSegment.reverse_y ? nRows - r - 1 : r;
+        const size_t indx = topSegment.start + (topSegment.startY + y) * Segment::maxWidth;
+        memcpy(&_pixels[indx], &src[r * nCols], nCols * sizeof(uint32_t));
+        if (_pixelCCT) memset(&_pixelCCT[indx], cct, nCols);
+      }
+      return;
+    }
+    const bool mirror = topSegment.mirror || topSegment.mirror_y;
+    if (_pixelCCT) mirror ? blendPlain2D<Op, true, true >(topSegment, op, o, cct) : blendPlain2D<Op, false, true >(topSegment, op, o, cct);
+    else           mirror ? blendPlain2D<Op, true, false>(topSegment, op, o, cct) : blendPlain2D<Op, false, false>(topSegment, op, o, cct);
+    return;
+  }
+#endif
+  const unsigned length = topSegment.length();
+  if (copy && topSegment.offset < length) {
+    // copy in two parts: offset (phase) wraps around at the end of the segment
+    const unsigned first = length - topSegment.offset;
+    memcpy(&_pixels[topSegment.start + topSegment.offset], src, first * sizeof(uint32_t));
+    memcpy(&_pixels[topSegment.start], &src[first], topSegment.offset * sizeof(uint32_t));
+    if (_pixelCCT) memset(&_pixelCCT[topSegment.start], cct, length);
+    return;
+  }
+  if (_pixelCCT) topSegment.mirror ? blendPlain1D<Op, true, true >(topSegment, op, o, cct) : blendPlain1D<Op, false, true >(topSegment, op, o, cct);
+  else           topSegment.mirror ? blendPlain1D<Op, true, false>(topSegment, op, o, cct) : blendPlain1D<Op, false, false>(topSegment, op, o, cct);
+}
+
 void WS2812FX::blendSegment(const Segment &topSegment) const {
 
   typedef uint8_t(*FuncType)(uint8_t, uint8_t);
@@ -1386,6 +1846,33 @@ void WS2812FX::blendSegment(const Segment &topSegment) const {
 
   Segment::setClippingRect(0, 0);             // disable clipping by default
 
+  // segment is not in transition (and not turned off using a transition style): no clipping, pushing or fading
+  if (!topSegment.isInTransition() && (blendingStyle == BLEND_STYLE_FADE || !((briOld == 0 || bri == 0) && (bri != briT) && !bri))) {
+    const bool is2D = isMatrix && stopIndx <= matrixSize;
+    switch (blendMode) {
+      case  0: blendSegmentPlain(topSegment, BlendOp<_top>(),        opacity, cct, is2D); break;
+      #ifndef ESP8266 // save flash, other blend modes use the generic kernel
+      case  1: blendSegmentPlain(topSegment, BlendOp<_bottom>(),     opacity, cct, is2D); break;
+      case  2: blendSegmentPlain(topSegment, BlendOp<_add>(),        opacity, cct, is2D); break;
+      case  3: blendSegmentPlain(topSegment, BlendOp<_subtract>(),   opacity, cct, is2D); break;
+      case  4: blendSegmentPlain(topSegment, BlendOp<_difference>(), opacity, cct, is2D); break;
+      case  5: blendSegmentPlain(topSegment, BlendOp<_average>(),    opacity, cct, is2D); break;
+      case  6: blendSegmentPlain(topSegment, BlendOp<_multiply>(),   opacity, cct, is2D); break;
+      case  7: blendSegmentPlain(topSegment, BlendOp<_divide>(),     opacity, cct, is2D); break;
+      case  8: blendSegmentPlain(topSegment, BlendOp<_lighten>(),    opacity, cct, is2D); break;
+      case  9: blendSegmentPlain(topSegment, BlendOp<_darken>(),     opacity, cct, is2D); break;
+      case 10: blendSegmentPlain(topSegment, BlendOp<_screen>(),     opacity, cct, is2D); break;
+      case 11: blendSegmentPlain(topSegment, BlendOp<_overlay>(),    opacity, cct, is2D); break;
+      case 12: blendSegmentPlain(topSegment, BlendOp<_hardlight>(),  opacity, cct, is2D); break;
+      case 13: blendSegmentPlain(topSegment, BlendOp<_softlight>(),  opacity, cct, is2D); break;
+      case 14: blendSegmentPlain(topSegment, BlendOp<_dodge>(),      opacity, cct, is2D); break;
+      case 15: blendSegmentPlain(topSegment, BlendOp<_burn>(),       opacity, cct, is2D); break;
+      #endif
+      default: blendSegmentPlain(topSegment, BlendOpAny{func},       opacity, cct, is2D); break;
+    }
+    return;
+  }
+
   const unsigned dw = (blendingStyle==BLEND_STYLE_OUTSIDE_IN ? progInv : progress) * width / 0xFFFFU + 1;
   const unsigned dh = (blendingStyle==BLEND_STYLE_OUTSIDE_IN ? progInv : progress) * height / 0xFFFFU + 1;
   const unsigned orgBS = blendingStyle;
@@ -1594,58 +2081,188 @@ void WS2812FX::blendSegment(const Segment &topSegment) const {
   Segment::setClippingRect(0, 0);             // disable clipping for overlays
 }
 
+// hash of everything (besides segment's pixels) that determines what blendSegment() writes into frame buffer
+static uint32_t segmentBlendKey(const Segment &seg) {
+  uint32_t key = 2166136261UL; // FNV-1a
+  const auto mix = [&key](uint32_t v) { for (unsigned i = 0; i < 4; i++, v >>= 8) { key ^= v & 0xFF; key *= 16777619UL; } };
+  mix(seg.start  | (uint32_t)seg.stop  << 16);
+  mix(seg.startY | (uint32_t)seg.stopY << 16);
+  mix(seg.offset | (uint32_t)seg.grouping << 16 | (uint32_t)seg.spacing << 24);
+  mix(seg.reverse | seg.mirror << 1 | seg.reverse_y << 2 | seg.mirror_y << 3 | seg.transpose << 4 | (uint32_t)seg.blendMode << 8 | (uint32_t)seg.currentBri() << 16);
+  mix(Segment::maxWidth | (uint32_t)Segment::maxHeight << 16);
+  return key | 1; // 0 means "not composed"
+}
+
+// clears frame buffer and blends all visible segments into it
+// segments that did not change since last frame, are fully opaque and do not overlap any other visible segment
+// still have their pixels in frame buffer (composition cache) so their region is neither cleared nor re-blended
+void WS2812FX::composeSegments() {
+  const size_t totalLen   = getLengthTotal();
+  const size_t matrixSize = Segment::maxWidth * Segment::maxHeight;
+  const bool   useCache   = _composed && !_pixelCCT; // CCT buffer is rebuilt every frame
+
+  struct Region { unsigned x0, x1, y0, y1; };
+  // footprint of a segment in frame buffer: 2D segments use matrix coordinates, 1D segments (also those
+  // appended to the matrix) use pixel indices in a row of their own
+  const auto footprint = [&](const Segment &seg) -> Region {
+    const size_t startIndx = seg.start + seg.startY * Segment::maxWidth;
+    if (isMatrix && startIndx + seg.length() <= matrixSize) return {seg.start, seg.stop, seg.startY, seg.stopY};
+    if (isMatrix && seg.start < matrixSize) return {0, UINT_MAX, 0, UINT_MAX}; // 1D segment within matrix: may touch anything
+    return {seg.start, seg.stop, Segment::maxHeight, Segment::maxHeight + 1U};
+  };
+  const auto visible = [](const Segment &seg) { return seg.isActive() && (seg.on || seg.isInTransition()); };
+
+  // find segments whose region can be kept
+  static_assert(MAX_NUM_SEGMENTS <= 64, "composeSegments() keeps one bit per segment in a uint64_t");
+  uint64_t keep  = 0; // bit mask of segments whose region is kept
+  uint64_t alone = 0; // bit mask of visible segments not overlapping any other visible segment
+  for (size_t i = 0; i < _segments.size(); i++) {
+    const Segment &seg = _segments[i];
+    if (!visible(seg)) { seg.markDirty(); continue; } // nothing blended; region must be cleared once it reappears
+    const Region a = footprint(seg);
+    bool overlap = false;
+    for (size_t j = 0; j < _segments.size() && !overlap; j++) {
+      if (j == i || !visible(_segments[j])) continue;
+      const Region b = footprint(_segments[j]);
+      overlap = a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+    }
+    if (overlap || seg.isInTransition()) continue;
+    alone |= 1ULL << i;
+    if (useCache && seg.currentBri() == 255 && seg._blendKey == segmentBlendKey(seg)) keep |= 1ULL << i;
+  }
+
+  // clear frame buffer (except kept regions)
+  if (!keep) {
+    for (size_t i = 0; i < totalLen; i++) _pixels[i] = BLACK; // memset(_pixels, 0, sizeof(uint32_t) * getLengthTotal());
+  } else {
+    std::vector<std::pair<size_t,size_t>> spans; // kept index ranges [first, second)
+    for (size_t i = 0; i < _segments.size(); i++) {
+      if (!(keep & (1ULL << i))) continue;
+      const Segment &seg = _segments[i];
+      const Region r = footprint(seg);
+      if (r.y0 < Segment::maxHeight && isMatrix) for (unsigned y = r.y0; y < r.y1; y++) spans.emplace_back(r.x0 + y * Segment::maxWidth, r.x1 + y * Segment::maxWidth);
+      else spans.emplace_back(r.x0, r.x1);
+    }
+    std::sort(spans.begin(), spans.end());
+    size_t i = 0;
+    for (const auto &span : spans) {
+      for (; i < span.first && i < totalLen; i++) _pixels[i] = BLACK;
+      i = std::max(i, span.second);
+    }
+    for (; i < totalLen; i++) _pixels[i] = BLACK;
+  }
+
+  // blend remaining segments into (cleared) buffer
+  for (size_t i = 0; i < _segments.size(); i++) {
+    const Segment &seg = _segments[i];
+    if (!visible(seg) || (keep & (1ULL << i))) continue;
+    blendSegment(seg);              // blend segment's buffer into frame buffer
+    seg._blendKey = (alone & (1ULL << i)) ? segmentBlendKey(seg) : 0;
+  }
+  _composed = true;
+}
+
 void WS2812FX::show() {
   if (!_pixels) {
     DEBUGFX_PRINTLN(F("Error: no _pixels!"));
     errorFlag = ERR_NORAM;
     return; // no pixels allocated, nothing to show
   }
+#ifdef WLED_PIPELINED_RENDER
+  if (_frameQueued) dropQueuedFrame(); // superseded by this frame (i.e. realtime data)
+#endif
+  composeFrame();
+  drawOverlays();
+  outputFrame(_pixels, _pixelCCT);
+  p_free(_pixelCCT);
+  _pixelCCT = nullptr;
+}
 
-  unsigned long showNow = millis();
-  size_t diff = showNow - _lastShow;
-
+void WS2812FX::composeFrame() {
   size_t totalLen = getLengthTotal();
   // WARNING: as WLED doesn't handle CCT on pixel level but on Segment level instead
   // we need to keep track of each pixel's CCT when blending segments (if CCT is present)
-  // and then set appropriate CCT from that pixel during paint (see below).
+  // and then set appropriate CCT from that pixel during paint (see outputFrame()).
   if ((hasCCTBus() || correctWB) && !cctFromRgb)
     _pixelCCT = static_cast<uint8_t*>(allocate_buffer(totalLen * sizeof(uint8_t), BFRALLOC_PREFER_PSRAM)); // allocate CCT buffer if necessary, prefer PSRAM
   if (_pixelCCT) memset(_pixelCCT, 127, totalLen); // set neutral (50:50) CCT
 
   if (realtimeMode == REALTIME_MODE_INACTIVE || useMainSegmentOnly || realtimeOverride > REALTIME_OVERRIDE_NONE) {
-    // clear frame buffer
-    for (size_t i = 0; i < totalLen; i++) _pixels[i] = BLACK; // memset(_pixels, 0, sizeof(uint32_t) * getLengthTotal());
-    // blend all segments into (cleared) buffer
-    for (Segment &seg : _segments) if (seg.isActive() && (seg.on || seg.isInTransition())) {
-      blendSegment(seg);              // blend segment's buffer into frame buffer
-    }
-  }
+    composeSegments();
+  } else _composed = false; // frame buffer is written directly by realtime protocols
+}
 
+// usermod overlays (handleOverlayDraw()) are not thread safe, this always runs in loop task
+void WS2812FX::drawOverlays() {
   // avoid race condition, capture _callback value
   show_callback callback = _callback;
   if (callback) callback(); // will call setPixelColor or setRealtimePixelColor
+}
+
+void WS2812FX::outputFrame(const uint32_t *pixels, const uint8_t *pixelCCT) {
+  unsigned long showNow = millis();
+  size_t diff = showNow - _lastShow;
+  size_t totalLen = getLengthTotal();
 
   // paint actual pixels
   int oldCCT = Bus::getCCT(); // store original CCT value (since it is global)
   // when cctFromRgb is true we implicitly calculate WW and CW from RGB values (cct==-1)
   if (cctFromRgb) BusManager::setSegmentCCT(-1);
-  for (size_t i = 0; i < totalLen; i++) {
-    // when correctWB is true setSegmentCCT() will convert CCT into K with which we can then
-    // correct/adjust RGB value according to desired CCT value, it will still affect actual WW/CW ratio
-    if (_pixelCCT) { // cctFromRgb already exluded at allocation
-      if (i == 0 || _pixelCCT[i-1] != _pixelCCT[i]) BusManager::setSegmentCCT(_pixelCCT[i], correctWB);
+  const bool applyGamma = !(realtimeMode && arlsDisableGammaCorrection); // note: applying gamma after brightness has too much color loss
+  const bool useLedmap  = customMappingSize && (realtimeMode == REALTIME_MODE_INACTIVE || realtimeRespectLedMaps);
+  // with a ledmap the output is scattered into physical order first so buses still receive contiguous spans
+  if (useLedmap && !pixelCCT && _pixelsMappedLen != totalLen) {
+    p_free(_pixelsMapped);
+    _pixelsMapped = static_cast<uint32_t*>(allocate_buffer((totalLen + (totalLen + 31) / 32) * sizeof(uint32_t), BFRALLOC_PREFER_PSRAM | BFRALLOC_NOBYTEACCESS));
+    _pixelsMappedLen = _pixelsMapped ? totalLen : 0;
+  }
+  if (useLedmap && !pixelCCT && _pixelsMapped) {
+    uint32_t *mapped  = _pixelsMapped;
+    uint32_t *written = _pixelsMapped + totalLen; // physical pixels no logical pixel maps to are left alone
+    for (size_t w = 0; w < (totalLen + 31) / 32; w++) written[w] = 0;
+    for (size_t i = 0; i < totalLen; i++) {
+      unsigned idx = getMappedPixelIndex(i);
+      if (idx >= totalLen) continue; // gap
+      uint32_t c = pixels[i];
+      mapped[idx] = (c > 0 && applyGamma) ? gamma32(c) : c;
+      written[idx / 32] |= 1UL << (idx % 32);
+    }
+    for (size_t i = 0; i < totalLen; ) {
+      if (!(written[i / 32] & (1UL << (i % 32)))) { i++; continue; }
+      size_t n = 1;
+      while (i + n < totalLen && (written[(i + n) / 32] & (1UL << ((i + n) % 32)))) n++;
+      BusManager::setPixels(i, n, mapped + i);
+      i += n;
+    }
+  } else if (useLedmap) {
+    // per-pixel CCT combined with a ledmap (or out of memory): pixel by pixel
+    for (size_t i = 0; i < totalLen; i++) {
+      if (pixelCCT && (i == 0 || pixelCCT[i-1] != pixelCCT[i])) BusManager::setSegmentCCT(pixelCCT[i], correctWB);
+      uint32_t c = pixels[i]; // need a copy, do not modify _pixels directly (no byte access allowed on ESP32)
+      if (c > 0 && applyGamma) c = gamma32(c);
+      BusManager::setPixelColor(getMappedPixelIndex(i), c);
+    }
+  } else {
+    // logical == physical order: gamma correct into a small chunk and hand it to the buses as one span,
+    // chunks are split where the per-pixel CCT changes as CCT is a global bus setting
+    constexpr size_t CHUNK = 64;
+    uint32_t chunk[CHUNK];
+    for (size_t i = 0; i < totalLen; ) {
+      // when correctWB is true setSegmentCCT() will convert CCT into K with which we can then
+      // correct/adjust RGB value according to desired CCT value, it will still affect actual WW/CW ratio
+      if (pixelCCT) BusManager::setSegmentCCT(pixelCCT[i], correctWB); // cctFromRgb already exluded at allocation
+      size_t n = min(CHUNK, totalLen - i);
+      if (pixelCCT) for (size_t k = 1; k < n; k++) if (pixelCCT[i+k] != pixelCCT[i]) { n = k; break; }
+      for (size_t k = 0; k < n; k++) {
+        uint32_t c = pixels[i+k]; // need a copy, do not modify _pixels directly (no byte access allowed on ESP32)
+        chunk[k] = (c > 0 && applyGamma) ? gamma32(c) : c;
+      }
+      BusManager::setPixels(i, n, chunk);
+      i += n;
     }
-
-    uint32_t c = _pixels[i]; // need a copy, do not modify _pixels directly (no byte access allowed on ESP32)
-    if(c > 0 && !(realtimeMode && arlsDisableGammaCorrection))
-        c = gamma32(c); // apply gamma correction if enabled note: applying gamma after brightness has too much color loss
-    BusManager::setPixelColor(getMappedPixelIndex(i), c);
   }
   Bus::setCCT(oldCCT);  // restore old CCT for ABL adjustments
 
-  p_free(_pixelCCT);
-  _pixelCCT = nullptr;
-
   // some buses send asynchronously and this method will return before
   // all of the data has been sent.
   // See https://github.com/Makuna/NeoPixelBus/wiki/ESP32-NeoMethods#neoesp32rmt-methods
@@ -1661,7 +2278,7 @@ void WS2812FX::show() {
 void WS2812FX::setRealtimePixelColor(unsigned i, uint32_t c) {
   if (useMainSegmentOnly) {
     const Segment &seg = getMainSegment();
-    if (seg.isActive() && i < seg.length()) seg.setPixelColorRaw(i, c);
+    if (seg.isActive() && i < seg.length()) { seg.setPixelColorRaw(i, c); seg.markDirty(); }
   } else {
     setPixelColor(i, c);
   }
@@ -1823,6 +2440,7 @@ Segment& WS2812FX::getSegment(unsigned id) {
 void WS2812FX::resetSegments() {
   if (isServicing()) return;
   _segments.clear();          // destructs all Segment as part of clearing
+  Segment::trimTransitionPool(); // segment sizes may have changed, release snapshot buffers
   _segments.emplace_back(0, isMatrix ? Segment::maxWidth : _length, 0, isMatrix ? Segment::maxHeight : 1);
   _segments.shrink_to_fit();  // just in case ...
   _mainSegment = 0;
@@ -1965,23 +2583,115 @@ void WS2812FX::printSize() {
 // load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
 // if this is a matrix set-up and default ledmap.json file does not exist, create mapping table using setUpMatrix() from panel information
 // WARNING: effect drawing has to be suspended (strip.suspend()) or must be called from loop() context
+/*
+ * Binary ledmap (/ledmap.bin, /ledmapN.bin): LedmapHeader followed by count little endian uint16_t entries (0xFFFF = no LED).
+ * Created automatically from ledmapN.json on its first load so later loads (boot, ledmap switching from presets)
+ * are a few block reads instead of parsing the JSON number by number. It may also be uploaded directly (jsonSize = 0).
+ */
+#define LEDMAP_BIN_MAGIC   "WLM"
+#define LEDMAP_BIN_VERSION 1
+#define LEDMAP_BIN_CHUNK   512 // entries per read/write
+
+struct LedmapHeader {
+  char     magic[3];   // "WLM"
+  uint8_t  version;
+  uint16_t width;      // 0 if the ledmap does not define matrix dimensions
+  uint16_t height;
+  uint32_t count;      // number of entries following the header
+  uint32_t jsonSize;   // size of the ledmapN.json this was converted from, used to detect an edited JSON (0 = none)
+};
+
+// loads a binary ledmap into customMappingTable, returns false if it is invalid or outdated (JSON needs to be converted again)
+bool WS2812FX::deserializeBinaryMap(const char *binName, size_t jsonSize, unsigned n) {
+  File f = WLED_FS.open(binName, "r");
+  if (!f) return false;
+  LedmapHeader hdr;
+  if (f.read(reinterpret_cast<uint8_t*>(&hdr), sizeof(hdr)) != sizeof(hdr) || memcmp(hdr.magic, LEDMAP_BIN_MAGIC, sizeof(hdr.magic)) != 0
+      || hdr.version != LEDMAP_BIN_VERSION || f.size() < sizeof(hdr) + hdr.count * sizeof(uint16_t)
+      || (jsonSize && hdr.jsonSize != jsonSize)) {
+    f.close();
+    DEBUG_PRINTF_P(PSTR("Ignoring invalid or outdated %s\n"), binName);
+    return false;
+  }
+  DEBUG_PRINTF_P(PSTR("Reading LED map from %s\n"), binName);
+
+  // if we are loading default ledmap (at boot) set matrix width and height from the ledmap (same as for JSON)
+  if (n == 0 && hdr.width && hdr.height) {
+    Segment::maxWidth  = min((int)hdr.width, 255);
+    Segment::maxHeight = min((int)hdr.height, 255);
+    isMatrix = true;
+    DEBUG_PRINTF_P(PSTR("LED map width=%d, height=%d\n"), Segment::maxWidth, Segment::maxHeight);
+  }
+
+  d_free(customMappingTable);
+  customMappingTable = static_cast<uint16_t*>(d_malloc(sizeof(uint16_t)*getLengthTotal())); // prefer DRAM for speed
+  if (customMappingTable) {
+    const size_t count = min((size_t)hdr.count, (size_t)getLengthTotal());
+    size_t loaded = 0;
+    while (loaded < count) { // read in chunks, LittleFS reads large blocks directly without its cache
+      const size_t chunk = min(count - loaded, (size_t)LEDMAP_BIN_CHUNK);
+      if (f.read(reinterpret_cast<uint8_t*>(customMappingTable + loaded), chunk * sizeof(uint16_t)) != chunk * sizeof(uint16_t)) break;
+      loaded += chunk;
+    }
+    customMappingSize = loaded;
+    currentLedmap = n;
+  } else {
+    DEBUG_PRINTLN(F("ERROR LED map allocation error."));
+  }
+  f.close();
+  return true;
+}
+
+// one-time conversion of a parsed JSON ledmap into its binary form
+static void writeBinaryMap(const char *binName, size_t jsonSize, unsigned width, unsigned height, const uint16_t *map, size_t count) {
+  LedmapHeader hdr;
+  memcpy(hdr.magic, LEDMAP_BIN_MAGIC, sizeof(hdr.magic));
+  hdr.version  = LEDMAP_BIN_VERSION;
+  hdr.width    = width;
+  hdr.height   = height;
+  hdr.count    = count;
+  hdr.jsonSize = jsonSize;
+  File f = WLED_FS.open(binName, "w");
+  if (!f) return;
+  bool ok = f.write(reinterpret_cast<const uint8_t*>(&hdr), sizeof(hdr)) == sizeof(hdr);
+  for (size_t i = 0; ok && i < count; i += LEDMAP_BIN_CHUNK) {
+    const size_t chunk = min(count - i, (size_t)LEDMAP_BIN_CHUNK);
+    ok = f.write(reinterpret_cast<const uint8_t*>(map + i), chunk * sizeof(uint16_t)) == chunk * sizeof(uint16_t);
+  }
+  f.close();
+  if (!ok) WLED_FS.remove(binName); // FS full, keep using JSON
+  DEBUG_PRINTF_P(PSTR("%s %s\n"), ok ? "Created" : "Failed to create", binName);
+}
+
 bool WS2812FX::deserializeMap(unsigned n) {
   char fileName[32];
   strcpy_P(fileName, PSTR("/ledmap"));
   if (n) sprintf(fileName +7, "%d", n);
+  char binName[32];
+  strcpy(binName, fileName);
+  strcat_P(binName, PSTR(".bin"));
   strcat_P(fileName, PSTR(".json"));
   bool isFile = WLED_FS.exists(fileName);
+  bool isBin  = WLED_FS.exists(binName);
 
   customMappingSize = 0; // prevent use of mapping if anything goes wrong
   currentLedmap = 0;
-  if (n == 0 || isFile) interfaceUpdateCallMode = CALL_MODE_WS_SEND; // schedule WS update (to inform UI)
+  if (n == 0 || isFile || isBin) interfaceUpdateCallMode = CALL_MODE_WS_SEND; // schedule WS update (to inform UI)
 
-  if (!isFile && n==0 && isMatrix) {
+  if (!isFile && !isBin && n==0 && isMatrix) {
     // 2D panel support creates its own ledmap (on the fly) if a ledmap.json does not exist
     setUpMatrix();
     return false;
   }
 
+  size_t jsonSize = 0;
+  if (isFile) {
+    File f = WLED_FS.open(fileName, "r");
+    jsonSize = f.size();
+    f.close();
+  }
+  if (isBin && deserializeBinaryMap(binName, jsonSize, n)) return (customMappingSize > 0);
+
   if (!isFile || !requestJSONBufferLock(7)) return false;
 
   StaticJsonDocument<64> filter;
@@ -1995,8 +2705,13 @@ bool WS2812FX::deserializeMap(unsigned n) {
     DEBUG_PRINTF_P(PSTR("Reading LED map from %s\n"), fileName);
 
   JsonObject root = pDoc->as<JsonObject>();
+  unsigned mapWidth = 0, mapHeight = 0; // stored in binary ledmap
+  if (!root[F("width")].isNull() || !root[F("height")].isNull()) {
+    mapWidth  = min(max(root[F("width")].as<int>(), 1), 255);
+    mapHeight = min(max(root[F("height")].as<int>(), 1), 255);
+  }
   // if we are loading default ledmap (at boot) set matrix width and height from the ledmap (compatible with WLED MM ledmaps)
-  if (n == 0 && (!root[F("width")].isNull() || !root[F("height")].isNull())) {
+  if (n == 0 && mapWidth) {
     Segment::maxWidth  = min(max(root[F("width")].as<int>(), 1), 255);
     Segment::maxHeight = min(max(root[F("height")].as<int>(), 1), 255);
     isMatrix = true;
@@ -2008,6 +2723,7 @@ bool WS2812FX::deserializeMap(unsigned n) {
 
   if (customMappingTable) {
     DEBUG_PRINTF_P(PSTR("ledmap allocated: %uB\n"), sizeof(uint16_t)*getLengthTotal());
+    bool complete = true;
     File f = WLED_FS.open(fileName, "r");
     f.find("\"map\":[");
     while (f.available()) { // f.position() < f.size() - 1
@@ -2026,11 +2742,15 @@ bool WS2812FX::deserializeMap(unsigned n) {
         int index = atoi(number);
         if (index < 0 || index > 65535) index = 0xFFFF; // prevent integer wrap around
         customMappingTable[customMappingSize++] = index;
-        if (customMappingSize >= getLengthTotal()) break;
+        if (customMappingSize >= getLengthTotal()) {
+          complete = (end != nullptr); // more entries than LEDs: binary copy would be truncated
+          break;
+        }
       } else break; // there was nothing to read, stop
     }
     currentLedmap = n;
     f.close();
+    if (complete && customMappingSize) writeBinaryMap(binName, jsonSize, mapWidth, mapHeight, customMappingTable, customMappingSize);
 
     #ifdef WLED_DEBUG
     DEBUG_PRINT(F("Loaded ledmap:"));
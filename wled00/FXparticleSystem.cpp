@@ -16,7 +16,6 @@
 #include "FXparticleSystem.h"
 // local shared functions (used both in 1D and 2D system)
 static int32_t calcForce_dv(const int8_t force, uint8_t &counter);
-static bool checkBoundsAndWrap(int32_t &position, const int32_t max, const int32_t particleradius, const bool wrap); // returns false if out of bounds by more than particleradius
 static uint32_t fast_color_scaleAdd(const uint32_t c1, const uint32_t c2, uint8_t scale = 255); // fast and accurate color adding with scaling (scales c2 before adding)
 #endif
 
@@ -25,6 +24,9 @@ ParticleSystem2D::ParticleSystem2D(uint32_t width, uint32_t height, uint32_t num
   PSPRINTLN("\n ParticleSystem2D constructor");
   numSources = numberofsources; // number of sources allocated in init
   numParticles = numberofparticles; // number of particles allocated in init
+  numCollisionCells = calculateNumberOfCollisionCells2D(numParticles);
+  numTiles = calculateNumberOfTiles2D(width, height);
+  tileShift = tilesX = tilesY = 0; // tile layout is set up in first render() call
   usedParticles = numParticles; // use all particles by default
   advPartProps = nullptr; //make sure we start out with null pointers (just in case memory was not cleared)
   advPartSize = nullptr;
@@ -37,7 +39,6 @@ ParticleSystem2D::ParticleSystem2D(uint32_t width, uint32_t height, uint32_t num
   motionBlur = 0; //no fading by default
   smearBlur = 0; //no smearing by default
   emitIndex = 0;
-  collisionStartIdx = 0;
 
   //initialize some default non-zero values most FX use
   for (uint32_t i = 0; i < numParticles; i++) {
@@ -70,10 +71,7 @@ void ParticleSystem2D::update(void) {
   if (particlesettings.useCollisions)
     handleCollisions();
 
-  //move all particles
-  for (uint32_t i = 0; i < usedParticles; i++) {
-    particleMoveUpdate(particles[i], particleFlags[i], nullptr, advPartProps ? &advPartProps[i] : nullptr); // note: splitting this into two loops is slower and uses more flash
-  }
+  moveParticles(); // move all particles
 
   render();
 }
@@ -231,57 +229,27 @@ int32_t ParticleSystem2D::angleEmit(PSsource &emitter, const uint16_t angle, con
 void ParticleSystem2D::particleMoveUpdate(PSparticle &part, PSparticleFlags &partFlags, PSsettings2D *options, PSadvancedParticle *advancedproperties) {
   if (options == nullptr)
     options = &particlesettings; //use PS system settings by default
+  moveParticle(part, partFlags, *options, options->bounceX, options->bounceY, perParticleSize ? advancedproperties : nullptr);
+}
 
-  if (part.ttl > 0) {
-    if (!partFlags.perpetual)
-      part.ttl--; // age
-    if (options->colorByAge)
-      part.hue = min(part.ttl, (uint16_t)255); //set color to ttl
-
-    int32_t renderradius = PS_P_HALFRADIUS - 1 + particlesize; // used to check out of bounds, if its more than half a radius out of bounds, it will render to x = -2/-1 or x=max/max+1 in standard 2x2 rendering
-    int32_t newX = part.x + (int32_t)part.vx;
-    int32_t newY = part.y + (int32_t)part.vy;
-    partFlags.outofbounds = false; // reset out of bounds (in case particle was created outside the matrix and is now moving into view) note: moving this to checks below adds code and is not faster
-
-    if (perParticleSize && advancedproperties != nullptr) { // using individual particle size
-      renderradius = PS_P_HALFRADIUS - 1 + advancedproperties->size; // note: single pixel particles should be zero but OOB checks in rendering function handle this
-      if (advancedproperties->size > 0)
-        particleHardRadius = PS_P_MINHARDRADIUS + ((advancedproperties->size * 52) >> 6); // use 1 pixel + 80% of size for hard radius (slight overlap with boarders so they do not "float")
-      else // single pixel particles use half the collision distance for walls
-        particleHardRadius = PS_P_MINHARDRADIUS >> 1;
-    }
-    // note: if wall collisions are enabled, bounce them before they reach the edge, it looks much nicer if the particle does not go half out of view
-    if (options->bounceY) {
-      if ((newY < (int32_t)particleHardRadius) || ((newY > (int32_t)(maxY - particleHardRadius)) && !options->useGravity)) { // reached floor / ceiling
-         bounce(part.vy, part.vx, newY, maxY);
-      }
-    }
-
-    if (!checkBoundsAndWrap(newY, maxY, renderradius, options->wrapY)) { // check out of bounds  note: this must not be skipped. if gravity is enabled, particles will never bounce at the top
-      partFlags.outofbounds = true;
-      if (options->killoutofbounds) {
-        if (newY < 0) // if gravity is enabled, only kill particles below ground
-          part.ttl = 0;
-        else if (!options->useGravity)
-          part.ttl = 0;
-      }
-    }
-
-    if (part.ttl) { //check x direction only if still alive
-      if (options->bounceX) {
-        if ((newX < (int32_t)particleHardRadius) || (newX > (int32_t)(maxX - particleHardRadius))) // reached a wall
-          bounce(part.vx, part.vy, newX, maxX);
-      }
-      else if (!checkBoundsAndWrap(newX, maxX, renderradius, options->wrapX)) { // check out of bounds
-        partFlags.outofbounds = true;
-        if (options->killoutofbounds)
-          part.ttl = 0;
-      }
-    }
+// move pass of update(): same as calling particleMoveUpdate() on every particle using the system settings
+// the settings that change the control flow are template parameters so the loop does not check them for every particle
+template<bool doBounceX, bool doBounceY, bool sized>
+void ParticleSystem2D::moveParticles() {
+  const PSsettings2D options = particlesettings; // local copy can be kept in a register
+  for (uint32_t i = 0; i < usedParticles; i++)
+    moveParticle(particles[i], particleFlags[i], options, doBounceX, doBounceY, sized ? &advPartProps[i] : nullptr);
+}
 
-    part.x = (int16_t)newX; // set new position
-    part.y = (int16_t)newY; // set new position
-  }
+void ParticleSystem2D::moveParticles() {
+  static constexpr void (ParticleSystem2D::*movePass[8])() = {
+    &ParticleSystem2D::moveParticles<false, false, false>, &ParticleSystem2D::moveParticles<true, false, false>,
+    &ParticleSystem2D::moveParticles<false, true, false>,  &ParticleSystem2D::moveParticles<true, true, false>,
+    &ParticleSystem2D::moveParticles<false, false, true>,  &ParticleSystem2D::moveParticles<true, false, true>,
+    &ParticleSystem2D::moveParticles<false, true, true>,   &ParticleSystem2D::moveParticles<true, true, true>
+  };
+  const bool sized = perParticleSize && advPartProps != nullptr;
+  (this->*movePass[particlesettings.bounceX | (particlesettings.bounceY << 1) | (sized << 2)])();
 }
 
 // move function for fire particles
@@ -574,18 +542,7 @@ void ParticleSystem2D::render() {
     blend = LINEARBLEND_NOWRAP;
   }
 
-  if (motionBlur) { // motion-blurring active
-    for (int32_t y = 0; y <= maxYpixel; y++) {
-      int index = y * (maxXpixel + 1);
-      for (int32_t x = 0; x <= maxXpixel; x++) {
-        framebuffer[index] = fast_color_scale(framebuffer[index], motionBlur); // note: could skip if only globalsmear is active but usually they are both active and scaling is fast enough
-        index++;
-      }
-    }
-  }
-  else { // no blurring: clear buffer
-    memset(framebuffer, 0, (maxXpixel+1) * (maxYpixel+1) * sizeof(CRGBW));
-  }
+  prepareFrame(); // fade (motion blur) or clear the buffer
 
   // go over particles and render them to the buffer
   for (uint32_t i = 0; i < usedParticles; i++) {
@@ -614,6 +571,70 @@ void ParticleSystem2D::render() {
   // apply 2D blur to rendered frame
   if (smearBlur) {
     SEGMENT.blur2D(smearBlur, smearBlur, true);
+    // blurring spreads light by one pixel: mark the neighbours of rendered tiles (as 2 so marking does not propagate, prepareFrame() resets it)
+    for (uint32_t ty = 0; ty < tilesY; ty++) {
+      for (uint32_t tx = 0; tx < tilesX; tx++) {
+        if (dirtyTiles[tx + ty * tilesX] != 1) continue;
+        for (uint32_t ny = ty > 0 ? ty - 1 : 0; ny <= min(ty + 1, tilesY - 1); ny++) {
+          for (uint32_t nx = tx > 0 ? tx - 1 : 0; nx <= min(tx + 1, tilesX - 1); nx++) {
+            if (dirtyTiles[nx + ny * tilesX] == 0) dirtyTiles[nx + ny * tilesX] = 2;
+          }
+        }
+      }
+    }
+  }
+}
+
+// clear or fade the frame buffer before rendering: only tiles that were rendered to can contain lit pixels, all other tiles are black already
+// sparse FX on large matrices (fireworks, impact...) spend most of the frame time on black pixels otherwise
+void ParticleSystem2D::prepareFrame() {
+  const uint32_t cols = maxXpixel + 1;
+  const uint32_t rows = maxYpixel + 1;
+  uint32_t shift = PS_TILE_SHIFT;
+  uint32_t numX, numY;
+  while (true) {
+    numX = ((cols - 1) >> shift) + 1;
+    numY = ((rows - 1) >> shift) + 1;
+    if (numX * numY <= numTiles) break;
+    shift++; // segment is larger than when the PS was allocated, use larger tiles
+  }
+  if (shift != tileShift || numX != tilesX || numY != tilesY) { // first frame or segment size changed: buffer content is unknown
+    tileShift = shift;
+    tilesX = numX;
+    tilesY = numY;
+    memset(dirtyTiles, 1, tilesX * tilesY);
+  }
+
+  const uint32_t tileSize = 1 << tileShift;
+  for (uint32_t ty = 0; ty < tilesY; ty++) {
+    uint8_t *tileRow = dirtyTiles + ty * tilesX;
+    const uint32_t y0 = ty << tileShift;
+    const uint32_t y1 = min(y0 + tileSize, rows);
+    for (uint32_t tx = 0; tx < tilesX; tx++) {
+      if (!tileRow[tx]) continue;
+      uint32_t runEnd = tx + 1; // process consecutive dirty tiles in one go
+      while (runEnd < tilesX && tileRow[runEnd]) runEnd++;
+      const uint32_t x0 = tx << tileShift;
+      const uint32_t x1 = min(runEnd << tileShift, cols);
+      for (uint32_t y = y0; y < y1; y++) {
+        if (motionBlur) fadeBuffer(framebuffer + y * cols + x0, x1 - x0, motionBlur);
+        else            memset(framebuffer + y * cols + x0, 0, (x1 - x0) * sizeof(uint32_t));
+      }
+      if (motionBlur) { // a tile stays dirty until it has faded to black
+        for (; tx < runEnd; tx++) {
+          const uint32_t xs = tx << tileShift;
+          const uint32_t xe = min(xs + tileSize, cols);
+          uint32_t lit = 0;
+          for (uint32_t y = y0; y < y1 && !lit; y++) {
+            for (uint32_t x = xs; x < xe; x++) lit |= framebuffer[x + y * cols];
+          }
+          tileRow[tx] = lit != 0;
+        }
+      } else {
+        memset(tileRow + tx, 0, runEnd - tx);
+      }
+      tx = runEnd; // tile at runEnd is clean
+    }
   }
 }
 
@@ -630,6 +651,7 @@ void WLED_O2_ATTR ParticleSystem2D::renderParticle(const uint32_t particleindex,
     if (x <= (uint32_t)maxXpixel && y <= (uint32_t)maxYpixel) {
       uint32_t index = x + (maxYpixel - y) * (maxXpixel + 1); // flip y coordinate (0,0 is bottom left in PS but top left in framebuffer)
       framebuffer[index] = fast_color_scaleAdd(framebuffer[index], color, brightness);
+      markTile(x, maxYpixel - y);
     }
     return;
   }
@@ -722,6 +744,7 @@ void WLED_O2_ATTR ParticleSystem2D::renderParticle(const uint32_t particleindex,
     if (pixelvalid[i]) {
       uint32_t idx = pixco[i].x + (maxYpixel - pixco[i].y) * (maxXpixel + 1); // flip y coordinate (0,0 is bottom left in PS but top left in framebuffer)
       framebuffer[idx] = fast_color_scaleAdd(framebuffer[idx], color, pxlbrightness[i]); // order is: bottom left, bottom right, top right, top left
+      markTile(pixco[i].x, maxYpixel - pixco[i].y);
     }
   }
 }
@@ -809,87 +832,131 @@ void WLED_O2_ATTR ParticleSystem2D::renderLargeParticle(const uint32_t size, con
       // Render pixel
       uint32_t idx = render_x + (maxYpixel - render_y) * matrixX; // flip y coordinate (0,0 is bottom left in PS but top left in framebuffer)
       framebuffer[idx] = fast_color_scaleAdd(framebuffer[idx], color, pixel_brightness);
+      markTile(render_x, maxYpixel - render_y);
     }
   }
 }
 
+// collision grid is rebuilt every frame, one buffer (allocated on first collision, grown to the largest system) is shared by all 2D particle systems
+// it is freed by handleCollisionGrid2D() once the particle effects are gone (or do not use collisions any more)
+static uint16_t *collisionGrid = nullptr;
+static uint32_t  collisionGridSize = 0; // in bytes
+static unsigned long collisionGridUsed = 0; // millis() of the last collision handling
+
+void handleCollisionGrid2D() {
+  if (collisionGrid && millis() - collisionGridUsed > PS_COLLISION_GRID_TIMEOUT) {
+    PSPRINTLN(F("PS releasing collision grid"));
+    d_free(collisionGrid);
+    collisionGrid = nullptr;
+    collisionGridSize = 0;
+  }
+}
+
 // detect collisions in an array of particles and handle them
-// uses binning by dividing the frame into slices in x direction which is efficient if using gravity in y direction (but less efficient for FX that use forces in x direction)
-// for code simplicity, no y slicing is done, making very tall matrix configurations less efficient
-// note: also tested adding y slicing, it gives diminishing returns, some FX even get slower. FX not using gravity would benefit with a 10% FPS improvement
+// uses a uniform grid (spatial hash): cost grows linearly with the number of particles, also if they pile up
 void ParticleSystem2D::handleCollisions() {
+  const uint32_t gridSize = calculateCollisionGridSize2D(numParticles);
+  collisionGridUsed = millis();
+  if (collisionGridSize < gridSize) {
+    d_free(collisionGrid);
+    collisionGrid = static_cast<uint16_t *>(d_malloc(gridSize)); // DRAM for speed
+    collisionGridSize = collisionGrid ? gridSize : 0;
+    if (!collisionGrid) return; // not enough RAM, no collisions this frame
+  }
+  uint16_t *collisionCells = collisionGrid; // index of the first particle of each cell in collisionIndices (one extra entry for end of last cell)
+  uint16_t *collisionIndices = collisionCells + numCollisionCells + 1; // indices of colliding particles sorted by cell
+
   uint32_t collDistSq = particleHardRadius << 1; // distance is double the radius note: particleHardRadius is updated when setting global particle size
-  collDistSq = collDistSq * collDistSq; // square it for faster comparison (square is one operation)
-  // note: partices are binned in x-axis, assumption is that no more than half of the particles are in the same bin
-  // if they are, collisionStartIdx is increased so each particle collides at least every second frame (which still gives decent collisions)
-  int binWidth = 6 * PS_P_RADIUS; // width of a bin in sub-pixels
-  int32_t overlap = particleHardRadius << 1; // overlap bins to include edge particles to neighbouring bins
+  uint32_t maxCollDist = collDistSq; // largest collision distance of any two particles, grid cells must be at least this size
   if (perParticleSize && advPartProps != nullptr)
-    overlap = 512; // max overlap for collision detection if using per-particle size, enough to catch all particles even at max speed
+    maxCollDist = (PS_P_MINHARDRADIUS << 1) + (((255 + 255) * 52) >> 6); // two particles of maximum size
+  collDistSq = collDistSq * collDistSq; // square it for faster comparison (square is one operation)
 
-  uint32_t maxBinParticles = max((uint32_t)50, (usedParticles + 1) / 2); // assume no more than half of the particles are in the same bin, do not bin small amounts of particles
-  uint32_t numBins = (maxX + (binWidth - 1)) / binWidth; // number of bins in x direction
-  if (usedParticles < maxBinParticles) {
-    numBins = 1; // use single bin for small number of particles
-    binWidth = maxX + 1;
+  // particles are sorted into a grid of square cells by their position after the next move (which is what is checked for collisions)
+  // so colliding particles are in the same or in adjacent cells and each particle is only checked against its neighbours
+  uint32_t cellSize = maxCollDist; // in sub-pixels
+  uint32_t cellsX, cellsY;
+  while (true) {
+    cellsX = maxX / cellSize + 1;
+    cellsY = maxY / cellSize + 1;
+    if (cellsX * cellsY <= numCollisionCells) break;
+    cellSize += cellSize >> 2; // grid does not fit into the cell array, use larger cells (more particles per cell)
+  }
+  const uint32_t numCells = cellsX * cellsY;
+  const auto cellOf = [&](uint32_t i) -> int32_t { // grid cell of a particle, -1 if particle does not collide
+    if (particles[i].ttl == 0 || particleFlags[i].outofbounds || !particleFlags[i].collide) return -1;
+    // lookahead position can be negative: clamp to 0 (first cell) as division truncates towards zero, clamping never separates neighbours
+    int32_t cx = max((int32_t)0, (int32_t)(particles[i].x + particles[i].vx)) / (int32_t)cellSize;
+    int32_t cy = max((int32_t)0, (int32_t)(particles[i].y + particles[i].vy)) / (int32_t)cellSize;
+    cx = min(cx, (int32_t)cellsX - 1);
+    cy = min(cy, (int32_t)cellsY - 1);
+    return cx + cy * cellsX;
+  };
+
+  // counting sort of particle indices by cell: count per cell, turn counts into cell ends, fill backwards (turns ends into starts)
+  memset(collisionCells, 0, (numCells + 1) * sizeof(uint16_t));
+  for (uint32_t i = 0; i < usedParticles; i++) {
+    int32_t cell = cellOf(i);
+    if (cell >= 0) collisionCells[cell]++;
+  }
+  uint32_t sum = 0;
+  for (uint32_t cell = 0; cell < numCells; cell++) {
+    sum += collisionCells[cell];
+    collisionCells[cell] = sum;
+  }
+  collisionCells[numCells] = sum;
+  for (int32_t i = usedParticles - 1; i >= 0; i--) {
+    int32_t cell = cellOf(i);
+    if (cell >= 0) collisionIndices[--collisionCells[cell]] = i;
   }
-  uint16_t binIndices[maxBinParticles]; // creat array on stack for indices, 2kB max for 1024 particles (ESP32_MAXPARTICLES/2)
-  uint32_t binParticleCount; // number of particles in the current bin
-  uint32_t nextFrameStartIdx = hw_random16(usedParticles); // index of the first particle in the next frame (set to fixed value if bin overflow)
-  uint32_t pidx = collisionStartIdx; //start index in case a bin is full, process remaining particles next frame
-
-  // fill the binIndices array for this bin
-  for (uint32_t bin = 0; bin < numBins; bin++) {
-    binParticleCount = 0; // reset for this bin
-    int32_t binStart = bin * binWidth - overlap; // note: first bin will extend to negative, but that is ok as out of bounds particles are ignored
-    int32_t binEnd = binStart + binWidth + (overlap << 1); // add twice the overlap as start is start-overlap, note: last bin can be out of bounds, see above;
 
-    // fill the binIndices array for this bin
-    for (uint32_t i = 0; i < usedParticles; i++) {
-      if (particles[pidx].ttl > 0) { // is alive
-        if (particles[pidx].x >= binStart && particles[pidx].x <= binEnd) { // >= and <= to include particles on the edge of the bin (overlap to ensure boarder particles collide with adjacent bins)
-          if (particleFlags[pidx].outofbounds == 0 && particleFlags[pidx].collide) { // particle is in frame and does collide note: checking flags is quite slow and usually these are set, so faster to check here
-            if (binParticleCount >= maxBinParticles) { // bin is full, more particles in this bin so do the rest next frame
-              nextFrameStartIdx = pidx; // bin overflow can only happen once as bin size is at least half of the particles (or half +1)
-              break;
-            }
-            binIndices[binParticleCount++] = pidx;
-          }
-        }
-      }
-      pidx++;
-      if (pidx >= usedParticles) pidx = 0; // wrap around
+  int32_t massratio1 = 0; // 0 means dont use mass ratio (equal mass)
+  int32_t massratio2 = 0; // TODO: if implementing "fixed" particles, set to 1 (fixed) and 255 (movable)
+  const auto checkCollision = [&](uint32_t idx_i, uint32_t idx_j) {
+    if (perParticleSize && advPartProps != nullptr) { // using individual particle size
+      collDistSq = (PS_P_MINHARDRADIUS << 1) + ((((uint32_t)advPartProps[idx_i].size + (uint32_t)advPartProps[idx_j].size) * 52) >> 6); // collision distance, use 80% of size for tighter stacking (slight overlap)
+      collDistSq = collDistSq * collDistSq; // square it for faster comparison
+      // calculate mass ratio for collision response
+      uint32_t mass1 = PS_P_RADIUS + advPartProps[idx_i].size;
+      uint32_t mass2 = PS_P_RADIUS + advPartProps[idx_j].size;
+      mass1 = mass1 * mass1; // mass proportional to area
+      mass2 = mass2 * mass2;
+      uint32_t totalmass = mass1 + mass2;
+      massratio1 = (mass2 << 8) / totalmass; // massratio 1 depends on mass of particle 2, i.e. if 2 is heavier -> higher velocity impact on 1
+      massratio2 = (mass1 << 8) / totalmass;
     }
-
-    int32_t massratio1 = 0; // 0 means dont use mass ratio (equal mass)
-    int32_t massratio2 = 0; // TODO: if implementing "fixed" particles, set to 1 (fixed) and 255 (movable)
-    for (uint32_t i = 0; i < binParticleCount; i++) { // go though all 'higher number' particles in this bin and see if any of those are in close proximity and if they are, make them collide
-      uint32_t idx_i = binIndices[i];
-      for (uint32_t j = i + 1; j < binParticleCount; j++) { // check against higher number particles
-        uint32_t idx_j = binIndices[j];
-        if (perParticleSize && advPartProps != nullptr) { // using individual particle size
-          collDistSq = (PS_P_MINHARDRADIUS << 1) + ((((uint32_t)advPartProps[idx_i].size + (uint32_t)advPartProps[idx_j].size) * 52) >> 6); // collision distance, use 80% of size for tighter stacking (slight overlap)
-          collDistSq = collDistSq * collDistSq; // square it for faster comparison
-          // calculate mass ratio for collision response
-          uint32_t mass1 = PS_P_RADIUS + advPartProps[idx_i].size;
-          uint32_t mass2 = PS_P_RADIUS + advPartProps[idx_j].size;
-          mass1 = mass1 * mass1; // mass proportional to area
-          mass2 = mass2 * mass2;
-          uint32_t totalmass = mass1 + mass2;
-          massratio1 = (mass2 << 8) / totalmass; // massratio 1 depends on mass of particle 2, i.e. if 2 is heavier -> higher velocity impact on 1
-          massratio2 = (mass1 << 8) / totalmass;
+    // note: using the same logic as in 1D is much slower though it would be more accurate but it is not really needed in 2D: particles slipping through each other is much less visible
+    int32_t dx = (particles[idx_j].x + particles[idx_j].vx) - (particles[idx_i].x + particles[idx_i].vx); // distance with lookahead
+    if (dx * dx < collDistSq) { // check x direction, if close, check y direction (squaring is faster than abs() or dual compare)
+      int32_t dy = (particles[idx_j].y + particles[idx_j].vy)  - (particles[idx_i].y + particles[idx_i].vy); // distance with lookahead
+      if (dy * dy < collDistSq) // particles are close
+        collideParticles(particles[idx_i], particles[idx_j], dx, dy, collDistSq, massratio1, massratio2);
+    }
+  };
+
+  // check every particle against the following particles of its cell and all particles of the 'forward' neighbour cells
+  // (right, bottom left, bottom, bottom right) so every pair of particles in adjacent cells is checked exactly once
+  for (uint32_t cy = 0; cy < cellsY; cy++) {
+    for (uint32_t cx = 0; cx < cellsX; cx++) {
+      const uint32_t cell = cx + cy * cellsX;
+      const uint32_t cellEnd = collisionCells[cell + 1];
+      for (uint32_t i = collisionCells[cell]; i < cellEnd; i++) {
+        const uint32_t idx_i = collisionIndices[i];
+        for (uint32_t j = i + 1; j < cellEnd; j++)
+          checkCollision(idx_i, collisionIndices[j]);
+        if (cx + 1 < cellsX) {
+          for (uint32_t j = cellEnd; j < collisionCells[cell + 2]; j++)
+            checkCollision(idx_i, collisionIndices[j]);
         }
-        // note: using the same logic as in 1D is much slower though it would be more accurate but it is not really needed in 2D: particles slipping through each other is much less visible
-        int32_t dx = (particles[idx_j].x + particles[idx_j].vx) - (particles[idx_i].x + particles[idx_i].vx); // distance with lookahead
-        if (dx * dx < collDistSq) { // check x direction, if close, check y direction (squaring is faster than abs() or dual compare)
-          int32_t dy = (particles[idx_j].y + particles[idx_j].vy)  - (particles[idx_i].y + particles[idx_i].vy); // distance with lookahead
-          if (dy * dy < collDistSq) // particles are close
-            collideParticles(particles[idx_i], particles[idx_j], dx, dy, collDistSq, massratio1, massratio2);
+        if (cy + 1 < cellsY) { // bottom left to bottom right are consecutive cells
+          const uint32_t first = cell + cellsX - (cx > 0 ? 1 : 0);
+          const uint32_t last  = cell + cellsX + (cx + 1 < cellsX ? 1 : 0);
+          for (uint32_t j = collisionCells[first]; j < collisionCells[last + 1]; j++)
+            checkCollision(idx_i, collisionIndices[j]);
         }
       }
     }
   }
-  collisionStartIdx = nextFrameStartIdx; // set the start index for the next frame
 }
 
 // handle a collision if close proximity is detected, i.e. dx and/or dy smaller than 2*PS_P_RADIUS
@@ -1033,8 +1100,9 @@ void ParticleSystem2D::updatePSpointers(bool isadvanced, bool sizecontrol) {
   particles = reinterpret_cast<PSparticle *>(this + 1); // pointer to particles
   particleFlags = reinterpret_cast<PSparticleFlags *>(particles + numParticles); // pointer to particle flags
   sources = reinterpret_cast<PSsource *>(particleFlags + numParticles); // pointer to source(s) at data+sizeof(ParticleSystem2D)
+  dirtyTiles = reinterpret_cast<uint8_t *>(sources + numSources); // tile flags
   framebuffer = SEGMENT.getPixels(); // pointer to framebuffer
-  PSdataEnd = reinterpret_cast<uint8_t *>(sources + numSources); // pointer to first available byte after the PS for FX additional data (already aligned to 4 byte boundary)
+  PSdataEnd = dirtyTiles + numTiles; // pointer to first available byte after the PS for FX additional data (aligned to 4 byte boundary)
   if (isadvanced) {
     advPartProps = reinterpret_cast<PSadvancedParticle *>(PSdataEnd);
     PSdataEnd = reinterpret_cast<uint8_t *>(advPartProps + numParticles);
@@ -1068,6 +1136,22 @@ uint32_t calculateNumberOfParticles2D(uint32_t const pixels, const bool isadvanc
   return numberofParticles;
 }
 
+// cells of the collision grid: one cell per 2 particles (particles are limited to one per pixel, cells are at least 2x2 pixels)
+uint32_t calculateNumberOfCollisionCells2D(uint32_t numparticles) {
+  return (numparticles >> 1) + 1;
+}
+
+// memory for the collision grid: cell starts (one extra for the end of the last cell) and sorted particle indices
+uint32_t calculateCollisionGridSize2D(uint32_t numparticles) {
+  return (((calculateNumberOfCollisionCells2D(numparticles) + 1 + numparticles) * sizeof(uint16_t)) + 3) & ~0x03;
+}
+
+// tile flags of the frame buffer (see prepareFrame()), count is a multiple of 4 to keep the following memory aligned
+uint32_t calculateNumberOfTiles2D(uint32_t cols, uint32_t rows) {
+  constexpr uint32_t tileSize = 1 << PS_TILE_SHIFT;
+  return ((((cols + tileSize - 1) >> PS_TILE_SHIFT) * ((rows + tileSize - 1) >> PS_TILE_SHIFT)) + 3) & ~0x03;
+}
+
 uint32_t calculateNumberOfSources2D(uint32_t pixels, uint32_t requestedsources) {
   int numberofSources = min((pixels) / SOURCEREDUCTIONFACTOR, (uint32_t)requestedsources);
   numberofSources = max(1, min(numberofSources, MAXSOURCES_2D)); // limit
@@ -1089,6 +1173,7 @@ bool allocateParticleSystemMemory2D(uint32_t numparticles, uint32_t numsources,
   if (sizecontrol)
     requiredmemory += sizeof(PSsizeControl) * numparticles;
   requiredmemory += sizeof(PSsource) * numsources;
+  requiredmemory += calculateNumberOfTiles2D(SEGMENT.virtualWidth(), SEGMENT.virtualHeight());
   requiredmemory += additionalbytes;
   return(SEGMENT.allocateData(requiredmemory));
 }
@@ -1177,10 +1262,7 @@ void ParticleSystem1D::update(void) {
       handleCollisions(); // second pass for per particle size (as impulse transfer can recoil at high speed, this improves "slip through" issues for small particles but is expensive)
   }
 
-  //move all particles
-  for (uint32_t i = 0; i < usedParticles; i++) {
-    particleMoveUpdate(particles[i], particleFlags[i], nullptr, advPartProps ? &advPartProps[i] : nullptr);
-  }
+  moveParticles(); // move all particles
 
   if (particlesettings.colorByPosition) {
     uint32_t scale = (255 << 16) / maxX;
@@ -1296,71 +1378,25 @@ int32_t ParticleSystem1D::sprayEmit(const PSsource1D &emitter) {
 void ParticleSystem1D::particleMoveUpdate(PSparticle1D &part, PSparticleFlags1D &partFlags, PSsettings1D *options, PSadvancedParticle1D *advancedproperties) {
   if (options == nullptr)
     options = &particlesettings; // use PS system settings by default
+  moveParticle(part, partFlags, *options, options->bounce, perParticleSize ? advancedproperties : nullptr);
+}
 
-  if (part.ttl > 0) {
-    if (!partFlags.perpetual)
-      part.ttl--; // age
-    if (options->colorByAge)
-      part.hue = min(part.ttl, (uint16_t)255); // set color to ttl
-
-    int32_t renderradius = PS_P_HALFRADIUS_1D - 1 + particlesize; // used to check out of bounds, default for 2 pixel rendering
-    int32_t newX = part.x + (int32_t)part.vx;
-    partFlags.outofbounds = false; // reset out of bounds (in case particle was created outside the matrix and is now moving into view)
-
-    if (perParticleSize && advancedproperties != nullptr) { // using individual particle size?
-      renderradius = PS_P_HALFRADIUS_1D - 1 + advancedproperties->size; // note: for single pixel particles, it should be zero, but it does not matter as out of bounds checking is done in rendering function
-      if (advancedproperties->size > 1)
-        particleHardRadius = PS_P_MINHARDRADIUS_1D + ((advancedproperties->size * 52) >> 6); // use 1 pixel + 80% of size for hard radius (slight overlap with boarders so they do not "float" and nicer stacking)
-      else // single pixel particles use half the collision distance for walls
-        particleHardRadius = PS_P_MINHARDRADIUS_1D >> 1;
-    }
-
-    // if wall collisions are enabled, bounce them before they reach the edge, it looks much nicer if the particle is not half out of view
-    if (options->bounce) {
-      if ((newX < (int32_t)particleHardRadius) || ((newX > (int32_t)(maxX - particleHardRadius)))) { // reached a wall
-        bool bouncethis = true;
-        if (options->useGravity) {
-          if (partFlags.reversegrav) { // skip bouncing at x = 0
-            if (newX < (int32_t)particleHardRadius)
-              bouncethis = false;
-          } else if (newX > (int32_t)particleHardRadius) { // skip bouncing at x = max
-            bouncethis = false;
-          }
-        }
-        if (bouncethis) {
-          part.vx = -part.vx; // invert speed
-          part.vx = ((int32_t)part.vx * (int32_t)wallHardness) / 255; // reduce speed as energy is lost on non-hard surface
-          if (newX < (int32_t)particleHardRadius)
-            newX = particleHardRadius; // fast particles will never reach the edge if position is inverted, this looks better
-          else
-            newX = maxX - particleHardRadius;
-        }
-      }
-    }
-
-    if (!checkBoundsAndWrap(newX, maxX, renderradius, options->wrap)) { // check out of bounds note: this must not be skipped or it can lead to crashes
-      partFlags.outofbounds = true;
-      if (options->killoutofbounds) {
-        bool killthis = true;
-        if (options->useGravity) { // if gravity is used, only kill below 'floor level'
-          if (partFlags.reversegrav) { // skip at x = 0, do not skip far out of bounds
-            if (newX < 0 || newX > maxX << 2)
-              killthis = false;
-          } else { // skip at x = max, do not skip far out of bounds
-            if (newX > 0 &&  newX < maxX << 2)
-              killthis = false;
-          }
-        }
-        if (killthis)
-          part.ttl = 0;
-      }
-    }
+// move pass of update(): same as calling particleMoveUpdate() on every particle using the system settings
+// the settings that change the control flow are template parameters so the loop does not check them for every particle
+template<bool doBounce, bool sized>
+void ParticleSystem1D::moveParticles() {
+  const PSsettings1D options = particlesettings; // local copy can be kept in a register
+  for (uint32_t i = 0; i < usedParticles; i++)
+    moveParticle(particles[i], particleFlags[i], options, doBounce, sized ? &advPartProps[i] : nullptr);
+}
 
-    if (!partFlags.fixed)
-      part.x = newX; // set new position
-    else
-      part.vx = 0; // set speed to zero. note: particle can get speed in collisions, if unfixed, it should not speed away
-  }
+void ParticleSystem1D::moveParticles() {
+  static constexpr void (ParticleSystem1D::*movePass[4])() = {
+    &ParticleSystem1D::moveParticles<false, false>, &ParticleSystem1D::moveParticles<true, false>,
+    &ParticleSystem1D::moveParticles<false, true>,  &ParticleSystem1D::moveParticles<true, true>
+  };
+  const bool sized = perParticleSize && advPartProps != nullptr;
+  (this->*movePass[particlesettings.bounce | (sized << 1)])();
 }
 
 // apply a force in x direction to individual particle (or source)
@@ -1438,9 +1474,7 @@ void ParticleSystem1D::render() {
   }
 
   if (motionBlur) { // blurring active
-    for (int32_t x = 0; x <= maxXpixel; x++) {
-      framebuffer[x] = fast_color_scale(framebuffer[x], motionBlur);
-    }
+    fadeBuffer(framebuffer, maxXpixel + 1, motionBlur);
   }
   else { // no blurring: clear buffer
     memset(framebuffer, 0, (maxXpixel+1) * sizeof(CRGBW));
@@ -1894,20 +1928,6 @@ static int32_t calcForce_dv(const int8_t force, uint8_t &counter) {
   return dv;
 }
 
-// check if particle is out of bounds and wrap it around if required, returns false if out of bounds
-static bool checkBoundsAndWrap(int32_t &position, const int32_t max, const int32_t particleradius, const bool wrap) {
-  if ((uint32_t)position > (uint32_t)max) { // check if particle reached an edge, cast to uint32_t to save negative checking (max is always positive)
-    if (wrap) {
-      position = position % (max + 1); // note: cannot optimize modulo, particles can be far out of bounds when wrap is enabled
-      if (position < 0)
-        position += max + 1;
-    }
-    else if (((position < -particleradius) || (position > max + particleradius))) // particle is leaving boundaries, out of bounds if it has fully left
-      return false; // out of bounds
-  }
-  return true; // particle is in bounds
-}
-
 // this is a fast version for RGB color adding ignoring white channel (PS does not handle white) including scaling of second color
 // note: function is mainly used to add scaled colors, so checking if one color is black is slower
 static uint32_t fast_color_scaleAdd(const uint32_t c1, const uint32_t c2, const uint8_t scale) {
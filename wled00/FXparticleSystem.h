@@ -34,6 +34,20 @@
 static inline int32_t limitSpeed(const int32_t speed) {
   return speed > PS_P_MAXSPEED ? PS_P_MAXSPEED : (speed < -PS_P_MAXSPEED ? -PS_P_MAXSPEED : speed); // note: this is slightly faster than using min/max at the cost of 50bytes of flash
 }
+
+// check if particle is out of bounds and wrap it around if required, returns false if out of bounds (used in 1D and 2D)
+static inline bool checkBoundsAndWrap(int32_t &position, const int32_t max, const int32_t particleradius, const bool wrap) {
+  if ((uint32_t)position > (uint32_t)max) { // check if particle reached an edge, cast to uint32_t to save negative checking (max is always positive)
+    if (wrap) {
+      position = position % (max + 1); // note: cannot optimize modulo, particles can be far out of bounds when wrap is enabled
+      if (position < 0)
+        position += max + 1;
+    }
+    else if (((position < -particleradius) || (position > max + particleradius))) // particle is leaving boundaries, out of bounds if it has fully left
+      return false; // out of bounds
+  }
+  return true; // particle is in bounds
+}
 #endif
 
 #ifndef WLED_DISABLE_PARTICLESYSTEM2D
@@ -51,6 +65,9 @@ static inline int32_t limitSpeed(const int32_t speed) {
   #define MAXSOURCES_2D 128
   #define SOURCEREDUCTIONFACTOR 4
 #endif
+#ifndef PS_COLLISION_GRID_TIMEOUT
+  #define PS_COLLISION_GRID_TIMEOUT 5000 // ms without collision handling after which the shared collision grid is freed
+#endif
 
 // particle dimensions (subpixel division)
 #define PS_P_RADIUS 64 // subpixel size, each pixel is divided by this for particle movement (must be a power of 2)
@@ -59,6 +76,7 @@ static inline int32_t limitSpeed(const int32_t speed) {
 #define PS_P_SURFACE 12 // shift: 2^PS_P_SURFACE = (PS_P_RADIUS)^2
 #define PS_P_MINHARDRADIUS 64 // minimum hard surface radius for collisions
 #define PS_P_MINSURFACEHARDNESS 128 // minimum hardness used in collision impulse calculation, below this hardness, particles become sticky
+#define PS_TILE_SHIFT 3 // frame buffer is cleared and faded in tiles of 8x8 pixels, only tiles that particles were rendered to are processed
 
 // struct for PS settings (shared for 1D and 2D class)
 typedef union {
@@ -198,10 +216,15 @@ private:
   void render();
   [[gnu::hot]] void renderParticle(const uint32_t particleindex, const uint8_t brightness, const CRGBW& color, const bool wrapX, const bool wrapY);
   void renderLargeParticle(const uint32_t size, const uint32_t particleindex, const uint8_t brightness, const CRGBW& color, const bool wrapX, const bool wrapY);
+  void prepareFrame(); // clears or fades the tiles of the frame buffer that were rendered to
+  inline void markTile(const uint32_t x, const uint32_t row) { dirtyTiles[(x >> tileShift) + (row >> tileShift) * tilesX] = 1; } // row is the frame buffer row (y is flipped)
   //paricle physics applied by system if flags are set
   void applyGravity(); // applies gravity to all particles
   void handleCollisions();
   void collideParticles(PSparticle &particle1, PSparticle &particle2, int32_t dx, int32_t dy, const uint32_t collDistSq, int32_t massratio1, int32_t massratio2);
+  void moveParticles(); // moves all particles using the system settings
+  template<bool doBounceX, bool doBounceY, bool sized> void moveParticles();
+  [[gnu::always_inline]] inline void moveParticle(PSparticle &part, PSparticleFlags &partFlags, const PSsettings2D &options, const bool bounceX, const bool bounceY, const PSadvancedParticle *advancedproperties);
   void fireParticleupdate();
   //utility functions
   void updatePSpointers(const bool isadvanced, const bool sizecontrol); // update the data pointers to current segment data space
@@ -210,14 +233,18 @@ private:
   [[gnu::hot]] void bounce(int8_t &incomingspeed, int8_t &parallelspeed, int32_t &position, const uint32_t maxposition); // bounce on a wall
   // note: variables that are accessed often are 32bit for speed
   uint32_t *framebuffer; // frame buffer for rendering. note: using CRGBW as the buffer is slower, ESP compiler seems to optimize this better giving more consistent FPS
+  uint8_t *dirtyTiles; // one flag per frame buffer tile, set if the tile may contain lit pixels
   PSsettings2D particlesettings; // settings used when updating particles (can also used by FX to move sources), do not edit properties directly, use functions above
   uint32_t numParticles;  // total number of particles allocated by this system
+  uint32_t numCollisionCells; // size of collision grid (cells)
+  uint32_t numTiles; // number of tile flags allocated, tiles grow if the segment gets larger
+  uint32_t tileShift; // tile size as power of 2 (in pixels)
+  uint32_t tilesX, tilesY; // current number of tiles
   uint32_t emitIndex; // index to count through particles to emit so searching for dead pixels is faster
   int32_t collisionHardness;
   uint32_t wallHardness;
   uint32_t wallRoughness; // randomizes wall collisions
   uint32_t particleHardRadius; // hard surface radius of a particle, used for collision detection (32bit for speed)
-  uint16_t collisionStartIdx; // particle array start index for collision detection
   uint8_t fireIntesity = 0; // fire intensity, used for fire mode (flash use optimization, better than passing an argument to render function)
   uint8_t forcecounter; // counter for globally applied forces
   uint8_t gforcecounter; // counter for global gravity
@@ -228,11 +255,65 @@ private:
   uint8_t smearBlur; // 2D smeared blurring of full frame
 };
 
+// particle moves, decays and dies, shared by particleMoveUpdate() and the move pass of update()
+// the move pass passes constant bounce flags and size (nullptr if not sized), so they fold away when this is inlined into its loop
+inline void ParticleSystem2D::moveParticle(PSparticle &part, PSparticleFlags &partFlags, const PSsettings2D &options, const bool bounceX, const bool bounceY, const PSadvancedParticle *advancedproperties) {
+  if (part.ttl == 0)
+    return;
+  if (!partFlags.perpetual)
+    part.ttl--; // age
+  if (options.colorByAge)
+    part.hue = min(part.ttl, (uint16_t)255); //set color to ttl
+
+  int32_t renderradius = PS_P_HALFRADIUS - 1 + particlesize; // used to check out of bounds, if its more than half a radius out of bounds, it will render to x = -2/-1 or x=max/max+1 in standard 2x2 rendering
+  int32_t newX = part.x + (int32_t)part.vx;
+  int32_t newY = part.y + (int32_t)part.vy;
+  partFlags.outofbounds = false; // reset out of bounds (in case particle was created outside the matrix and is now moving into view) note: moving this to checks below adds code and is not faster
+
+  if (advancedproperties != nullptr) { // using individual particle size
+    renderradius = PS_P_HALFRADIUS - 1 + advancedproperties->size; // note: single pixel particles should be zero but OOB checks in rendering function handle this
+    if (advancedproperties->size > 0)
+      particleHardRadius = PS_P_MINHARDRADIUS + ((advancedproperties->size * 52) >> 6); // use 1 pixel + 80% of size for hard radius (slight overlap with boarders so they do not "float")
+    else // single pixel particles use half the collision distance for walls
+      particleHardRadius = PS_P_MINHARDRADIUS >> 1;
+  }
+  // note: if wall collisions are enabled, bounce them before they reach the edge, it looks much nicer if the particle does not go half out of view
+  if (bounceY) {
+    if ((newY < (int32_t)particleHardRadius) || ((newY > (int32_t)(maxY - particleHardRadius)) && !options.useGravity)) // reached floor / ceiling
+      bounce(part.vy, part.vx, newY, maxY);
+  }
+
+  if (!checkBoundsAndWrap(newY, maxY, renderradius, options.wrapY)) { // check out of bounds  note: this must not be skipped. if gravity is enabled, particles will never bounce at the top
+    partFlags.outofbounds = true;
+    if (options.killoutofbounds && (newY < 0 || !options.useGravity)) // if gravity is enabled, only kill particles below ground
+      part.ttl = 0;
+  }
+
+  if (part.ttl) { //check x direction only if still alive
+    if (bounceX) {
+      if ((newX < (int32_t)particleHardRadius) || (newX > (int32_t)(maxX - particleHardRadius))) // reached a wall
+        bounce(part.vx, part.vy, newX, maxX);
+    }
+    else if (!checkBoundsAndWrap(newX, maxX, renderradius, options.wrapX)) { // check out of bounds
+      partFlags.outofbounds = true;
+      if (options.killoutofbounds)
+        part.ttl = 0;
+    }
+  }
+
+  part.x = (int16_t)newX; // set new position
+  part.y = (int16_t)newY; // set new position
+}
+
 // initialization functions (not part of class)
 bool initParticleSystem2D(ParticleSystem2D *&PartSys, const uint32_t requestedsources, const uint32_t additionalbytes = 0, const bool advanced = false, const bool sizecontrol = false);
 uint32_t calculateNumberOfParticles2D(const uint32_t pixels, const bool advanced, const bool sizecontrol);
 uint32_t calculateNumberOfSources2D(const uint32_t pixels, const uint32_t requestedsources);
+uint32_t calculateNumberOfCollisionCells2D(const uint32_t numparticles);
+uint32_t calculateCollisionGridSize2D(const uint32_t numparticles);
+uint32_t calculateNumberOfTiles2D(const uint32_t cols, const uint32_t rows);
 bool allocateParticleSystemMemory2D(const uint32_t numparticles, const uint32_t numsources, const bool advanced, const bool sizecontrol, const uint32_t additionalbytes);
+void handleCollisionGrid2D(); // frees the shared collision grid once no particle system used it for PS_COLLISION_GRID_TIMEOUT ms
 
 // distance-based brightness for ellipse rendering, returns brightness (0-255) based on distance from ellipse center
 inline uint8_t calculateEllipseBrightness(int32_t dx, int32_t dy, int32_t rxsq, int32_t rysq, uint8_t maxBrightness) {
@@ -388,6 +469,9 @@ private:
   //paricle physics applied by system if flags are set
   void applyGravity(); // applies gravity to all particles
   void handleCollisions();
+  void moveParticles(); // moves all particles using the system settings
+  template<bool doBounce, bool sized> void moveParticles();
+  [[gnu::always_inline]] inline void moveParticle(PSparticle1D &part, PSparticleFlags1D &partFlags, const PSsettings1D &options, const bool bounce, const PSadvancedParticle1D *advancedproperties);
   void collideParticles(uint32_t partIdx1, uint32_t partIdx2, int32_t dx, uint32_t collisiondistance);
 
   //utility functions
@@ -412,6 +496,62 @@ private:
   uint8_t smearBlur; // smeared blurring of full frame
 };
 
+// particle moves, decays and dies, shared by particleMoveUpdate() and the move pass of update()
+// the move pass passes constant bounce flag and size (nullptr if not sized), so they fold away when this is inlined into its loop
+inline void ParticleSystem1D::moveParticle(PSparticle1D &part, PSparticleFlags1D &partFlags, const PSsettings1D &options, const bool bounce, const PSadvancedParticle1D *advancedproperties) {
+  if (part.ttl == 0)
+    return;
+  if (!partFlags.perpetual)
+    part.ttl--; // age
+  if (options.colorByAge)
+    part.hue = min(part.ttl, (uint16_t)255); // set color to ttl
+
+  int32_t renderradius = PS_P_HALFRADIUS_1D - 1 + particlesize; // used to check out of bounds, default for 2 pixel rendering
+  int32_t newX = part.x + (int32_t)part.vx;
+  partFlags.outofbounds = false; // reset out of bounds (in case particle was created outside the matrix and is now moving into view)
+
+  if (advancedproperties != nullptr) { // using individual particle size?
+    renderradius = PS_P_HALFRADIUS_1D - 1 + advancedproperties->size; // note: for single pixel particles, it should be zero, but it does not matter as out of bounds checking is done in rendering function
+    if (advancedproperties->size > 1)
+      particleHardRadius = PS_P_MINHARDRADIUS_1D + ((advancedproperties->size * 52) >> 6); // use 1 pixel + 80% of size for hard radius (slight overlap with boarders so they do not "float" and nicer stacking)
+    else // single pixel particles use half the collision distance for walls
+      particleHardRadius = PS_P_MINHARDRADIUS_1D >> 1;
+  }
+
+  // if wall collisions are enabled, bounce them before they reach the edge, it looks much nicer if the particle is not half out of view
+  if (bounce) {
+    if ((newX < (int32_t)particleHardRadius) || ((newX > (int32_t)(maxX - particleHardRadius)))) { // reached a wall
+      bool bouncethis = true;
+      if (options.useGravity) // skip bouncing at x = 0 with reversed gravity, at x = max otherwise
+        bouncethis = partFlags.reversegrav ? newX >= (int32_t)particleHardRadius : newX <= (int32_t)particleHardRadius;
+      if (bouncethis) {
+        part.vx = -part.vx; // invert speed
+        part.vx = ((int32_t)part.vx * (int32_t)wallHardness) / 255; // reduce speed as energy is lost on non-hard surface
+        if (newX < (int32_t)particleHardRadius)
+          newX = particleHardRadius; // fast particles will never reach the edge if position is inverted, this looks better
+        else
+          newX = maxX - particleHardRadius;
+      }
+    }
+  }
+
+  if (!checkBoundsAndWrap(newX, maxX, renderradius, options.wrap)) { // check out of bounds note: this must not be skipped or it can lead to crashes
+    partFlags.outofbounds = true;
+    if (options.killoutofbounds) {
+      bool killthis = true;
+      if (options.useGravity) // if gravity is used, only kill below 'floor level', do not skip far out of bounds
+        killthis = partFlags.reversegrav ? (newX >= 0 && newX <= maxX << 2) : (newX <= 0 || newX >= maxX << 2);
+      if (killthis)
+        part.ttl = 0;
+    }
+  }
+
+  if (!partFlags.fixed)
+    part.x = newX; // set new position
+  else
+    part.vx = 0; // set speed to zero. note: particle can get speed in collisions, if unfixed, it should not speed away
+}
+
 bool initParticleSystem1D(ParticleSystem1D *&PartSys, const uint32_t requestedsources, const uint8_t fractionofparticles = 255, const uint32_t additionalbytes = 0, const bool advanced = false);
 uint32_t calculateNumberOfParticles1D(const uint32_t fraction, const bool isadvanced);
 uint32_t calculateNumberOfSources1D(const uint32_t requestedsources);
@@ -285,6 +285,47 @@ void IRAM_ATTR BusDigital::setPixelColor(unsigned pix, uint32_t c) {
   PolyBus::setPixelColor(_busPtr, _iType, pix, c, co, wwcw);
 }
 
+// same as setPixelColor() for a run of pixels, with all per-bus decisions taken once
+void IRAM_ATTR BusDigital::setPixels(unsigned pix, unsigned count, const uint32_t *colors) {
+  if (!_valid) return;
+  if (_type == TYPE_WS2812_1CH_X3) { // read-modify-write of shared ICs, keep per-pixel path
+    Bus::setPixels(pix, count, colors);
+    return;
+  }
+  const bool     autoWhite = hasWhite();
+  const int16_t  kelvin    = Bus::_cct >= 1900 ? Bus::_cct : 0;
+  const bool     useABL    = BusManager::_useABL;
+  const bool     maxRGB    = _milliAmpsPerLed == 255; // WS2815 power model (see setPixelColor())
+  const bool     cct       = hasCCT();
+  const bool     coMap     = _colorOrderMap.count() > 0;
+  const int      step      = _reversed ? -1 : 1;
+  unsigned       p         = (_reversed ? _len - pix - 1 : pix) + _skip;
+  uint8_t        co        = _colorOrder;
+  uint32_t       colorSum  = 0;
+
+  for (unsigned i = 0; i < count; i++, p += step) {
+    uint32_t c = colors[i];
+    if (autoWhite) c = autoWhiteCalc(c);
+    if (kelvin) c = colorBalanceFromKelvin(kelvin, c);
+    c = color_fade(c, _bri, true);
+    if (useABL) {
+      uint8_t r = R(c), g = G(c), b = B(c);
+      if (!maxRGB) colorSum += r + g + b + W(c);
+      else         colorSum += ((r > g) ? ((r > b) ? r : b) : ((g > b) ? g : b));
+    }
+    if (coMap) co = _colorOrderMap.getPixelColorOrder(p+_start, _colorOrder);
+    uint16_t wwcw = 0;
+    if (cct) {
+      uint8_t cctWW = 0, cctCW = 0;
+      Bus::calculateCCT(c, cctWW, cctCW);
+      wwcw = (cctCW<<8) | cctWW;
+      if (_type == TYPE_WS2812_WWA) c = RGBW32(cctWW, cctCW, 0, W(c));
+    }
+    PolyBus::setPixelColor(_busPtr, _iType, p, c, co, wwcw);
+  }
+  _colorSum += colorSum;
+}
+
 // returns lossly restored color from bus
 uint32_t IRAM_ATTR BusDigital::getPixelColor(unsigned pix) const {
   if (!_valid) return 0;
@@ -661,6 +702,7 @@ BusNetwork::BusNetwork(const BusConfig &bc)
       _UDPtype = 2;
       break;
     case TYPE_NET_E131_RGB:
+    case TYPE_NET_E131_RGBW:
       _UDPtype = 1;
       break;
     default: // TYPE_NET_DDP_RGB / TYPE_NET_DDP_RGBW
@@ -692,6 +734,22 @@ void BusNetwork::setPixelColor(unsigned pix, uint32_t c) {
   if (_hasWhite) _data[offset+3] = W(c);
 }
 
+void BusNetwork::setPixels(unsigned pix, unsigned count, const uint32_t *colors) {
+  if (!_valid || pix >= _len) return;
+  if (count > _len - pix) count = _len - pix;
+  const int16_t kelvin = Bus::_cct >= 1900 ? Bus::_cct : 0;
+  uint8_t *data = _data + pix * _UDPchannels;
+  for (unsigned i = 0; i < count; i++, data += _UDPchannels) {
+    uint32_t c = colors[i];
+    if (_hasWhite) c = autoWhiteCalc(c);
+    if (kelvin) c = colorBalanceFromKelvin(kelvin, c);
+    data[0] = R(c);
+    data[1] = G(c);
+    data[2] = B(c);
+    if (_hasWhite) data[3] = W(c);
+  }
+}
+
 uint32_t BusNetwork::getPixelColor(unsigned pix) const {
   if (!_valid || pix >= _len) return 0;
   unsigned offset = pix * _UDPchannels;
@@ -728,8 +786,10 @@ std::vector<LEDType> BusNetwork::getLEDTypes() {
   return {
     {TYPE_NET_DDP_RGB,     "N",     PSTR("DDP RGB (network)")},      // should be "NNNN" to determine 4 "pin" fields
     {TYPE_NET_ARTNET_RGB,  "N",     PSTR("Art-Net RGB (network)")},
+    {TYPE_NET_E131_RGB,    "N",     PSTR("E1.31 RGB (network)")},
     {TYPE_NET_DDP_RGBW,    "N",     PSTR("DDP RGBW (network)")},
     {TYPE_NET_ARTNET_RGBW, "N",     PSTR("Art-Net RGBW (network)")},
+    {TYPE_NET_E131_RGBW,   "N",     PSTR("E1.31 RGBW (network)")},
     // hypothetical extensions
     //{TYPE_VIRTUAL_I2C_W,   "V",     PSTR("I2C White (virtual)")}, // allows setting I2C address in _pin[0]
     //{TYPE_VIRTUAL_I2C_CCT, "V",     PSTR("I2C CCT (virtual)")}, // allows setting I2C address in _pin[0]
@@ -740,6 +800,7 @@ std::vector<LEDType> BusNetwork::getLEDTypes() {
 
 void BusNetwork::cleanup() {
   DEBUGBUS_PRINTLN(F("Virtual Cleanup."));
+  realtimeBroadcastRelease(_UDPtype, _client); // packet buffers
   d_free(_data);
   _data = nullptr;
   _type = I_NONE;
@@ -1026,6 +1087,12 @@ void IRAM_ATTR BusHub75Matrix::setPixelColor(unsigned pix, uint32_t c) {
   }
 }
 
+void IRAM_ATTR BusHub75Matrix::setPixels(unsigned pix, unsigned count, const uint32_t *colors) {
+  if (!_valid) return;
+  // qualified call: no virtual dispatch, lets the compiler inline the per-pixel body
+  for (unsigned i = 0; i < count; i++) BusHub75Matrix::setPixelColor(pix + i, colors[i]);
+}
+
 uint32_t BusHub75Matrix::getPixelColor(unsigned pix) const {
   if (!_valid) return IS_BLACK; // note: no need to check pix >= _len as that is checked in containsPixel()
   if (_ledBuffer)
@@ -1318,6 +1385,17 @@ void IRAM_ATTR BusManager::setPixelColor(unsigned pix, uint32_t c) {
   }
 }
 
+void IRAM_ATTR BusManager::setPixels(unsigned pix, unsigned count, const uint32_t *c) {
+  const unsigned end = pix + count;
+  for (auto &bus : busses) {
+    const unsigned bStart = bus->getStart();
+    const unsigned bEnd   = bStart + bus->getLength(); // 0 length if bus is not OK
+    const unsigned from   = max(pix, bStart);
+    const unsigned to     = min(end, bEnd);
+    if (from < to) bus->setPixels(from - bStart, to - from, c + (from - pix));
+  }
+}
+
 void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
   if (cct > 255) cct = 255;
   if (cct >= 0) {
@@ -585,6 +585,8 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject if_live_dmx = if_live["dmx"];
   CJSON(e131Universe, if_live_dmx[F("uni")]);
   CJSON(e131SkipOutOfSequence, if_live_dmx[F("seqskip")]);
+  CJSON(realtimeFrameTimeout, if_live[F("fto")]);
+  if (realtimeFrameTimeout > 1000) realtimeFrameTimeout = 1000;
   CJSON(DMXAddress, if_live_dmx[F("addr")]);
   if (!DMXAddress || DMXAddress > 510) DMXAddress = 1;
   CJSON(DMXSegmentSpacing, if_live_dmx[F("dss")]);
@@ -823,6 +825,7 @@ void serializeConfigToFS() {
   releaseJSONBufferLock();
 
   configNeedsWrite = false;
+  realtimeBroadcastUpdateSource(); // device name may have changed
 }
 
 void serializeConfig(JsonObject root) {
@@ -1113,6 +1116,7 @@ void serializeConfig(JsonObject root) {
   JsonObject if_live_dmx = if_live.createNestedObject("dmx");
   if_live_dmx[F("uni")] = e131Universe;
   if_live_dmx[F("seqskip")] = e131SkipOutOfSequence;
+  if_live[F("fto")] = realtimeFrameTimeout;
   if_live_dmx[F("e131prio")] = e131Priority;
   if_live_dmx[F("addr")] = DMXAddress;
   if_live_dmx[F("dss")] = DMXSegmentSpacing;
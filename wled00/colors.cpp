@@ -83,6 +83,49 @@ uint32_t IRAM_ATTR color_fade(uint32_t c1, uint8_t amount, bool video) {
   return (rb | wg) + addRemains;
 }
 
+/*
+ * buffer kernels: same results as the per-pixel functions but two channels per 32 bit operation (SWAR)
+ * for a whole span, without per-pixel function calls or black/full-scale checks
+ */
+void WLED_O2_ATTR fadeBuffer(uint32_t *buf, size_t len, uint8_t scale) {
+  for (size_t i = 0; i < len; i++) buf[i] = fast_color_scale(buf[i], scale);
+}
+
+// color_blend(buf[i], color, blend): color's share is the same for every pixel and is calculated once
+void WLED_O2_ATTR blendBuffer(uint32_t *buf, size_t len, uint32_t color, uint8_t blend) {
+  const uint32_t TWO_CHANNEL_MASK = 0x00FF00FF;
+  const uint32_t keep = 256 - blend;
+  const uint32_t rbC  = ( color       & TWO_CHANNEL_MASK) * (blend + 1U);
+  const uint32_t wgC  = ((color >> 8) & TWO_CHANNEL_MASK) * (blend + 1U);
+  for (size_t i = 0; i < len; i++) {
+    const uint32_t c = buf[i];
+    const uint32_t rb = ((( c       & TWO_CHANNEL_MASK) * keep + rbC) >> 8) &  TWO_CHANNEL_MASK;
+    const uint32_t wg =  (((c >> 8) & TWO_CHANNEL_MASK) * keep + wgC)       & ~TWO_CHANNEL_MASK;
+    buf[i] = rb | wg;
+  }
+}
+
+// every pixel keeps keep/256 of its color and passes seep/256 to each neighbour
+// (source: FastLED colorutils.cpp, for keep < 40 it creates an alternating pattern)
+void WLED_O2_ATTR blurRow(uint32_t *buf, size_t len, size_t stride, uint8_t keep, uint8_t seep) {
+  if (len == 0) return;
+  uint32_t prev      = fast_color_scale(buf[0], keep);
+  uint32_t carryover = fast_color_scale(buf[0], seep);
+  for (size_t i = 1; i < len; i++) {
+    const uint32_t cur  = buf[i * stride];
+    if ((cur | carryover) == BLACK) { // nothing to spread (frequent in sparse effects)
+      buf[(i - 1) * stride] = prev;
+      prev = BLACK;
+      continue;
+    }
+    const uint32_t part = fast_color_scale(cur, seep);
+    buf[(i - 1) * stride] = fast_color_add(prev, part); // previous pixel is final
+    prev      = fast_color_add(fast_color_scale(cur, keep), carryover);
+    carryover = part;
+  }
+  buf[(len - 1) * stride] = prev;
+}
+
 /*
  * color adjustment in HSV color space (converts RGB to HSV and back), color conversions are not 100% accurate!
    shifts hue, increase brightness, decreases saturation (if not black)
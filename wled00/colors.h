@@ -148,6 +148,20 @@ static inline uint32_t fast_color_scale(const uint32_t c, const uint8_t scale) {
   return rb | wg;
 }
 
+// saturating add of all four channels, same result as color_add(c1, c2, false)
+static inline uint32_t fast_color_add(const uint32_t c1, const uint32_t c2) {
+  uint32_t rb = ( c1     & 0x00FF00FF) + ( c2     & 0x00FF00FF);
+  uint32_t wg = ((c1>>8) & 0x00FF00FF) + ((c2>>8) & 0x00FF00FF);
+  rb |= ((rb & 0x01000100) - ((rb >> 8) & 0x00010001)) & 0x00FF00FF;
+  wg |= ((wg & 0x01000100) - ((wg >> 8) & 0x00010001)) & 0x00FF00FF;
+  return rb | (wg << 8);
+}
+
+// buffer kernels, work on contiguous spans of RGBW32 pixels (stride = distance between pixels, i.e. width for a column)
+void fadeBuffer(uint32_t *buf, size_t len, uint8_t scale);                  // fast_color_scale() of every pixel
+void blendBuffer(uint32_t *buf, size_t len, uint32_t color, uint8_t blend); // color_blend() of every pixel towards color
+void blurRow(uint32_t *buf, size_t len, size_t stride, uint8_t keep, uint8_t seep); // 1D blur, see Segment::blur()
+
 // palettes
 extern const TProgmemRGBPalette16* const fastledPalettes[];
 extern const uint8_t* const gGradientPalettes[];
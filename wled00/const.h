@@ -333,10 +333,11 @@ static_assert(WLED_MAX_BUSSES <= 32, "WLED_MAX_BUSSES exceeds hard limit");
 //Network types (master broadcast) (80-95)
 #define TYPE_VIRTUAL_MIN         80
 #define TYPE_NET_DDP_RGB         80            //network DDP RGB bus (master broadcast bus)
-#define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus, unused)
+#define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus)
 #define TYPE_NET_ARTNET_RGB      82            //network ArtNet RGB bus (master broadcast bus, unused)
 #define TYPE_NET_DDP_RGBW        88            //network DDP RGBW bus (master broadcast bus)
 #define TYPE_NET_ARTNET_RGBW     89            //network ArtNet RGB bus (master broadcast bus, unused)
+#define TYPE_NET_E131_RGBW       90            //network E131 RGBW bus (master broadcast bus)
 #define TYPE_VIRTUAL_MAX         95
 
 //Color orders
@@ -506,6 +507,7 @@ static_assert(WLED_MAX_BUSSES <= 32, "WLED_MAX_BUSSES exceeds hard limit");
 #define SETTINGS_STACK_BUF_SIZE 3840  // warning: quite a large value for stack (640 * WLED_MAX_USERMODS)
 #endif
 
+#ifndef E131_MAX_UNIVERSE_COUNT // up to 32
 #ifdef WLED_USE_ETHERNET
   #define E131_MAX_UNIVERSE_COUNT 20
 #else
@@ -515,6 +517,7 @@ static_assert(WLED_MAX_BUSSES <= 32, "WLED_MAX_BUSSES exceeds hard limit");
     #define E131_MAX_UNIVERSE_COUNT 12
   #endif
 #endif
+#endif
 
 #ifndef ABL_MILLIAMPS_DEFAULT
   #define ABL_MILLIAMPS_DEFAULT 850   // auto lower brightness to stay close to milliampere limit
@@ -8,6 +8,189 @@
  * E1.31 handler
  */
 
+/*
+ * Realtime frame assembler (enabled with realtimeFrameTimeout > 0)
+ * Pixel data of DMX_MODE_MULTIPLE_* universes and DDP packets arrives in the UDP task while the strip may be shown
+ * from loop(), writing it straight into the strip tears frames that span several universes. Instead packets fill
+ * rtFrame.back and a frame is handed over as a whole when it is complete: all universes received (or a universe
+ * arrives a second time), DDP PUSH, E1.31 universe synchronization, or realtimeFrameTimeout ms after its first packet.
+ * Handing over swaps back and ready, handleRealtimeFrame() swaps ready and front and copies front into the strip from
+ * loop() context. Buffer pointers and frame state are only changed under RT_FRAME_LOCK(), the UDP task writes into
+ * back only while rtFrame.writing is set, so a frame is never handed over (by timeout from loop()) while it is written.
+ */
+static_assert(E131_MAX_UNIVERSE_COUNT <= 32, "universe mask is 32 bit");
+
+static struct {
+  uint32_t     *back;         // frame being received (realtime pixel index, arlsOffset is applied when shown)
+  uint32_t     *ready;        // last complete frame, not taken by loop() yet if newFrame is set
+  uint32_t     *front;        // frame loop() copies into the strip
+  const uint32_t *last;       // last complete frame (ready or front), back continues from it (partial updates)
+  unsigned      length;
+  uint32_t      universes;    // universes received for the frame in back
+  unsigned long start;        // millis() of the first packet of the frame in back
+  uint16_t      syncUniverse; // E1.31 synchronization universe the frame in back waits for (0 = none)
+  bool          writing;      // UDP task is writing into back
+  bool          newFrame;     // ready holds a frame loop() has not taken yet
+  bool          restore;      // back must be refreshed from last before it is written
+  bool          clear;        // back must be cleared before it is written
+  bool          dirty;        // back has been written since realtime mode was entered
+} rtFrame = {nullptr, nullptr, nullptr, nullptr, 0, 0, 0, 0, false, false, false, false, false};
+
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE rtFrameMux = portMUX_INITIALIZER_UNLOCKED; // UDP task and loop() run concurrently
+#define RT_FRAME_LOCK()   portENTER_CRITICAL(&rtFrameMux)
+#define RT_FRAME_UNLOCK() portEXIT_CRITICAL(&rtFrameMux)
+#else
+#define RT_FRAME_LOCK()   // UDP callbacks do not interrupt loop() on ESP8266
+#define RT_FRAME_UNLOCK()
+#endif
+
+static uint16_t e131SyncUniverse = 0; // of the E1.31 data packet being processed
+
+static inline bool useFrameAssembler(uint8_t mde) {
+  return rtFrame.back && mde != REALTIME_MODE_DMX; // wired DMX input is read in loop() anyway
+}
+
+static inline void setFramePixel(unsigned i, byte r, byte g, byte b, byte w) {
+  if (i < rtFrame.length) rtFrame.back[i] = RGBW32(r,g,b,w);
+}
+
+// hands frame in back over to loop(), call with RT_FRAME_LOCK() held and rtFrame.writing not set
+static void completeFrameLocked() {
+  uint32_t *done = rtFrame.back;
+  rtFrame.back     = rtFrame.ready; // ready is either taken by loop() already or superseded
+  rtFrame.ready    = done;
+  rtFrame.last     = done;
+  rtFrame.newFrame = true;
+  rtFrame.restore  = true;
+  rtFrame.universes    = 0;
+  rtFrame.syncUniverse = 0;
+  e131NewData = true;
+}
+
+// UDP task: call before pixel data is written to back buffer, universe is relative to e131Universe (-1 for DDP)
+// returns false if there is no back buffer (anymore), pixels must not be written then
+static bool frameWriteBegin(int universe) {
+  RT_FRAME_LOCK();
+  if (!rtFrame.back) {
+    RT_FRAME_UNLOCK();
+    return false;
+  }
+  if (universe >= 0 && (rtFrame.universes & (1UL << universe))) completeFrameLocked(); // next frame started before the previous one was complete (packet loss)
+  if (!rtFrame.universes) rtFrame.start = millis();
+  rtFrame.writing = true;
+  rtFrame.dirty   = true;
+  const bool clear = rtFrame.clear, restore = rtFrame.restore && rtFrame.last;
+  const uint32_t *last = rtFrame.last; // can't be handed over again while writing is set, loop() only reads it
+  rtFrame.clear = rtFrame.restore = false;
+  RT_FRAME_UNLOCK();
+  if (clear)        memset(rtFrame.back, 0, rtFrame.length * sizeof(uint32_t));
+  else if (restore) memcpy(rtFrame.back, last, rtFrame.length * sizeof(uint32_t));
+  return true;
+}
+
+// all universes of DMX_MODE_MULTIPLE_* needed for the whole strip
+static uint32_t expectedUniverseMask() {
+  const bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
+  const unsigned dmxChannelsPerLed = is4Chan ? 4 : 3;
+  const unsigned dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
+  const unsigned dmxLenOffset = (DMXAddress == 0) ? 0 : 1;
+  const unsigned ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
+  const unsigned ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
+  const unsigned totalLen = strip.getLengthTotal();
+  unsigned count = 1;
+  if (totalLen > ledsInFirstUniverse) count += (totalLen - ledsInFirstUniverse + ledsPerUniverse - 1) / ledsPerUniverse;
+  return count >= 32 ? UINT32_MAX : (1UL << count) - 1; // E131_MAX_UNIVERSE_COUNT <= 32
+}
+
+// UDP task: pixel data of universe is in back buffer, syncUniverse from E1.31 frame layer
+static void frameUniverseReceived(unsigned universe, uint16_t syncUniverse) {
+  const uint32_t expected = expectedUniverseMask();
+  RT_FRAME_LOCK();
+  rtFrame.writing = false;
+  rtFrame.universes |= 1UL << universe;
+  rtFrame.syncUniverse = syncUniverse;
+  if (!syncUniverse && (rtFrame.universes & expected) == expected) completeFrameLocked(); // otherwise wait for synchronization packet
+  RT_FRAME_UNLOCK();
+}
+
+// UDP task: DDP packet is in back buffer, frame is complete with push
+static void frameDDPReceived(bool push) {
+  RT_FRAME_LOCK();
+  rtFrame.writing = false;
+  if (push) completeFrameLocked();
+  else      rtFrame.universes = 1; // frame has data
+  RT_FRAME_UNLOCK();
+}
+
+// UDP task: E1.31 synchronization packet
+static void frameSync(uint16_t syncUniverse) {
+  RT_FRAME_LOCK();
+  if (rtFrame.back && rtFrame.universes && !rtFrame.writing && rtFrame.syncUniverse == syncUniverse) completeFrameLocked();
+  RT_FRAME_UNLOCK();
+}
+
+// called from loop(): (de)allocates buffers, handles timeout and copies a complete frame into the strip
+void handleRealtimeFrame() {
+  const unsigned length = realtimeFrameTimeout ? strip.getLengthTotal() : 0;
+  if (length != rtFrame.length && !realtimeMode) { // only (re)allocate while no realtime data is being received
+    RT_FRAME_LOCK();
+    const bool writing = rtFrame.writing;
+    uint32_t *back = rtFrame.back, *ready = rtFrame.ready, *front = rtFrame.front;
+    if (!writing) {
+      rtFrame.back = rtFrame.ready = rtFrame.front = nullptr;
+      rtFrame.last = nullptr;
+      rtFrame.length = 0;
+      rtFrame.universes = 0;
+      rtFrame.newFrame = rtFrame.restore = rtFrame.clear = false;
+    }
+    RT_FRAME_UNLOCK();
+    if (writing) return; // packet is being processed, try again next time
+    p_free(back);
+    p_free(ready);
+    p_free(front);
+    if (length) {
+      back  = static_cast<uint32_t*>(p_calloc(length, sizeof(uint32_t)));
+      ready = static_cast<uint32_t*>(p_malloc(length * sizeof(uint32_t)));
+      front = static_cast<uint32_t*>(p_malloc(length * sizeof(uint32_t)));
+      if (back && ready && front) {
+        RT_FRAME_LOCK();
+        rtFrame.ready  = ready;
+        rtFrame.front  = front;
+        rtFrame.length = length;
+        rtFrame.back   = back;
+        RT_FRAME_UNLOCK();
+      } else {
+        DEBUG_PRINTLN(F("No memory for realtime frame buffers."));
+        p_free(back);
+        p_free(ready);
+        p_free(front);
+      }
+    }
+  }
+  if (!rtFrame.back) return;
+
+  RT_FRAME_LOCK();
+  if (!realtimeMode && rtFrame.dirty) { // next realtime session starts from black like the strip (see realtimeLock())
+    rtFrame.clear = true;
+    rtFrame.dirty = false;
+  }
+  const uint32_t incomplete = rtFrame.universes;
+  const bool timeout = incomplete && !rtFrame.writing && millis() - rtFrame.start > realtimeFrameTimeout;
+  if (timeout) completeFrameLocked();
+  const bool newFrame = rtFrame.newFrame;
+  if (newFrame) {
+    uint32_t *frame = rtFrame.ready;
+    rtFrame.ready    = rtFrame.front;
+    rtFrame.front    = frame;
+    rtFrame.newFrame = false;
+  }
+  RT_FRAME_UNLOCK();
+  if (timeout) DEBUG_PRINTF_P(PSTR("Realtime frame incomplete (universes %x), showing anyway.\n"), (unsigned)incomplete);
+  if (!newFrame || realtimeOverride) return;
+  for (unsigned i = 0; i < rtFrame.length; i++) strip.setRealtimePixelColor(i + arlsOffset, rtFrame.front[i]); // front is not touched by UDP task
+}
+
 //DDP protocol support, called by handleE131Packet
 //handles RGB data only
 void handleDDPPacket(e131_packet_t* p) {
@@ -46,16 +229,20 @@ void handleDDPPacket(e131_packet_t* p) {
   if (realtimeMode != REALTIME_MODE_DDP) ddpSeenPush = false; // just starting, no push yet
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
 
+  const bool assemble = useFrameAssembler(REALTIME_MODE_DDP) && frameWriteBegin(-1);
   if (!realtimeOverride) {
     for (unsigned i = start; i < stop; i++, c += ddpChannelsPerLed) {
-      setRealtimePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
+      if (assemble) setFramePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
+      else          setRealtimePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
     }
   }
 
   bool push = p->flags & DDP_PUSH_FLAG;
   ddpSeenPush |= push;
-  if (!ddpSeenPush || push) { // if we've never seen a push, or this is one, render display
-    e131NewData = true;
+  const bool render = !ddpSeenPush || push; // if we've never seen a push, or this is one, render display
+  if (assemble)    frameDDPReceived(render);
+  else if (render) e131NewData = true;
+  if (render) {
     int sn = p->sequenceNum & 0xF;
     if (sn) e131LastSequenceNumber[0] = sn;
   }
@@ -94,6 +281,10 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       if (p->priority >= highPriority.get()) highPriority.set(p->priority);
       if (p->priority < highPriority.get()) return;
     }
+  } else if (protocol == P_E131_SYNC) {
+    // frame waiting for this synchronization universe is complete
+    frameSync(htons(p->sync_universe));
+    return;
   } else { //DDP
     realtimeIP = clientIP;
     handleDDPPacket(p);
@@ -124,6 +315,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
   // update status info
   realtimeIP = clientIP;
 
+  e131SyncUniverse = (protocol == P_E131) ? htons(p->sync_address) : 0;
   handleDMXData(uni, dmxChannels, e131_data, mde, previousUniverses);
 }
 
@@ -321,6 +513,14 @@ void handleDMXData(uint16_t uni, uint16_t dmxChannels, uint8_t* e131_data, uint8
           }
         }
 
+        if (useFrameAssembler(mde) && frameWriteBegin(previousUniverses)) {
+          for (unsigned i = previousLeds; i < ledsTotal; i++) {
+            setFramePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], is4Chan ? e131_data[dmxOffset+3] : 0);
+            dmxOffset += dmxChannelsPerLed;
+          }
+          frameUniverseReceived(previousUniverses, e131SyncUniverse);
+          return; // e131NewData is set once the frame is complete
+        }
         for (unsigned i = previousLeds; i < ledsTotal; i++) {
           setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], is4Chan ? e131_data[dmxOffset+3] : 0);
           dmxOffset += dmxChannelsPerLed;
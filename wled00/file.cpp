@@ -32,6 +32,23 @@ static volatile size_t knownLargestSpace = MAX_SPACE;
 
 static File f; // don't export to other cpp files
 
+// Preset index: maps preset id to the position of its object in presets.json so reading a preset is a seek
+// and a single bounded read instead of a bufferedFind() scan of the whole file.
+// Rebuilt when presetsModifiedTime changes (file uploaded or edited), kept up to date by writeObjectToFile().
+struct PresetIndexEntry {
+  uint16_t id;
+  uint8_t  keyGap; // distance from opening quote of key to '{' (key, ':' and any whitespace)
+  uint32_t offset; // position of '{'
+  uint32_t length; // object length including braces
+};
+static std::vector<PresetIndexEntry> presetIndex; // sorted by id (first occurrence in file first)
+static unsigned long presetIndexTime = 0;         // presetsModifiedTime the index is valid for
+static size_t presetIndexSize = 0;                // file size the index is valid for
+static bool presetIndexValid = false;
+static bool presetIndexFailed = false;            // index can't be used for file of presetIndexTime/presetIndexSize
+static bool presetIndexOwnWrite = false;          // index already contains the change that will update presetsModifiedTime
+static bool fIsPresets = false;                   // f is presets.json (index is maintained by writes)
+
 //wrapper to find out how long closing takes
 void closeFile() {
   #ifdef WLED_DEBUG_FS
@@ -161,6 +178,111 @@ static bool bufferedFindObjectEnd() {
   return false;
 }
 
+static bool isPresetsFile(const char *fileName) {
+  return strcmp_P(fileName, getPresetsFileName()) == 0;
+}
+
+// scan presets.json once and record position and length of every root level object
+static bool buildPresetIndex() {
+  #ifdef WLED_DEBUG_FS
+    uint32_t s = millis();
+  #endif
+  presetIndex.clear();
+  presetIndexValid = false;
+  presetIndexFailed = false;
+  File pf = WLED_FS.open(FPSTR(getPresetsFileName()), "r");
+  if (!pf) return false;
+
+  byte buf[FS_BUFSIZE];
+  unsigned depth = 0;
+  bool inString = false, escape = false;
+  unsigned keyDigits = 0;  // >0 while string at root level consists of digits only
+  uint32_t key = 0;
+  bool haveKey = false;    // last root level string was a numeric key
+  uint32_t keyStart = 0;
+  uint32_t objStart = 0;
+  uint32_t pos = 0;
+
+  size_t len;
+  while ((len = pf.read(buf, FS_BUFSIZE)) > 0) {
+    for (size_t i = 0; i < len; i++, pos++) {
+      const char c = buf[i];
+      if (inString) {
+        if (escape) escape = false;
+        else if (c == '\\') escape = true;
+        else if (c == '"') { inString = false; if (depth == 1) haveKey = keyDigits > 0; }
+        else if (depth == 1 && keyDigits) {
+          if (c >= '0' && c <= '9' && keyDigits < 6) { key = key * 10 + (c - '0'); keyDigits++; }
+          else keyDigits = 0;
+        }
+        continue;
+      }
+      switch (c) {
+        case '"':
+          inString = true;
+          if (depth == 1) { key = 0; keyDigits = 1; haveKey = false; keyStart = pos; } // keyDigits is 1 + number of digits
+          break;
+        case '{':
+          if (depth == 1) objStart = pos;
+          depth++;
+          break;
+        case '}':
+          if (depth == 0) break;
+          if (--depth == 1 && haveKey && keyDigits > 1 && key <= UINT16_MAX) {
+            if (objStart - keyStart > UINT8_MAX) presetIndexFailed = true; // absurd amount of whitespace, can't be verified
+            presetIndex.push_back({uint16_t(key), uint8_t(objStart - keyStart), objStart, pos - objStart + 1});
+          }
+          if (depth == 1) haveKey = false;
+          break;
+      }
+    }
+  }
+  presetIndexSize = pf.size();
+  pf.close();
+
+  std::stable_sort(presetIndex.begin(), presetIndex.end(), [](const PresetIndexEntry &a, const PresetIndexEntry &b) { return a.id < b.id; });
+  presetIndexTime = presetsModifiedTime;
+  presetIndexOwnWrite = false;
+  presetIndexValid = !presetIndexFailed;
+  DEBUGFS_PRINTF("Preset index: %u entries, took %lu ms\n", presetIndex.size(), millis() - s);
+  return presetIndexValid;
+}
+
+// true if index describes file of given size
+static bool presetIndexCurrent(size_t fileSize) {
+  if (presetIndexValid && presetsModifiedTime != presetIndexTime) {
+    if (presetIndexOwnWrite) presetIndexTime = presetsModifiedTime; // changed by writeObjectToFile()
+    else presetIndexValid = false;
+    presetIndexOwnWrite = false;
+  }
+  if (presetIndexValid && fileSize != presetIndexSize) presetIndexValid = false;
+  return presetIndexValid;
+}
+
+static std::vector<PresetIndexEntry>::iterator findPresetIndex(uint16_t id) {
+  auto it = std::lower_bound(presetIndex.begin(), presetIndex.end(), id, [](const PresetIndexEntry &e, uint16_t i) { return e.id < i; });
+  return (it != presetIndex.end() && it->id == id) ? it : presetIndex.end();
+}
+
+// called by writes to presets.json (f) after object with key ("id":) was written at offset
+static void updatePresetIndex(const char *key, uint32_t offset, uint32_t length) {
+  if (!fIsPresets || !presetIndexValid) return;
+  const uint16_t id = atoi(key + 1);
+  auto it = findPresetIndex(id);
+  if (length == 0) {
+    if (it != presetIndex.end()) presetIndex.erase(it);
+  } else if (it != presetIndex.end()) {
+    it->keyGap = strlen(key); // written as "id":{
+    it->offset = offset;
+    it->length = length;
+  } else {
+    it = std::upper_bound(presetIndex.begin(), presetIndex.end(), id, [](uint16_t i, const PresetIndexEntry &e) { return i < e.id; });
+    presetIndex.insert(it, {id, uint8_t(strlen(key)), offset, length});
+  }
+  presetIndexSize = f.size();
+  presetIndexOwnWrite = true;
+}
+
 //fills n bytes from current file pos with ' ' characters
 static void writeSpace(size_t l)
 {
@@ -202,7 +324,9 @@ static bool appendObjectToFile(const char* key, const JsonDocument* content, uin
   if (bufferedFindSpace(contentLen + strlen(key) + 1)) {
     if (f.position() > 2) f.write(','); //add comma if not first object
     f.print(key);
+    pos = f.position();
     serializeJson(*content, f);
+    updatePresetIndex(key, pos, contentLen);
     DEBUGFS_PRINTF("Inserted, took %lu ms (total %lu)", millis() - s1, millis() - s);
     doCloseFile = true;
     return true;
@@ -247,8 +371,10 @@ static bool appendObjectToFile(const char* key, const JsonDocument* content, uin
   f.print(key);
 
   //Append object
+  pos = f.position();
   serializeJson(*content, f);
   f.write('}');
+  updatePresetIndex(key, pos, contentLen);
 
   doCloseFile = true;
   DEBUGFS_PRINTF("Appended, took %lu ms (total %lu)", millis() - s1, millis() - s);
@@ -278,6 +404,7 @@ bool writeObjectToFile(const char* file, const char* key, const JsonDocument* co
     DEBUGFS_PRINTLN(F("Failed to open!"));
     return false;
   }
+  fIsPresets = isPresetsFile(fileName) && presetIndexCurrent(f.size());
 
   if (!bufferedFind(key)) //key does not exist in file
   {
@@ -307,16 +434,19 @@ bool writeObjectToFile(const char* file, const char* key, const JsonDocument* co
     f.seek(pos);
     serializeJson(*content, f);
     writeSpace(pos2 - f.position());
+    updatePresetIndex(key, pos, contentLen);
   } else if (contentLen && bufferedFindSpace(contentLen - oldLen, false)) { //enough leading spaces to replace
     DEBUGFS_PRINTLN(F("replace (trailing)"));
     f.seek(pos);
     serializeJson(*content, f);
+    updatePresetIndex(key, pos, contentLen);
   } else {
     DEBUGFS_PRINTLN(F("delete"));
     pos -= strlen(key);
     if (pos > 3) pos--; //also delete leading comma if not first object
     f.seek(pos);
     writeSpace(pos2 - pos);
+    updatePresetIndex(key, 0, 0);
     if (contentLen) return appendObjectToFile(key, content, s, contentLen);
   }
 
@@ -325,10 +455,81 @@ bool writeObjectToFile(const char* file, const char* key, const JsonDocument* co
   return true;
 }
 
+// read preset using the index, returns false if index can't be used
+static bool readPresetUsingIndex(uint16_t id, const char *key, JsonDocument* dest, const JsonDocument* filter, bool &found)
+{
+  f = WLED_FS.open(FPSTR(getPresetsFileName()), "r");
+  if (!f) return false;
+  bool fresh = false;
+  if (!presetIndexCurrent(f.size())) {
+    const bool unchanged = presetIndexTime == presetsModifiedTime && presetIndexSize == f.size();
+    f.close(); // index is built with its own file handle
+    if (presetIndexFailed && unchanged) return false; // don't rebuild until file changes
+    if (!buildPresetIndex()) return false;
+    fresh = true;
+    f = WLED_FS.open(FPSTR(getPresetsFileName()), "r");
+    if (!f) return false;
+  }
+  auto it = findPresetIndex(id);
+  found = it != presetIndex.end();
+  if (!found) {
+    f.close();
+    return true;
+  }
+
+  // verify key in front of object ("id" followed by ':' and '{', whitespace allowed around ':'), index is stale otherwise
+  const size_t keyLen = strlen(key) - 1; // without ':'
+  char buf[UINT8_MAX + 1];
+  const size_t gap = it->keyGap;
+  bool valid = gap > keyLen && it->offset >= gap && f.seek(it->offset - gap) && f.read((uint8_t*)buf, gap + 1) == gap + 1
+               && strncmp(buf, key, keyLen) == 0 && buf[gap] == '{';
+  unsigned colons = 0;
+  for (size_t i = keyLen; valid && i < gap; i++) {
+    if (buf[i] == ':') colons++;
+    else if (!isspace(buf[i])) valid = false;
+  }
+  valid = valid && colons == 1;
+  if (!valid) {
+    f.close();
+    presetIndexValid = false;
+    presetIndexFailed = fresh; // freshly built index does not match: don't rebuild until file changes
+    return false;
+  }
+
+  // single read of the whole object, parse from RAM (stream parsing reads byte by byte)
+  char *obj = static_cast<char*>(p_malloc(it->length));
+  f.seek(it->offset);
+  if (obj && f.read((uint8_t*)obj, it->length) == it->length) {
+    if (filter) deserializeJson(*dest, (const char*)obj, it->length, DeserializationOption::Filter(*filter));
+    else        deserializeJson(*dest, (const char*)obj, it->length);
+  } else {
+    f.seek(it->offset);
+    if (filter) deserializeJson(*dest, f, DeserializationOption::Filter(*filter));
+    else        deserializeJson(*dest, f);
+  }
+  p_free(obj);
+  f.close();
+  return true;
+}
+
 bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest, const JsonDocument* filter)
 {
   char objKey[10];
   sprintf(objKey, "\"%d\":", id);
+  char fileName[129]; strncpy_P(fileName, file, 128); fileName[128] = 0;
+  if (isPresetsFile(fileName)) {
+    if (doCloseFile) closeFile();
+    #ifdef WLED_DEBUG_FS
+      DEBUGFS_PRINTF("Read preset %u using index >>>\n", id);
+      uint32_t s = millis();
+    #endif
+    bool found = false;
+    if (readPresetUsingIndex(id, objKey, dest, filter, found)) {
+      if (!found) dest->clear();
+      DEBUGFS_PRINTF("%s, took %lu ms\n", found ? "Read" : "Obj not found.", millis() - s);
+      return found;
+    }
+  }
   return readObjectFromFile(file, objKey, dest, filter);
 }
 
@@ -4,6 +4,19 @@
 
 #include "GifDecoder.h"
 
+// decoded frames of animated GIFs are cached (scaled to segment size) and replayed from memory once the whole animation fits
+// without PSRAM the budget is about the size of the decoder, which is released when the cache is complete
+#ifndef WLED_GIF_CACHE_SIZE
+  #ifdef BOARD_HAS_PSRAM
+    #define WLED_GIF_CACHE_SIZE (1024*1024)
+  #else
+    #define WLED_GIF_CACHE_SIZE (24*1024)
+  #endif
+#endif
+// without PSRAM decoder and a full cache have to fit into the heap at the same time while the first loop is decoded
+#ifndef WLED_GIF_CACHE_MIN_HEAP
+  #define WLED_GIF_CACHE_MIN_HEAP (48*1024)
+#endif
 
 /*
  * Functions to render images from filesystem to segments, used by the "Image" effect
@@ -14,6 +27,11 @@ static char lastFilename[WLED_MAX_SEGNAME_LEN+2] = "/"; // enough space for "/"
 static GifDecoder<320,320,12,true> decoder;  // this creates the basic object; parameter lzwMaxBits is not used; decoder.alloc() always allocated "everything else" = 24Kb 
 static bool gifDecodeFailed = false;
 static unsigned long lastFrameDisplayTime = 0, currentFrameDelay = 0;
+static uint32_t *frameCache = nullptr; // decoded frames (segment pixels) followed by their delays
+static unsigned gifFrames = 0;         // number of frames in GIF file, 0 = not cached
+static unsigned cachedFrames = 0;      // number of frames in cache, cache is complete (and decoder released) if equal to gifFrames
+static unsigned replayFrame = 0;       // next frame to replay from cache
+static uint8_t  cacheBlur = 0;         // blur setting the cached frames were rendered with
 
 bool fileSeekCallback(unsigned long position) {
   return file.seek(position);
@@ -43,10 +61,48 @@ bool openGif(const char *filename) {  // side-effect: updates "file"
   return true;
 }
 
+// count image frames by walking the block structure of the GIF (decoder has no frame count), returns 0 if file is malformed
+// must be called before decoding is started as it moves the file position
+static unsigned countGifFrames() {
+  uint8_t buf[13];
+  const size_t size = file.size();
+  if (!file.seek(0) || file.read(buf, 13) != 13) return 0; // header and logical screen descriptor
+  size_t pos = 13;
+  if (buf[10] & 0x80) pos += 3 << ((buf[10] & 0x07) + 1); // global color table
+  unsigned frames = 0;
+  while (pos < size) {
+    file.seek(pos);
+    int block = file.read();
+    if (block == 0x3B) break; // trailer
+    if (block == 0x21) pos += 2; // extension: introducer and label, followed by data sub-blocks
+    else if (block == 0x2C) {    // image descriptor: position, size and flags, followed by LZW code size and data sub-blocks
+      if (file.read(buf, 9) != 9) return 0;
+      pos += 10;
+      if (buf[8] & 0x80) pos += 3 << ((buf[8] & 0x07) + 1); // local color table
+      pos++;
+      frames++;
+    } else return 0;
+    int len;
+    do { // skip data sub-blocks
+      if (pos >= size || !file.seek(pos) || (len = file.read()) < 0) return 0;
+      pos += len + 1;
+    } while (len > 0);
+  }
+  file.seek(0);
+  return frames;
+}
+
+static void freeFrameCache() {
+  p_free(frameCache);
+  frameCache = nullptr;
+  gifFrames = cachedFrames = replayFrame = 0;
+}
+
 static Segment* activeSeg;
 static uint16_t gifWidth, gifHeight;
 static int lastCoordinate; // last coordinate (x+y) that was set, used to reduce redundant pixel writes
 static uint16_t perPixelX, perPixelY; // scaling factors when upscaling
+static uint16_t frameWidth, frameHeight; // segment size the GIF was scaled to
 
 void screenClearCallback(void) {
   activeSeg->fill(0);
@@ -54,13 +110,39 @@ void screenClearCallback(void) {
 
 // this callback runs when the decoder has finished painting all pixels
 void updateScreenCallback(void) {
-  // perfect time for adding blur
+  lastCoordinate = -1; // invalidate last position
+}
+
+// blur is added to a finished frame before it is cached: decoder only draws changed pixels so blur accumulates over frames
+static void blurFrame() {
   if (activeSeg->intensity > 1) {
     uint8_t blurAmount = activeSeg->intensity;
     if ((blurAmount < 24) && (activeSeg->is2D())) activeSeg->blurRows(activeSeg->intensity);  // some blur - fast
     else activeSeg->blur(blurAmount);                                                         // more blur - slower
   }
-  lastCoordinate = -1; // invalidate last position
+}
+
+// copy finished frame from segment to cache or back, frames are stored in virtual segment pixels
+static void storeFrame(unsigned frame) {
+  uint32_t *pixels = frameCache + frame * frameWidth * frameHeight;
+  if (activeSeg->is2D()) {
+    for (int y = 0; y < frameHeight; y++)
+      for (int x = 0; x < frameWidth; x++) *pixels++ = activeSeg->getPixelColorXY(x, y);
+  } else {
+    for (int i = 0; i < frameWidth; i++) *pixels++ = activeSeg->getPixelColor(i);
+  }
+  frameCache[gifFrames * frameWidth * frameHeight + frame] = currentFrameDelay;
+}
+
+static void restoreFrame(unsigned frame) {
+  const uint32_t *pixels = frameCache + frame * frameWidth * frameHeight;
+  if (activeSeg->is2D()) {
+    for (int y = 0; y < frameHeight; y++)
+      for (int x = 0; x < frameWidth; x++) activeSeg->setPixelColorXY(x, y, *pixels++);
+  } else {
+    for (int i = 0; i < frameWidth; i++) activeSeg->setPixelColor(i, *pixels++);
+  }
+  currentFrameDelay = frameCache[gifFrames * frameWidth * frameHeight + frame];
 }
 
 // note: GifDecoder drawing is done top right to bottom left, line by line
@@ -122,7 +204,16 @@ byte renderImageToSegment(Segment &seg) {
 
   activeSeg = &seg;
 
+  const uint16_t segWidth  = seg.is2D() ? seg.vWidth()  : seg.vLength(); // size the image is scaled to
+  const uint16_t segHeight = seg.is2D() ? seg.vHeight() : 1;
+  // segment size changed: scaling and cached frames are stale, blur changed: cached frames contain the old blur, reload
+  if (gifWidth && (frameWidth != segWidth || frameHeight != segHeight || (gifFrames && seg.intensity != cacheBlur))) {
+    endImagePlayback(&seg);
+    activeSeg = &seg;
+  }
+
   if (strncmp(lastFilename +1, seg.name, WLED_MAX_SEGNAME_LEN) != 0) { // segment name changed, load new image
+    freeFrameCache();
     strcpy(lastFilename, "/");  // filename always starts with '/'
     strncpy(lastFilename +1, seg.name, WLED_MAX_SEGNAME_LEN);
     lastFilename[WLED_MAX_SEGNAME_LEN+1] ='\0';     // ensure proper string termination when segment name was truncated
@@ -139,6 +230,20 @@ byte renderImageToSegment(Segment &seg) {
       DEBUG_PRINTF_P(PSTR("GIF file not found: %s\n"), lastFilename);
       return IMAGE_ERROR_FILE_MISSING;
     }
+    frameWidth  = segWidth;
+    frameHeight = segHeight;
+    const unsigned frames = countGifFrames();
+    const size_t cacheSize = frames * (frameWidth * frameHeight + 1) * sizeof(uint32_t); // pixels and delay of every frame
+    bool useCache = frames && cacheSize <= WLED_GIF_CACHE_SIZE;
+    #ifndef BOARD_HAS_PSRAM
+    if (getFreeHeapSize() < WLED_GIF_CACHE_MIN_HEAP) useCache = false; // decoder is allocated after the cache
+    #endif
+    if (useCache) {
+      frameCache = static_cast<uint32_t*>(allocate_buffer(cacheSize, BFRALLOC_PREFER_PSRAM | BFRALLOC_NOBYTEACCESS));
+      if (frameCache) gifFrames = frames; // if allocation failed, frames are decoded from file every time
+      cacheBlur = seg.intensity;
+    }
+    DEBUG_PRINTF_P(PSTR("GIF frames: %u, cache: %u bytes %s\n"), frames, (unsigned)cacheSize, frameCache ? "allocated" : "not used");
     lastCoordinate = -1;
     decoder.setScreenClearCallback(screenClearCallback);
     decoder.setUpdateScreenCallback(updateScreenCallback);
@@ -197,7 +302,8 @@ byte renderImageToSegment(Segment &seg) {
   }
 
   if (gifDecodeFailed) return IMAGE_ERROR_PREV;
-  if (!file) { gifDecodeFailed = true; return IMAGE_ERROR_FILE_MISSING; }
+  const bool fromCache = gifFrames && cachedFrames == gifFrames;
+  if (!fromCache && !file) { gifDecodeFailed = true; return IMAGE_ERROR_FILE_MISSING; }
   //if (!decoder) { gifDecodeFailed = true; return IMAGE_ERROR_DECODER_ALLOC; }
 
   // speed 0 = half speed, 128 = normal, 255 = full FX FPS
@@ -207,14 +313,28 @@ byte renderImageToSegment(Segment &seg) {
   // TODO consider handling this on FX level with a different frametime, but that would cause slow gifs to speed up during transitions
   if (millis() - lastFrameDisplayTime < wait) return IMAGE_ERROR_WAITING;
 
-  int result = decoder.decodeFrame(false);
-  if (result < 0) {
-    DEBUG_PRINTF_P(PSTR("GIF Decoding error %d in decodeFrame().\n"), result);
-    gifDecodeFailed = true;
-    return IMAGE_ERROR_FRAME_DECODE;
+  if (fromCache) {
+    restoreFrame(replayFrame);
+    replayFrame = (replayFrame + 1) % gifFrames;
+  } else {
+    int result = decoder.decodeFrame(false);
+    if (result < 0) {
+      DEBUG_PRINTF_P(PSTR("GIF Decoding error %d in decodeFrame().\n"), result);
+      gifDecodeFailed = true;
+      return IMAGE_ERROR_FRAME_DECODE;
+    }
+    currentFrameDelay = decoder.getFrameDelay_ms();
+    blurFrame();
+    if (cachedFrames < gifFrames) {
+      storeFrame(cachedFrames++);
+      if (cachedFrames == gifFrames) { // all frames cached, decoder and file are no longer needed
+        decoder.dealloc();
+        file.close();
+        DEBUG_PRINTLN(F("GIF cached, decoder released"));
+      }
+    }
   }
 
-  currentFrameDelay = decoder.getFrameDelay_ms();
   unsigned long tooSlowBy = (millis() - lastFrameDisplayTime) - wait; // if last frame was longer than intended, compensate
   currentFrameDelay = tooSlowBy > currentFrameDelay ? 0 : currentFrameDelay - tooSlowBy;
   lastFrameDisplayTime = millis();
@@ -227,6 +347,7 @@ void endImagePlayback(Segment *seg) {
   if (!activeSeg || activeSeg != seg) return;
   if (file) file.close();
   decoder.dealloc();
+  freeFrameCache();
   gifDecodeFailed = false;
   activeSeg = nullptr;
   strcpy(lastFilename, "/");  // reset filename
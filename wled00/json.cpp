@@ -354,6 +354,7 @@ static bool deserializeSegment(JsonObject elem, byte it, byte presetId = 0)
         iSet = 0;
       }
     }
+    seg.markDirty(); // frozen segment does not run its effect, re-blend manually set pixels
     strip.trigger(); // force segment update
   }
   // send UDP/WS if segment options changed (except selection; will also deselect current preset)
@@ -705,8 +706,12 @@ void serializeInfo(JsonObject root)
   leds[F("count")] = strip.getLengthTotal();
   leds[F("pwr")] = BusManager::currentMilliamps();
   leds["fps"] = strip.getFps();
+  if (realtimeBroadcastTime) leds[F("nettime")] = realtimeBroadcastTime; // us per network bus frame
   leds[F("maxpwr")] = BusManager::currentMilliamps()>0 ? BusManager::ablMilliampsMax() : 0;
   leds[F("maxseg")] = WS2812FX::getMaxSegments();
+  #ifdef WLED_DEBUG
+  leds[F("tralloc")] = Segment::getTransitionAllocations(); // heap allocations for transitions since boot
+  #endif
   //leds[F("actseg")] = strip.getActiveSegmentsNum();
   //leds[F("seglock")] = false; //might be used in the future to prevent modifications to segment config
   leds[F("bootps")] = bootPreset;
@@ -839,6 +844,9 @@ void serializeInfo(JsonObject root)
 #endif
 
   root[F("freeheap")] = getFreeHeapSize();
+  #ifdef WLED_DEBUG
+  root[F("heapfrag")] = 100 - (100 * getContiguousFreeHeap()) / max(getFreeHeapSize(), (size_t)1); // % of free heap not usable for one allocation
+  #endif
   #ifdef ARDUINO_ARCH_ESP32
   // Report PSRAM information
   bool hasPsram = psramFound();
@@ -997,7 +1005,7 @@ void serializePalettes(JsonObject root, int page)
         else if (i < DYNAMIC_PALETTE_COUNT + FASTLED_PALETTE_COUNT) // palette 6 - 12, fastled palettes
           setPaletteColors(curPalette, *fastledPalettes[i - DYNAMIC_PALETTE_COUNT]);
         else {
-          memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[i - (DYNAMIC_PALETTE_COUNT + FASTLED_PALETTE_COUNT)])), sizeof(tcp));
+          memcpy_P(tcp, (const byte*)pgm_read_ptr(&(gGradientPalettes[i - (DYNAMIC_PALETTE_COUNT + FASTLED_PALETTE_COUNT)])), sizeof(tcp));
           setPaletteColors(curPalette, tcp);
         }
         break;
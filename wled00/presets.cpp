@@ -26,6 +26,205 @@ bool presetNeedsSaving() {
   return presetToSave;
 }
 
+/*
+ * Compiled presets: presets.bin keeps presets as MessagePack next to presets.json so handlePresets() can apply them
+ * without holding the JSON buffer lock. A record is decoded into a document of its own (sized when the record was
+ * written) and applied by deserializeState() exactly like a preset read from presets.json.
+ * presets.bin is only written when presets.cpp saves or deletes a preset. Its header holds a hash of presets.json,
+ * if presets.json was changed in any other way (upload, /edit) records are ignored until the next save replaces them.
+ * Playlists, HTTP API calls and API command presets have no record and are loaded from JSON.
+ * File layout: header, then records {id, length, capacity, MessagePack}.
+ */
+#define COMPILED_PRESETS_VERSION 2
+
+typedef struct {
+  char     magic[3];  // "WPB"
+  uint8_t  version;
+  uint32_t jsonHash;  // FNV-1a hash of presets.json
+} CompiledPresetsHeader;
+
+typedef struct {
+  uint8_t  id;
+  uint8_t  reserved;
+  uint16_t length;    // MessagePack size
+  uint16_t capacity;  // JsonDocument capacity needed to decode it
+} CompiledPresetRecord;
+
+static const char presets_bin[] PROGMEM = "/presets.bin";
+static bool compiledPresetsChecked = false; // presets.bin header was compared with presets.json
+static bool compiledPresetsValid = false;   // presets.bin belongs to presets.json
+
+static uint32_t presetsFileHash() {
+  if (doCloseFile) closeFile(); // flush pending writes to presets.json
+  File pf = WLED_FS.open(FPSTR(getPresetsFileName()), "r");
+  if (!pf) return 0;
+  uint32_t hash = 2166136261UL;
+  uint8_t buf[256];
+  size_t len;
+  while ((len = pf.read(buf, sizeof(buf))) > 0) for (size_t i = 0; i < len; i++) hash = (hash ^ buf[i]) * 16777619UL;
+  pf.close();
+  return hash;
+}
+
+// presets.json was replaced: compare hash again before using presets.bin (may be called from web server task)
+void invalidateCompiledPresets() {
+  compiledPresetsChecked = false;
+}
+
+// true if presets.bin belongs to presets.json, must be called before presets.json is modified by a save
+static bool checkCompiledPresets() {
+  if (compiledPresetsChecked) return compiledPresetsValid;
+  compiledPresetsValid = false;
+  if (WLED_FS.exists(FPSTR(presets_bin))) { // avoid error log from open()
+    File cf = WLED_FS.open(FPSTR(presets_bin), "r");
+    CompiledPresetsHeader hdr;
+    if (cf && cf.read(reinterpret_cast<uint8_t*>(&hdr), sizeof(hdr)) == sizeof(hdr) && memcmp_P(hdr.magic, PSTR("WPB"), 3) == 0
+        && hdr.version == COMPILED_PRESETS_VERSION) compiledPresetsValid = hdr.jsonHash == presetsFileHash();
+    if (cf) cf.close();
+  }
+  compiledPresetsChecked = true;
+  return compiledPresetsValid;
+}
+
+// returns MessagePack of preset (free with p_free()) or nullptr if there is none
+static uint8_t *loadCompiledPreset(byte index, size_t &len, size_t &capacity) {
+  if (!checkCompiledPresets()) return nullptr;
+  File cf = WLED_FS.open(FPSTR(presets_bin), "r");
+  if (!cf) return nullptr;
+  uint8_t *data = nullptr;
+  CompiledPresetRecord rec;
+  if (cf.seek(sizeof(CompiledPresetsHeader))) {
+    while (cf.read(reinterpret_cast<uint8_t*>(&rec), sizeof(rec)) == sizeof(rec)) {
+      if (rec.id == index) {
+        data = static_cast<uint8_t*>(p_malloc(rec.length));
+        if (data && cf.read(data, rec.length) != rec.length) {
+          p_free(data);
+          data = nullptr;
+        }
+        len = rec.length;
+        capacity = rec.capacity;
+        break;
+      }
+      if (!cf.seek(rec.length, SeekCur)) break;
+    }
+  }
+  cf.close();
+  return data;
+}
+
+// replaces the record of a preset (removes it if len is 0) and stamps presets.bin with the hash of presets.json,
+// called after presets.json was written (checkCompiledPresets() must have been called before that)
+static void storeCompiledPreset(byte index, const uint8_t *data, size_t len, size_t capacity) {
+  // presets.bin is small (typically a few 100 bytes per preset), rewrite it from RAM
+  uint8_t *old = nullptr;
+  size_t oldLen = 0;
+  if (compiledPresetsValid) {
+    File cf = WLED_FS.open(FPSTR(presets_bin), "r");
+    if (cf && cf.seek(sizeof(CompiledPresetsHeader))) {
+      oldLen = cf.size() - cf.position();
+      old = static_cast<uint8_t*>(p_malloc(oldLen + 1));
+      if (!old || cf.read(old, oldLen) != oldLen) oldLen = 0;
+    }
+    if (cf) cf.close();
+  }
+
+  CompiledPresetsHeader hdr = {{'W','P','B'}, COMPILED_PRESETS_VERSION, presetsFileHash()};
+  File cf = WLED_FS.open(FPSTR(presets_bin), "w");
+  compiledPresetsValid = bool(cf);
+  compiledPresetsChecked = true;
+  if (cf) {
+    cf.write(reinterpret_cast<const uint8_t*>(&hdr), sizeof(hdr));
+    for (size_t pos = 0; pos + sizeof(CompiledPresetRecord) <= oldLen; ) {
+      CompiledPresetRecord rec;
+      memcpy(&rec, old + pos, sizeof(rec));
+      size_t recLen = sizeof(rec) + rec.length;
+      if (pos + recLen > oldLen) break;
+      if (rec.id != index) cf.write(old + pos, recLen);
+      pos += recLen;
+    }
+    if (len) {
+      CompiledPresetRecord rec = {index, 0, uint16_t(len), uint16_t(capacity)};
+      cf.write(reinterpret_cast<const uint8_t*>(&rec), sizeof(rec));
+      cf.write(data, len);
+    }
+    cf.close();
+  }
+  p_free(old);
+}
+
+// writes record of a saved preset (sObj as read back from presets.json), uses pDoc to measure decoded size
+static void compilePreset(byte index, JsonObject sObj) {
+  const bool compiles = !sObj.isNull() && sObj["win"].isNull() && sObj[F("playlist")].isNull() && sObj[F("psave")].isNull() && sObj[F("pdel")].isNull();
+  size_t len = compiles ? measureMsgPack(sObj) : 0;
+  size_t capacity = 0;
+  uint8_t *data = (len && len <= UINT16_MAX) ? static_cast<uint8_t*>(p_malloc(len)) : nullptr;
+  if (data) {
+    serializeMsgPack(sObj, data, len);
+    if (deserializeMsgPack(*pDoc, static_cast<const uint8_t*>(data), len) == DeserializationError::Ok) capacity = pDoc->memoryUsage();
+  }
+  if (capacity && capacity <= UINT16_MAX) storeCompiledPreset(index, data, len, capacity);
+  else                                    storeCompiledPreset(index, nullptr, 0, 0);
+  p_free(data);
+}
+
+// applies preset read from presets.json or presets.bin, returns true if preset changes state
+static bool applyPresetObject(JsonObject fdo, byte tmpPreset, byte tmpMode) {
+  bool changePreset = false;
+  //HTTP API commands
+  const char* httpwin = fdo["win"];
+  if (httpwin) {
+    String apireq = "win"; // reduce flash string usage
+    apireq += F("&IN&"); // internal call
+    apireq += httpwin;
+    handleSet(nullptr, apireq, false); // may call applyPreset() via PL=
+    setValuesFromFirstSelectedSeg(); // fills legacy values
+    changePreset = true;
+  } else {
+    if (!fdo["seg"].isNull() || !fdo["on"].isNull() || !fdo["bri"].isNull() || !fdo["nl"].isNull() || !fdo["ps"].isNull() || !fdo[F("playlist")].isNull()) changePreset = true;
+    if (!(tmpMode == CALL_MODE_BUTTON_PRESET && fdo["ps"].is<const char *>() && strchr(fdo["ps"].as<const char *>(),'~') != strrchr(fdo["ps"].as<const char *>(),'~')))
+      fdo.remove("ps"); // remove load request for presets to prevent recursive crash (if not called by button and contains preset cycling string "1~5~")
+    deserializeState(fdo, CALL_MODE_NO_NOTIFY, tmpPreset); // may change presetToApply by calling applyPreset()
+  }
+  return changePreset;
+}
+
+// applies preset from presets.bin using a document of its own instead of pDoc, false if there is no usable record
+// (the JSON buffer lock is still taken while applying, it serializes state changes with the web server and websocket handlers)
+static bool applyCompiledPreset() {
+  #if defined(ARDUINO_ARCH_ESP32S2) || defined(ARDUINO_ARCH_ESP32C3)
+  unsigned long maxWait = millis() + strip.getFrameTime();
+  while (strip.isUpdating() && millis() < maxWait) delay(1); // wait for strip to finish updating, accessing FS during sendout causes glitches
+  #endif
+
+  size_t len = 0, capacity = 0;
+  uint8_t *data = loadCompiledPreset(presetToApply, len, capacity);
+  if (!data) return false;
+  PSRAMDynamicJsonDocument doc(capacity);
+  const bool decoded = doc.capacity() >= capacity && deserializeMsgPack(doc, static_cast<const uint8_t*>(data), len) == DeserializationError::Ok;
+  p_free(data);
+  if (!decoded) return false; // not enough memory, load JSON instead
+  if (!requestJSONBufferLock(9)) return true; // state is being changed by another task, return to loop and retry
+
+  uint8_t tmpPreset = presetToApply; // store temporary since deserializeState() may call applyPreset()
+  uint8_t tmpMode   = callModeToApply;
+  presetToApply = 0; //clear request for preset
+  callModeToApply = 0;
+
+  DEBUG_PRINTF_P(PSTR("Applying compiled preset: %u\n"), (unsigned)tmpPreset);
+
+  bool changePreset = applyPresetObject(doc.as<JsonObject>(), tmpPreset, tmpMode);
+
+  // only reset errorflag if previous error was preset-related
+  if (errorFlag == ERR_FS_PLOAD) errorFlag = ERR_NONE;
+  if (!errorFlag && changePreset) currentPreset = tmpPreset;
+
+  releaseJSONBufferLock();
+  if (changePreset) notify(tmpMode); // force UDP notification
+  stateUpdated(tmpMode);
+  updateInterfaces(tmpMode);
+  return true;
+}
+
 static void doSaveState() {
   bool persist = (presetToSave < 251);
 
@@ -35,6 +234,7 @@ static void doSaveState() {
   if (!requestJSONBufferLock(10)) return;
 
   initPresetsFile(); // just in case if someone deleted presets.json using /edit
+  if (persist) checkCompiledPresets();
   JsonObject sObj = pDoc->to<JsonObject>();
 
   DEBUG_PRINTLN(F("Serialize current state"));
@@ -70,7 +270,12 @@ static void doSaveState() {
   #endif
   writeObjectToFileUsingId(getPresetsFileName(persist), presetToSave, pDoc);
 
-  if (persist) presetsModifiedTime = toki.second(); //unix time
+  if (persist) {
+    presetsModifiedTime = toki.second(); //unix time
+    // compile what handlePresets() will read (state is serialized with raw "col" strings)
+    if (readObjectFromFileUsingId(getPresetsFileName(), presetToSave, pDoc)) compilePreset(presetToSave, pDoc->as<JsonObject>());
+    else                                                                   compilePreset(presetToSave, JsonObject());
+  }
   releaseJSONBufferLock();
   updateFSInfo();
 
@@ -152,7 +357,9 @@ void handlePresets()
     return;
   }
 
-  if (presetToApply == 0 || !requestJSONBufferLock(9)) return; // no preset waiting to apply, or JSON buffer is already allocated, return to loop until free
+  if (presetToApply == 0) return; // no preset waiting to apply
+  if (presetToApply < 255 && applyCompiledPreset()) return; // does not need pDoc (but takes the JSON buffer lock)
+  if (!requestJSONBufferLock(9)) return; // JSON buffer is already allocated, return to loop until free
 
   bool changePreset = false;
   uint8_t tmpPreset = presetToApply; // store temporary since deserializeState() may call applyPreset()
@@ -183,21 +390,7 @@ void handlePresets()
   // only reset errorflag if previous error was preset-related
   if ((errorFlag == ERR_NONE) || (errorFlag == ERR_FS_PLOAD)) errorFlag = presetErrFlag;
 
-  //HTTP API commands
-  const char* httpwin = fdo["win"];
-  if (httpwin) {
-    String apireq = "win"; // reduce flash string usage
-    apireq += F("&IN&"); // internal call
-    apireq += httpwin;
-    handleSet(nullptr, apireq, false); // may call applyPreset() via PL=
-    setValuesFromFirstSelectedSeg(); // fills legacy values
-    changePreset = true;
-  } else {
-    if (!fdo["seg"].isNull() || !fdo["on"].isNull() || !fdo["bri"].isNull() || !fdo["nl"].isNull() || !fdo["ps"].isNull() || !fdo[F("playlist")].isNull()) changePreset = true;
-    if (!(tmpMode == CALL_MODE_BUTTON_PRESET && fdo["ps"].is<const char *>() && strchr(fdo["ps"].as<const char *>(),'~') != strrchr(fdo["ps"].as<const char *>(),'~')))
-      fdo.remove("ps"); // remove load request for presets to prevent recursive crash (if not called by button and contains preset cycling string "1~5~")
-    deserializeState(fdo, CALL_MODE_NO_NOTIFY, tmpPreset); // may change presetToApply by calling applyPreset()
-  }
+  changePreset = applyPresetObject(fdo, tmpPreset, tmpMode);
   if (!errorFlag && tmpPreset < 255 && changePreset) currentPreset = tmpPreset;
 
   #if defined(ARDUINO_ARCH_ESP32)
@@ -260,8 +453,10 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
         sObj.remove(F("psave"));
         if (sObj["n"].isNull()) sObj["n"] = saveName;
         initPresetsFile(); // just in case if someone deleted presets.json using /edit
+        checkCompiledPresets();
         writeObjectToFileUsingId(getPresetsFileName(), index, pDoc);
         presetsModifiedTime = toki.second(); //unix time
+        storeCompiledPreset(index, nullptr, 0, 0); // API command presets are loaded from JSON
         updateFSInfo();
       }
       p_free(saveName);
@@ -279,7 +474,9 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
 
 void deletePreset(byte index) {
   StaticJsonDocument<24> empty;
+  checkCompiledPresets();
   writeObjectToFileUsingId(getPresetsFileName(), index, &empty);
   presetsModifiedTime = toki.second(); //unix time
+  storeCompiledPreset(index, nullptr, 0, 0);
   updateFSInfo();
 }
\ No newline at end of file
@@ -419,6 +419,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     useMainSegmentOnly = request->hasArg(F("MO"));
     realtimeRespectLedMaps = request->hasArg(F("RLM"));
     e131SkipOutOfSequence = request->hasArg(F("ES"));
+    t = request->arg(F("FT")).toInt();
+    if (t >= 0  && t <= 1000) realtimeFrameTimeout = t;
     e131Multicast = request->hasArg(F("EM"));
     t = request->arg(F("EP")).toInt();
     if (t > 0) e131Port = t;
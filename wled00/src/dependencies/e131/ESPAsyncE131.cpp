@@ -112,6 +112,10 @@ void ESPAsyncE131::parsePacket(AsyncUDPPacket _packet) {
 			error = true; //not "Art-Net"
 		if (sbuff->art_opcode != ARTNET_OPCODE_OPDMX && sbuff->art_opcode != ARTNET_OPCODE_OPPOLL)
 			error = true; //not a DMX or poll packet
+	} else if (htonl(sbuff->root_vector) == ESPAsyncE131::VECTOR_ROOT_EXTENDED) {
+		if (_packet.length() < offsetof(e131_packet_t, sync_reserved) || htonl(sbuff->sync_vector) != ESPAsyncE131::VECTOR_EXTENDED_SYNC)
+			error = true; //only universe synchronization is supported
+		protocol = P_E131_SYNC;
 	} else { //E1.31 error handling
 		if (htonl(sbuff->root_vector) != ESPAsyncE131::VECTOR_ROOT)
 			error = true;
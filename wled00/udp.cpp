@@ -474,6 +474,7 @@ void handleNotifications()
     notify(notificationSentCallMode,true);
   }
 
+  handleRealtimeFrame(); // complete E1.31/Art-Net/DDP frame into strip
   if (e131NewData && millis() - strip.getLastShow() > 15)
   {
     e131NewData = false;
@@ -782,135 +783,200 @@ static       size_t sequenceNumber = 0; // this needs to be shared across all ou
 static const size_t ART_NET_HEADER_SIZE = 12;
 static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
 
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, const uint8_t *buffer, uint8_t bri, bool isRGBW)  {
-  if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
-
-  WiFiUDP ddpUdp;
-
-  switch (type) {
-    case 0: // DDP
-    {
-      // calculate the number of UDP packets we need to send
-      size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B value
-      size_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
-
-      // there are 3 channels per RGB pixel
-      uint32_t channel = 0; // TODO: allow specifying the start channel
-      // the current position in the buffer
-      size_t bufferOffset = 0;
-
-      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
-        if (sequenceNumber > 15) sequenceNumber = 0;
-
-        if (!ddpUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
-          //DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
-          return 1; // problem
-        }
+// E1.31 (sACN) output
+#ifndef WLED_E131_OUT_UNIVERSE
+  #define WLED_E131_OUT_UNIVERSE 1    // first universe sent to each E1.31 output
+#endif
+#ifndef WLED_E131_OUT_PRIORITY
+  #define WLED_E131_OUT_PRIORITY 100  // E1.31 default priority
+#endif
+static const size_t E131_OUT_HEADER_SIZE = E131_DMP_DATA + 1; // including DMX start code
+static const byte   E131_ACN_ID[] PROGMEM = {0x41,0x53,0x43,0x2d,0x45,0x31,0x2e,0x31,0x37,0x00,0x00,0x00};
+
+// preformatted packets for one destination: headers are written once when the output is (re)configured,
+// per frame only sequence numbers and payload change and every packet is sent with a single write()
+struct NetOutput {
+  IPAddress client;
+  uint8_t   type;
+  bool      isRGBW;
+  uint16_t  length;            // pixels
+  size_t    headerSize;
+  size_t    channelsPerPacket;
+  size_t    packetCount;
+  std::unique_ptr<uint8_t[]> packets; // packetCount * (headerSize + channelsPerPacket)
+
+  inline uint8_t *packet(size_t n) const { return packets.get() + n * (headerSize + channelsPerPacket); }
+  inline size_t   payloadSize(size_t n) const {
+    const size_t channelCount = length * (isRGBW?4:3);
+    return (n < packetCount-1 || channelCount % channelsPerPacket == 0) ? channelsPerPacket : channelCount % channelsPerPacket;
+  }
+};
+static std::vector<NetOutput> netOutputs;
+
+static inline void putE131Length(uint8_t *field, size_t len) { field[0] = 0x70 | ((len >> 8) & 0x0F); field[1] = len & 0xFF; } // flags & length
+
+// component identifier (fixed prefix + MAC so it stays the same across reboots) and source name (device name)
+static void putE131Source(uint8_t *h) {
+  uint8_t cid[16] = {'W','L','E','D',0x00,0x00,0x00,0x00,0x00,0x00};
+  for (size_t i = 0; i < 6 && escapedMac.length() >= 12; i++) cid[10+i] = strtoul(escapedMac.substring(2*i, 2*i+2).c_str(), nullptr, 16);
+  memcpy(h + E131_ROOT_CID, cid, sizeof(cid));
+  memset(h + E131_FRAME_SOURCE, 0, 64); // null padded
+  strncpy((char*)h + E131_FRAME_SOURCE, serverDescription, 63);
+}
 
-        // the amount of data is AFTER the header in the current packet
-        size_t packetSize = DDP_CHANNELS_PER_PACKET;
+static void buildE131Header(uint8_t *h, unsigned universe, size_t channels) {
+  const size_t packetLen = E131_OUT_HEADER_SIZE + channels;
+  // root layer
+  h[E131_ROOT_PREAMBLE_SIZE+1] = 0x10;
+  memcpy_P(h + E131_ROOT_ID, E131_ACN_ID, sizeof(E131_ACN_ID));
+  putE131Length(h + E131_ROOT_FLENGTH, packetLen - E131_ROOT_FLENGTH);
+  h[E131_ROOT_VECTOR+3] = 0x04;  // VECTOR_ROOT_E131_DATA
+  // framing layer
+  putE131Length(h + E131_FRAME_FLENGTH, packetLen - E131_FRAME_FLENGTH);
+  h[E131_FRAME_VECTOR+3] = 0x02; // VECTOR_E131_DATA_PACKET
+  putE131Source(h);
+  h[E131_FRAME_PRIORITY] = WLED_E131_OUT_PRIORITY;
+  h[E131_FRAME_UNIVERSE]   = universe >> 8;
+  h[E131_FRAME_UNIVERSE+1] = universe & 0xFF;
+  // DMP layer
+  putE131Length(h + E131_DMP_FLENGTH, packetLen - E131_DMP_FLENGTH);
+  h[E131_DMP_VECTOR] = 0x02;     // VECTOR_DMP_SET_PROPERTY
+  h[E131_DMP_TYPE]   = 0xA1;
+  h[E131_DMP_ADDR_INC+1] = 0x01;
+  h[E131_DMP_COUNT]   = (channels + 1) >> 8; // +1 for start code
+  h[E131_DMP_COUNT+1] = (channels + 1) & 0xFF;
+  // start code (0) at E131_DMP_DATA, sequence number is written per frame
+}
 
-        uint8_t flags = DDP_FLAGS1_VER1;
-        if (currentPacket == (packetCount - 1U)) {
-          // last packet, set the push flag
-          // TODO: determine if we want to send an empty push packet to each destination after sending the pixel data
-          flags = DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH;
-          if (channelCount % DDP_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % DDP_CHANNELS_PER_PACKET;
-          }
-        }
+// returns packet set for destination, (re)builds it if bus configuration changed
+static NetOutput *getNetOutput(uint8_t type, IPAddress client, uint16_t length, bool isRGBW) {
+  NetOutput *o = nullptr;
+  for (auto &out : netOutputs) if (out.client == client && out.type == type) { o = &out; break; }
+  if (o && o->packets && o->length == length && o->isRGBW == isRGBW) return o;
+  if (!o) {
+    netOutputs.push_back({client, type, false, 0, 0, 0, 0, nullptr});
+    o = &netOutputs.back();
+  }
 
-        // write the header
-        /*0*/ddpUdp.write(flags);
-        /*1*/ddpUdp.write(sequenceNumber++ & 0x0F); // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
-        /*2*/ddpUdp.write(isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24);
-        /*3*/ddpUdp.write(DDP_ID_DISPLAY);
+  o->isRGBW = isRGBW;
+  o->length = length;
+  switch (type) {
+    case 0:  o->headerSize = DDP_HEADER_LEN;          o->channelsPerPacket = DDP_CHANNELS_PER_PACKET; break;
+    case 1:  o->headerSize = E131_OUT_HEADER_SIZE;    o->channelsPerPacket = isRGBW?512:510; break; // whole pixels per universe
+    default: o->headerSize = ART_NET_HEADER_SIZE + 6; o->channelsPerPacket = isRGBW?512:510; break; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
+  }
+  const size_t channelCount = length * (isRGBW?4:3);
+  o->packetCount = ((channelCount-1) / o->channelsPerPacket) + 1;
+  o->packets.reset(new (std::nothrow) uint8_t[o->packetCount * (o->headerSize + o->channelsPerPacket)]());
+  if (!o->packets) return nullptr;
+
+  for (size_t n = 0; n < o->packetCount; n++) {
+    uint8_t *h = o->packet(n);
+    const size_t size = o->payloadSize(n);
+    switch (type) {
+      case 0: { // DDP
+        const uint32_t channel = n * o->channelsPerPacket; // TODO: allow specifying the start channel
+        /*0*/h[0] = (n == o->packetCount-1) ? DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH : DDP_FLAGS1_VER1; // push with last packet
+        /*1*/                                             // sequence, set per frame
+        /*2*/h[2] = isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24;
+        /*3*/h[3] = DDP_ID_DISPLAY;
         // data offset in bytes, 32-bit number, MSB first
-        /*4*/ddpUdp.write(0xFF & (channel >> 24));
-        /*5*/ddpUdp.write(0xFF & (channel >> 16));
-        /*6*/ddpUdp.write(0xFF & (channel >>  8));
-        /*7*/ddpUdp.write(0xFF & (channel      ));
+        /*4*/h[4] = 0xFF & (channel >> 24);
+        /*5*/h[5] = 0xFF & (channel >> 16);
+        /*6*/h[6] = 0xFF & (channel >>  8);
+        /*7*/h[7] = 0xFF & (channel      );
         // data length in bytes, 16-bit number, MSB first
-        /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
-        /*9*/ddpUdp.write(0xFF & (packetSize     ));
-
-        // write the colors, the write write(const uint8_t *buffer, size_t size)
-        // function is just a loop internally too
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+        /*8*/h[8] = 0xFF & (size >> 8);
+        /*9*/h[9] = 0xFF & (size     );
+      } break;
+      case 1: // E1.31
+        buildE131Header(h, WLED_E131_OUT_UNIVERSE + n, size);
+        break;
+      default: // Art-Net
+        memcpy_P(h, ART_NET_HEADER, ART_NET_HEADER_SIZE); // Hard coded ID, OpCode, and protocol version.
+        // [12] sequence number, set per frame
+        h[13] = 0x00;             // physical - more an FYI, not really used for anything. 0..3
+        h[14] = n & 0xFF;         // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
+        h[15] = (n >> 8) & 0x7F;  // Universe MSB (net)
+        h[16] = 0xFF & (size >> 8); // 16-bit length of channel data, MSB
+        h[17] = 0xFF & (size     ); // 16-bit length of channel data, LSB
+        break;
+    }
+  }
+  return o;
+}
 
-        if (!ddpUdp.endPacket()) {
-          //DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
-          return 1; // problem
-        }
+// free packet buffers of a removed network bus
+void realtimeBroadcastRelease(uint8_t type, IPAddress client) {
+  for (auto it = netOutputs.begin(); it != netOutputs.end(); ++it) {
+    if (it->client == client && it->type == type) { netOutputs.erase(it); break; }
+  }
+}
 
-        channel += packetSize;
-      }
-    } break;
+// settings were saved: rewrite E1.31 source fields of built packets (per universe sequence numbers are kept)
+void realtimeBroadcastUpdateSource() {
+  for (const auto &out : netOutputs) {
+    if (out.type != 1 || !out.packets) continue;
+    for (size_t n = 0; n < out.packetCount; n++) putE131Source(out.packet(n));
+  }
+}
 
-    case 1: //E1.31
-    {
-    } break;
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, const uint8_t *buffer, uint8_t bri, bool isRGBW)  {
+  if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
+  if (type > 2) return 1;
 
-    case 2: //ArtNet
-    {
-      // calculate the number of UDP packets we need to send
-      const size_t channelCount = length * (isRGBW?4:3); // 1 channel for every R,G,B,(W?) value
-      const size_t ARTNET_CHANNELS_PER_PACKET = isRGBW?512:510; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
-      const size_t packetCount = ((channelCount-1)/ARTNET_CHANNELS_PER_PACKET)+1;
+  NetOutput *out = getNetOutput(type, client, length, isRGBW);
+  if (!out) return 1; // no memory for packet buffers
 
-      uint32_t channel = 0; 
-      size_t bufferOffset = 0;
+  const unsigned long start = micros();
+  WiFiUDP ddpUdp;
+  static const uint16_t ports[] = { DDP_DEFAULT_PORT, E131_DEFAULT_PORT, ARTNET_DEFAULT_PORT }; // ports defined in ESPAsyncE131.h
+  // 239.255.x.x selects E1.31 multicast, each universe goes to its own group address
+  const bool multicast = type == 1 && client[0] == 239 && client[1] == 255;
 
-      sequenceNumber++;
+  if (type == 2) sequenceNumber++; // Art-Net: one sequence number per frame
 
-      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
+  for (size_t currentPacket = 0; currentPacket < out->packetCount; currentPacket++) {
+    uint8_t *packet = out->packet(currentPacket);
+    const size_t packetSize = out->payloadSize(currentPacket);
+    IPAddress dest = client;
 
+    switch (type) {
+      case 0: // DDP
+        if (sequenceNumber > 15) sequenceNumber = 0;
+        packet[1] = sequenceNumber++ & 0x0F; // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
+        break;
+      case 1: { // E1.31
+        packet[E131_FRAME_SEQ]++;          // sequence number is tracked per universe
+        const unsigned universe = WLED_E131_OUT_UNIVERSE + currentPacket;
+        if (multicast) dest = IPAddress(239, 255, universe >> 8, universe & 0xFF);
+      } break;
+      case 2: // Art-Net
         if (sequenceNumber > 255) sequenceNumber = 0;
+        packet[12] = sequenceNumber & 0xFF; // sequence number. 1..255
+        break;
+    }
 
-        if (!ddpUdp.beginPacket(client, ARTNET_DEFAULT_PORT)) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.beginPacket returned an error"));
-          return 1; // borked
-        }
-
-        size_t packetSize = ARTNET_CHANNELS_PER_PACKET;
-
-        if (currentPacket == (packetCount - 1U)) {
-          // last packet
-          if (channelCount % ARTNET_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % ARTNET_CHANNELS_PER_PACKET;
-          }
-        }
-
-        byte header_buffer[ART_NET_HEADER_SIZE];
-        memcpy_P(header_buffer, ART_NET_HEADER, ART_NET_HEADER_SIZE);
-        ddpUdp.write(header_buffer, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
-        ddpUdp.write(sequenceNumber & 0xFF); // sequence number. 1..255
-        ddpUdp.write(0x00); // physical - more an FYI, not really used for anything. 0..3
-        ddpUdp.write((currentPacket) & 0xFF); // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
-        ddpUdp.write(0x00); // Universe MSB, unused.
-        ddpUdp.write(0xFF & (packetSize >> 8)); // 16-bit length of channel data, MSB
-        ddpUdp.write(0xFF & (packetSize     )); // 16-bit length of channel data, LSB
-
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+    // payload: one pass over the channel data (brightness applied on the fly)
+    uint8_t *payload = packet + out->headerSize;
+    const uint8_t *src = buffer + currentPacket * out->channelsPerPacket;
+    if (bri == 255) memcpy(payload, src, packetSize);
+    else for (size_t i = 0; i < packetSize; i++) payload[i] = scale8(src[i], bri);
 
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.endPacket returned an error"));
-          return 1; // borked
-        }
-        channel += packetSize;
-      }
-    } break;
+    if (!ddpUdp.beginPacket(dest, ports[type])) {
+      DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
+      return 1; // problem
+    }
+    ddpUdp.write(packet, out->headerSize + packetSize);
+    if (!ddpUdp.endPacket()) {
+      DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
+      return 1; // problem
+    }
   }
+
+  // moving average (same weighting as FPS calculation)
+  const unsigned long took = micros() - start;
+  realtimeBroadcastTime = (FPS_CALC_AVG * realtimeBroadcastTime + took + FPS_CALC_AVG / 2) / (FPS_CALC_AVG + 1);
   return 0;
 }
 
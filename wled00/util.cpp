@@ -444,6 +444,10 @@ um_data_t* simulateSound(uint8_t simulationId)
   static float    volumeSmth;
   static uint16_t volumeRaw;
   static float    my_magnitude;
+  static uint8_t  geqBands = 16;
+  static uint8_t  onsetStrength;
+  static float    beatBPM;
+  static uint8_t  beatPhase;
 
   //arrays
   uint8_t *fftResult;
@@ -458,7 +462,7 @@ um_data_t* simulateSound(uint8_t simulationId)
     // NOTE!!!
     // This may change as AudioReactive usermod may change
     um_data = new um_data_t;
-    um_data->u_size = 8;
+    um_data->u_size = 13;
     um_data->u_type = new um_types_t[um_data->u_size];
     um_data->u_data = new void*[um_data->u_size];
     um_data->u_data[0] = &volumeSmth;
@@ -469,6 +473,11 @@ um_data_t* simulateSound(uint8_t simulationId)
     um_data->u_data[5] = &my_magnitude;
     um_data->u_data[6] = &maxVol;
     um_data->u_data[7] = &binNum;
+    um_data->u_data[8] = fftResult;   // GEQ bands = the 16 channels
+    um_data->u_data[9] = &geqBands;
+    um_data->u_data[10] = &onsetStrength;
+    um_data->u_data[11] = &beatBPM;
+    um_data->u_data[12] = &beatPhase;
   } else {
     // get arrays from um_data
     fftResult =  (uint8_t*)um_data->u_data[2];
@@ -535,12 +544,15 @@ um_data_t* simulateSound(uint8_t simulationId)
   volumeRaw = volumeSmth;
   my_magnitude = 10000.0f / 8.0f; //no idea if 10000 is a good value for FFT_Magnitude ???
   if (volumeSmth < 1 ) my_magnitude = 0.001f;             // noise gate closed - mute
+  beatBPM       = 120;
+  beatPhase     = (ms * 256 / 500) & 0xFF;                  // 120 BPM = one beat per 500ms
+  onsetStrength = 255 - beatPhase;                          // decays until the next beat
 
   return um_data;
 }
 
 static const char s_ledmap_tmpl[] PROGMEM = "ledmap%d.json";
-// enumerate all ledmapX.json files on FS and extract ledmap names if existing
+// enumerate all ledmapX.json (or ledmapX.bin) files on FS and extract ledmap names if existing
 void enumerateLedmaps() {
   StaticJsonDocument<64> filter;
   filter["n"] = true;
@@ -549,6 +561,11 @@ void enumerateLedmaps() {
     char fileName[33] = "/";
     sprintf_P(fileName+1, s_ledmap_tmpl, i);
     bool isFile = WLED_FS.exists(fileName);
+    bool isBin  = false; // binary ledmap uploaded without its JSON (see deserializeMap()), uses default name
+    if (!isFile) {
+      strcpy_P(strrchr(fileName, '.'), PSTR(".bin"));
+      isBin = WLED_FS.exists(fileName);
+    }
 
     #ifndef ESP8266
     if (ledmapNames[i-1]) { //clear old name
@@ -557,15 +574,15 @@ void enumerateLedmaps() {
     }
     #endif
 
-    if (isFile) {
+    if (isFile || isBin) {
       ledMaps |= 1 << i;
 
       #ifndef ESP8266
       if (requestJSONBufferLock(21)) {
-        if (readObjectFromFile(fileName, nullptr, pDoc, &filter)) {
+        if (isBin || readObjectFromFile(fileName, nullptr, pDoc, &filter)) {
           size_t len = 0;
           JsonObject root = pDoc->as<JsonObject>();
-          if (!root["n"].isNull()) {
+          if (!isBin && !root["n"].isNull()) {
             // name field exists
             const char *name = root["n"].as<const char*>();
             if (name != nullptr) len = strlen(name);
@@ -187,6 +187,13 @@ static String msgProcessor(const String& var)
 }
 
 
+// binary ledmap is converted from ledmapN.json on first load, remove it so a new/deleted JSON takes effect
+static void removeLedmapBin(const String &path) {
+  if (!path.startsWith(F("/ledmap")) || !path.endsWith(F(".json"))) return;
+  String binName = path.substring(0, path.length() - 5) + F(".bin");
+  if (WLED_FS.exists(binName)) WLED_FS.remove(binName);
+}
+
 static void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool isFinal) {
   if (!correctPIN) {
     if (isFinal) request->send(401, FPSTR(CONTENT_TYPE_PLAIN), FPSTR(s_unlock_cfg));
@@ -200,7 +207,11 @@ static void handleUpload(AsyncWebServerRequest *request, const String& filename,
 
     request->_tempFile = WLED_FS.open(finalname, "w");
     DEBUG_PRINTF_P(PSTR("Uploading %s\n"), finalname.c_str());
-    if (finalname.equals(FPSTR(getPresetsFileName()))) presetsModifiedTime = toki.second();
+    if (finalname.equals(FPSTR(getPresetsFileName()))) {
+      presetsModifiedTime = toki.second();
+      invalidateCompiledPresets();
+    }
+    removeLedmapBin(finalname);
   }
   if (len) {
     request->_tempFile.write(data,len);
@@ -300,6 +311,8 @@ void createEditHandler() {
     }
 
     if (func == "delete") {
+      if (path.equals(FPSTR(getPresetsFileName()))) invalidateCompiledPresets();
+      removeLedmapBin(path);
       if (!WLED_FS.remove(path))
         request->send(500, FPSTR(CONTENT_TYPE_PLAIN), F("Delete failed"));
       else
@@ -13,9 +13,251 @@ constexpr uint8_t BINARY_PROTOCOL_DDP     = P_DDP; // = 2
 
 uint16_t wsLiveClientId = 0;
 unsigned long wsLastLiveTime = 0;
-//uint8_t* wsFrameBuffer = nullptr;
+
+/*
+ * Binary messages (DDP/E1.31/Art-Net) that do not fit into a single frame/packet are collected in a reassembly
+ * buffer taken from a small pool, one per client. A buffer is allocated when the first fragment of a client's first
+ * message arrives and kept for its following messages (a streaming client sends one every frame); it is freed when
+ * the client disconnects or another allocation fails. A client without slot takes over the slot of an idle client.
+ * WS_BINARY_MAX_LEN allows a DDP frame of ~5400 RGB pixels (~1300 on ESP8266) in a single message.
+ */
+#ifndef WS_BINARY_SLOTS
+  #ifdef ESP8266
+    #define WS_BINARY_SLOTS 1
+  #else
+    #define WS_BINARY_SLOTS 2
+  #endif
+#endif
+#ifndef WS_BINARY_MAX_LEN
+  #ifdef ESP8266
+    #define WS_BINARY_MAX_LEN 4096
+  #else
+    #define WS_BINARY_MAX_LEN 16384
+  #endif
+#endif
+
+struct WsBinarySlot {
+  uint32_t clientId;  // client the buffer belongs to, 0 = slot is free
+  size_t   size;      // allocated bytes
+  size_t   len;       // bytes received so far
+  uint8_t *data;
+  bool     busy;      // a message is being collected
+};
+static WsBinarySlot wsBinary[WS_BINARY_SLOTS] = {};
 
 #define WS_LIVE_INTERVAL 40
+#ifdef ESP8266
+#define WS_LIVE_MAX_PAYLOAD 1024 // max. bytes of pixel data per live view v3 message
+#else
+#define WS_LIVE_MAX_PAYLOAD 4096
+#endif
+
+/*
+ * Live view protocol version 3: full resolution, optional area of interest, only changed pixels are sent.
+ * Requested by the client with {"lv":{"v":3,"fps":20,"x":0,"y":0,"w":32,"h":16}} (everything but "v" is optional,
+ * "y"/"h" only apply to 2D), {"lv":true} keeps using versions 1 (1D) and 2 (2D).
+ * Message: 'L', 3, flags, area x, y, width, height (uint16 big endian), followed by runs of changed pixels:
+ *          start index within area (uint16 big endian), count (1-255), count * R,G,B
+ * flags bit 0: first message for this area, client must clear its view before applying the runs
+ * A message carries at most WS_LIVE_MAX_PAYLOAD bytes, remaining changes (e.g. of the initial full frame) follow
+ * in the next frame(s) so the bandwidth stays bounded by fps * WS_LIVE_MAX_PAYLOAD.
+ */
+#define WS_LIVE_V3_HEADER 11
+#define WS_LIVE_V3_FIRST  0x01
+
+static struct {
+  uint16_t x, y, w, h;      // requested area
+  uint16_t ax, ay, aw, ah;  // area clamped to strip/matrix at the last message
+  uint16_t interval;        // ms between frames
+  uint16_t resume;          // area index where the next scan for changes starts
+  uint32_t synced;          // area pixels below this index have been sent at least once
+  uint32_t size;            // pixels the buffer below can hold
+  uint8_t *sent;            // R,G,B of every area pixel as last sent to the client, nullptr = version 1/2
+  bool     first;
+} liveView = {0, 0, 0, 0, 0, 0, 0, 0, WS_LIVE_INTERVAL, 0, 0, 0, nullptr, false};
+
+/*
+ * Live view requests arrive on the AsyncTCP task (wsEvent()) while the live view is sent from loop() (handleWs()).
+ * wsEvent() only records the request, handleWs() applies it, so liveView and its buffer are owned by loop().
+ */
+static struct {
+  uint16_t x, y, w, h;
+  uint16_t interval;
+  bool     v3;       // false = release buffer, versions 1/2
+  bool     pending;
+} liveViewRequest = {0, 0, 0, 0, WS_LIVE_INTERVAL, false, false};
+
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE liveViewMux = portMUX_INITIALIZER_UNLOCKED; // AsyncTCP task and loop() run concurrently
+#define LIVE_VIEW_LOCK()   portENTER_CRITICAL(&liveViewMux)
+#define LIVE_VIEW_UNLOCK() portEXIT_CRITICAL(&liveViewMux)
+#else
+#define LIVE_VIEW_LOCK()   // web server callbacks do not interrupt loop() on ESP8266
+#define LIVE_VIEW_UNLOCK()
+#endif
+
+// called by wsEvent(): client will receive version 1/2 messages if version 3 is not requested (lv is null)
+static void requestLiveView(JsonObject lv) {
+  const bool v3 = !lv.isNull() && (lv["v"] | 0) >= 3;
+  const uint16_t interval = v3 ? 1000 / constrain(lv["fps"] | (1000 / WS_LIVE_INTERVAL), 1, 50) : WS_LIVE_INTERVAL;
+  const uint16_t x = v3 ? lv["x"] | 0 : 0;
+  const uint16_t y = v3 ? lv["y"] | 0 : 0;
+  const uint16_t w = v3 ? lv["w"] | 65535 : 0;
+  const uint16_t h = v3 ? lv["h"] | 65535 : 0;
+  LIVE_VIEW_LOCK();
+  liveViewRequest.x = x; liveViewRequest.y = y;
+  liveViewRequest.w = w; liveViewRequest.h = h;
+  liveViewRequest.interval = interval;
+  liveViewRequest.v3 = v3;
+  liveViewRequest.pending = true;
+  LIVE_VIEW_UNLOCK();
+}
+
+static void releaseLiveView() {
+  p_free(liveView.sent);
+  liveView.sent = nullptr;
+  liveView.size = 0;
+  liveView.interval = WS_LIVE_INTERVAL;
+}
+
+// called by handleWs(): applies the last request, version 3 falls back to 1/2 if it cannot be used
+static void setLiveView() {
+  LIVE_VIEW_LOCK();
+  const auto req = liveViewRequest;
+  liveViewRequest.pending = false;
+  LIVE_VIEW_UNLOCK();
+  if (!req.pending) return;
+  releaseLiveView();
+  if (!req.v3) return;
+  liveView.interval = req.interval;
+  liveView.x = req.x;
+  liveView.y = req.y;
+  liveView.w = req.w;
+  liveView.h = req.h;
+  unsigned width = strip.getLengthTotal(), height = 1;
+#ifndef WLED_DISABLE_2D
+  if (strip.isMatrix) { width = Segment::maxWidth; height = Segment::maxHeight; }
+#endif
+  const unsigned w = min((unsigned)liveView.w, width  - min((unsigned)liveView.x, width));
+  const unsigned h = min((unsigned)liveView.h, height - min((unsigned)liveView.y, height));
+  if (w * h == 0) return;
+  liveView.sent = static_cast<uint8_t*>(p_malloc(w * h * 3));
+  if (!liveView.sent) {
+    DEBUG_PRINTLN(F("WS live view: no memory for full resolution."));
+    return;
+  }
+  liveView.size = w * h;
+  liveView.aw   = 0; // force restart with first message
+}
+
+static WsBinarySlot* findBinarySlot(uint32_t clientId) {
+  for (auto &slot : wsBinary) if (slot.clientId == clientId) return &slot;
+  return nullptr;
+}
+
+// slot for the first fragment of a message: own slot, free slot or slot of an idle client (buffer is reused)
+static WsBinarySlot* takeBinarySlot(uint32_t clientId) {
+  WsBinarySlot *slot = findBinarySlot(clientId);
+  if (!slot) slot = findBinarySlot(0);
+  if (!slot) for (auto &s : wsBinary) if (!s.busy) { slot = &s; break; }
+  return slot;
+}
+
+// message complete or dropped, buffer stays with the client
+static inline void endBinaryMessage(WsBinarySlot *slot) {
+  slot->len  = 0;
+  slot->busy = false;
+}
+
+// client disconnected (clientId) or memory is needed (0: buffers of all idle slots)
+static void freeBinarySlots(uint32_t clientId) {
+  for (auto &slot : wsBinary) {
+    if (clientId ? slot.clientId != clientId : slot.busy) continue;
+    p_free(slot.data);
+    slot = {};
+  }
+}
+
+// dispatch a complete binary message, first byte determines protocol
+static void handleBinaryWs(AsyncWebSocketClient * client, uint8_t *data, size_t len)
+{
+  // Note: since e131_packet_t is "packed", the compiler handles alignment issues
+  //DEBUG_PRINTF_P(PSTR("WS binary message: len %u, byte0: %u\n"), len, data[0]);
+  if (len < 2) return;
+  int offset = 1; // offset to skip protocol byte
+  switch (data[0]) {
+    case BINARY_PROTOCOL_E131:
+      handleE131Packet((e131_packet_t*)&data[offset], client->remoteIP(), P_E131);
+      break;
+    case BINARY_PROTOCOL_ARTNET:
+      handleE131Packet((e131_packet_t*)&data[offset], client->remoteIP(), P_ARTNET);
+      break;
+    case BINARY_PROTOCOL_DDP:
+      if (len < 10 + offset) return; // DDP header is 10 bytes (+1 protocol byte)
+      size_t ddpDataLen = (data[8+offset] << 8) | data[9+offset]; // data length in bytes from DDP header
+      uint8_t flags = data[0+offset];
+      if ((flags & DDP_TIMECODE_FLAG) ) ddpDataLen += 4; // timecode flag adds 4 bytes to data length
+      if (len < (10 + offset + ddpDataLen)) return; // not enough data, prevent out of bounds read
+      // could be a valid DDP packet, forward to handler
+      handleE131Packet((e131_packet_t*)&data[offset], client->remoteIP(), P_DDP);
+  }
+}
+
+// collect a fragment of a binary message that is split into several frames or packets
+static void handleBinaryFragmentWs(AsyncWebSocketClient * client, AwsFrameInfo * info, uint8_t *data, size_t len)
+{
+  const uint32_t id = client->id();
+  const bool first = info->num == 0 && info->index == 0;
+  const bool last  = info->final && (info->index + len) == info->len;
+  WsBinarySlot *slot = findBinarySlot(id);
+
+  if (first) {
+    if (slot) endBinaryMessage(slot); // previous message of this client was not completed
+    // a single frame tells its length up front, otherwise reserve the maximum
+    size_t size = info->final ? info->len : WS_BINARY_MAX_LEN;
+    if (size > WS_BINARY_MAX_LEN) {
+      DEBUG_PRINTF_P(PSTR("WS binary message too long (%u).\n"), (unsigned)size);
+      return;
+    }
+    slot = takeBinarySlot(id);
+    if (!slot) {
+      DEBUG_PRINTLN(F("WS binary message: no free reassembly slot."));
+      return;
+    }
+    slot->clientId = id;
+    slot->busy = true; // keeps the slot when idle buffers are released below
+    if (slot->size < size) {
+      p_free(slot->data);
+      slot->data = static_cast<uint8_t*>(p_malloc(size));
+      if (!slot->data) {
+        freeBinarySlots(0);                // release buffers of idle clients and try again
+        slot->data = static_cast<uint8_t*>(p_malloc(size));
+      }
+      slot->size = slot->data ? size : 0;
+    }
+    if (!slot->data) {
+      DEBUG_PRINTLN(F("WS binary message: no memory for reassembly."));
+      *slot = {};
+      return;
+    }
+    slot->len = 0;
+  } else if (!slot || !slot->busy) {
+    return; // start of the message was dropped
+  }
+
+  if (slot->len + len > slot->size) {
+    DEBUG_PRINTLN(F("WS binary message exceeds reassembly buffer, dropped."));
+    endBinaryMessage(slot);
+    return;
+  }
+  memcpy(slot->data + slot->len, data, len);
+  slot->len += len;
+
+  if (last) {
+    handleBinaryWs(client, slot->data, slot->len);
+    endBinaryMessage(slot);
+  }
+}
 
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
@@ -25,12 +267,16 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
     sendDataWs(client);
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
-    if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    if (client->id() == wsLiveClientId) {
+      wsLiveClientId = 0;
+      requestLiveView(JsonObject()); // buffer is released by handleWs()
+    }
+    freeBinarySlots(client->id());
     DEBUG_PRINTLN(F("WS client disconnected."));
   } else if(type == WS_EVT_DATA){
     // data packet
     AwsFrameInfo * info = (AwsFrameInfo*)arg;
-    if(info->final && info->index == 0 && info->len == len){
+    if(info->final && info->num == 0 && info->index == 0 && info->len == len){
       // the whole message is in a single frame and we got all of its data (max. 1428 bytes / ESP8266: 528 bytes)
       if(info->opcode == WS_TEXT)
       {
@@ -57,7 +303,13 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
           //if the received value is just "{"v":true}", send only to this client
           verboseResponse = true;
         } else if (root.containsKey("lv")) {
-          wsLiveClientId = root["lv"] ? client->id() : 0;
+          if (root["lv"].is<JsonObject>()) {
+            requestLiveView(root["lv"].as<JsonObject>());
+            wsLiveClientId = client->id();
+          } else {
+            requestLiveView(JsonObject());
+            wsLiveClientId = root["lv"] ? client->id() : 0;
+          }
         } else {
           verboseResponse = deserializeState(root);
         }
@@ -78,38 +330,13 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
           //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
         }
       }else if (info->opcode == WS_BINARY) {
-        // first byte determines protocol. Note: since e131_packet_t is "packed", the compiler handles alignment issues
-        //DEBUG_PRINTF_P(PSTR("WS binary message: len %u, byte0: %u\n"), len, data[0]);
-        int offset = 1; // offset to skip protocol byte
-        switch (data[0]) {
-          case BINARY_PROTOCOL_E131:
-            handleE131Packet((e131_packet_t*)&data[offset], client->remoteIP(), P_E131);
-            break;
-          case BINARY_PROTOCOL_ARTNET:
-            handleE131Packet((e131_packet_t*)&data[offset], client->remoteIP(), P_ARTNET);
-            break;
-          case BINARY_PROTOCOL_DDP:
-            if (len < 10 + offset) return; // DDP header is 10 bytes (+1 protocol byte)
-            size_t ddpDataLen = (data[8+offset] << 8) | data[9+offset]; // data length in bytes from DDP header
-            uint8_t flags = data[0+offset];
-            if ((flags & DDP_TIMECODE_FLAG) ) ddpDataLen += 4; // timecode flag adds 4 bytes to data length
-            if (len < (10 + offset + ddpDataLen)) return; // not enough data, prevent out of bounds read
-            // could be a valid DDP packet, forward to handler
-            handleE131Packet((e131_packet_t*)&data[offset], client->remoteIP(), P_DDP);
-        }
+        handleBinaryWs(client, data, len);
       }
+    } else if (info->message_opcode == WS_BINARY) {
+      //message is comprised of multiple frames or the frame is split into multiple packets
+      handleBinaryFragmentWs(client, info, data, len);
     } else {
       DEBUG_PRINTF_P(PSTR("WS multipart message: final %u index %u len %u total %u\n"), info->final, info->index, len, (uint32_t)info->len);
-      //message is comprised of multiple frames or the frame is split into multiple packets
-      //if(info->index == 0){
-        //if (!wsFrameBuffer && len < 4096) wsFrameBuffer = new uint8_t[4096];
-      //}
-
-      //if (wsFrameBuffer && len < 4096 && info->index + info->)
-      //{
-
-      //}
-
       if((info->index + len) == info->len){
         if(info->final){
           if(info->message_opcode == WS_TEXT) {
@@ -185,10 +412,93 @@ void sendDataWs(AsyncWebSocketClient * client)
   releaseJSONBufferLock();
 }
 
+static inline void putUint16(uint8_t *buf, unsigned val) {
+  buf[0] = val >> 8;
+  buf[1] = val & 0xFF;
+}
+
+// live view version 3 (see above), returns false if nothing was sent
+static bool sendLiveLedsDeltaWs(AsyncWebSocketClient *wsc)
+{
+  unsigned width = strip.getLengthTotal(), height = 1;
+#ifndef WLED_DISABLE_2D
+  if (strip.isMatrix) { width = Segment::maxWidth; height = Segment::maxHeight; }
+#endif
+  const unsigned ax = min((unsigned)liveView.x, width  - 1);
+  const unsigned ay = min((unsigned)liveView.y, height - 1);
+  const unsigned aw = min((unsigned)liveView.w, width  - ax);
+  const unsigned ah = min((unsigned)liveView.h, height - ay);
+  const unsigned area = aw * ah;
+  if (ax != liveView.ax || ay != liveView.ay || aw != liveView.aw || ah != liveView.ah) {
+    // first frame or strip/matrix size changed: client has to start over
+    if (area > liveView.size) {
+      p_free(liveView.sent);
+      liveView.sent = static_cast<uint8_t*>(p_malloc(area * 3));
+      liveView.size = liveView.sent ? area : 0;
+      if (!liveView.sent) return false; // continues with version 1/2
+    }
+    liveView.ax = ax; liveView.ay = ay; liveView.aw = aw; liveView.ah = ah;
+    liveView.synced = liveView.resume = 0;
+    liveView.first = true;
+  }
+
+  static uint8_t msg[WS_LIVE_V3_HEADER + WS_LIVE_MAX_PAYLOAD];
+  msg[0] = 'L';
+  msg[1] = 3; //version
+  msg[2] = liveView.first ? WS_LIVE_V3_FIRST : 0;
+  putUint16(msg+3, ax);
+  putUint16(msg+5, ay);
+  putUint16(msg+7, aw);
+  putUint16(msg+9, ah);
+  size_t pos = WS_LIVE_V3_HEADER;
+  size_t run = 0; // position of the count byte of the open run, 0 = no open run
+
+  // until the whole area has been sent once every pixel counts as changed, continue where the last message ended
+  const bool syncing = liveView.synced < area;
+  const unsigned start = syncing ? liveView.synced : liveView.resume % area;
+  unsigned scanned = 0;
+  for (; scanned < area; scanned++) {
+    unsigned idx = start + scanned;
+    if (idx >= area) { idx -= area; if (syncing) break; }
+    if (idx == 0) run = 0; // runs do not wrap around
+    const unsigned led = (ay + idx / aw) * width + ax + idx % aw;
+    uint32_t c = strip.getPixelColor(led); // note: LEDs mapped outside of valid range are set to black
+    const uint8_t w = W(c);
+    const uint8_t rgb[3] = { uint8_t(bri ? qadd8(w, R(c)) : 0), uint8_t(bri ? qadd8(w, G(c)) : 0), uint8_t(bri ? qadd8(w, B(c)) : 0) };
+    uint8_t *sent = liveView.sent + idx * 3;
+    if (!syncing && sent[0] == rgb[0] && sent[1] == rgb[1] && sent[2] == rgb[2]) {
+      run = 0;
+      continue;
+    }
+    if (!run || msg[run] == 255) {
+      if (pos + 6 > sizeof(msg)) break; // message full
+      putUint16(msg+pos, idx);
+      run = pos + 2;
+      msg[run] = 0;
+      pos += 3;
+    } else if (pos + 3 > sizeof(msg)) break;
+    msg[run]++;
+    msg[pos++] = sent[0] = rgb[0];
+    msg[pos++] = sent[1] = rgb[1];
+    msg[pos++] = sent[2] = rgb[2];
+  }
+  if (syncing) liveView.synced = start + scanned;
+  else         liveView.resume = (start + scanned) % area;
+
+  if (pos == WS_LIVE_V3_HEADER && !liveView.first) return true; // nothing changed, nothing to send
+  AsyncWebSocketBuffer wsBuf(pos);
+  if (!wsBuf) return false; //out of memory
+  memcpy(wsBuf.data(), msg, pos);
+  wsc->binary(std::move(wsBuf));
+  liveView.first = false;
+  return true;
+}
+
 bool sendLiveLedsWs(uint32_t wsClient)
 {
   AsyncWebSocketClient * wsc = ws.client(wsClient);
   if (!wsc || wsc->queueLength() > 0) return false; //only send if queue free
+  if (liveView.sent) return sendLiveLedsDeltaWs(wsc);
 
   size_t used = strip.getLengthTotal();
 #ifdef ESP8266
@@ -246,7 +556,8 @@ bool sendLiveLedsWs(uint32_t wsClient)
 
 void handleWs()
 {
-  if (millis() - wsLastLiveTime > WS_LIVE_INTERVAL)
+  setLiveView(); // apply live view request of wsEvent() before sending
+  if (millis() - wsLastLiveTime > liveView.interval)
   {
     #ifdef ESP8266
     ws.cleanupClients(3);